@@ -0,0 +1,264 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+
+#include "ai/compact_state.h"
+
+#include <algorithm>
+
+#include "core/bitset.h"
+#include "rendering/sprite_sheet.h"
+#include "world/bandit_system.h"
+#include "world/rules.h"
+#include "world/townhall.h"
+#include "world/turn_rules.h"
+
+namespace konkr {
+
+namespace {
+
+thread_local MoveGenerator move_generator;
+thread_local Bitset region_bits;
+thread_local Bitset reachable_bits;
+thread_local TurnRules turn_rules;
+thread_local std::vector<size_t> townhall_bits;
+thread_local BanditSystem bandit_system;
+
+}  // namespace
+
+class CompactState::Board {
+ public:
+  explicit Board(CompactState& state) : state_(state) {}
+
+  inline const HexGrid& grid() const { return state_.map_->grid; }
+  inline bool is_land(size_t bit) const {
+    return state_.cells_[bit].flags & Cell::kSand;
+  }
+  inline int owner(size_t bit) const { return state_.cells_[bit].owner; }
+  inline Entity::EntityType entity(size_t bit) const {
+    const Cell& cell = state_.cells_[bit];
+    return (cell.flags & Cell::kHasEntity) ? cell.entity
+                                           : Entity::EntityType::Unknown;
+  }
+  inline int upkeep(size_t bit) const { return state_.cells_[bit].upkeep; }
+  inline int money(size_t bit) const { return state_.cells_[bit].money; }
+
+  inline void set_upkeep(size_t bit, int upkeep) {
+    state_.cells_[bit].upkeep = upkeep;
+  }
+  inline void set_money(size_t bit, int money) {
+    state_.SetMoney(state_.cells_[bit], money);
+  }
+  void MakeBandit(size_t bit) {
+    state_.SetEntity(state_.cells_[bit], Entity::EntityType::Bandit);
+  }
+  // The bandits of the thread are described again from the cells, if any
+  std::span<const BanditSystem::Move> MoveBandits(RandomStream& random) {
+    const auto is_bandit = [](const Cell& cell) {
+      return (cell.flags & Cell::kHasEntity) &&
+             cell.entity == Entity::EntityType::Bandit;
+    };
+    if (std::none_of(state_.cells_.begin(), state_.cells_.end(), is_bandit)) {
+      return {};
+    }
+    bandit_system.Reset(grid());
+    for (size_t bit = 0; bit < state_.cells_.size(); ++bit) {
+      if (is_land(bit)) bandit_system.SetTile(bit, owner(bit), entity(bit));
+    }
+    return bandit_system.MoveBandits(random);
+  }
+  // As Level::MoveBandits
+  void MoveEntity(size_t from, size_t to) {
+    Cell& start = state_.cells_[from];
+    Cell& target = state_.cells_[to];
+    target.entity = start.entity;
+    target.level = start.level;
+    target.flags = (target.flags & Cell::kSand) | (start.flags & ~Cell::kSand);
+    target.upkeep = start.upkeep;
+    target.money = start.money;
+    state_.SetEntity(start, Entity::EntityType::Unknown);
+  }
+
+ private:
+  CompactState& state_;
+};
+
+CompactState::CompactState(const Level& level) {
+  const auto& tiles = level.tiles();
+  auto map = std::make_shared<Map>();
+  size_t columns = 0;
+  for (const auto& row : tiles) {
+    columns = std::max(columns, row.size());
+  }
+  map->grid = HexGrid(tiles.size(), columns);
+  cells_.resize(map->grid.bit_count());
+  map->max_townhall_level =
+      SpriteSheet::GetInstance().GetEntitySpriteArraySize(
+          Entity::EntityType::Townhall) -
+      1;
+
+  for (const auto& row : tiles) {
+    for (const auto& tile : row) {
+      if (!tile) continue;
+      Cell& cell = cells_[map->grid.bit(tile->grid_position())];
+      if (Tile::is_sand(tile->type())) {
+        cell.flags |= Cell::kSand;
+        ++map->sand_count;
+      }
+      cell.owner = static_cast<int8_t>(tile->get_owner().value_or(-1));
+      if (const auto& entity = tile->entity()) {
+        cell.flags |= Cell::kHasEntity;
+        if (entity->has_moved()) cell.flags |= Cell::kMoved;
+        cell.entity = entity->type();
+        cell.level = static_cast<int8_t>(entity->level());
+        cell.upkeep = entity->upkeep_cost();
+        if (entity->is_townhall()) {
+          cell.money = std::static_pointer_cast<Townhall>(entity)->money();
+        }
+      }
+    }
+  }
+  map_ = std::move(map);
+
+  for (const auto& [id, player] : level.active_players()) {
+    players_.push_back(static_cast<int8_t>(id));
+  }
+  current_ = level.current_player_index();
+  turn_ = level.turn();
+  bandit_random_ = level.random().stream(RandomStreamId::Bandits);
+}
+
+void CompactState::GenerateMoves(std::vector<Move>& moves) const {
+  moves.push_back(Move::EndTurn());
+  if (is_over()) return;
+
+  const int8_t player = players_[current_];
+  MoveGenerator& generator = move_generator;
+  Bitset& region = region_bits;
+  bool described = false;
+  for (size_t from = 0; from < cells_.size(); ++from) {
+    const Cell& unit = cells_[from];
+    if (unit.owner != player || !is_unit(unit) || (unit.flags & Cell::kMoved)) {
+      continue;
+    }
+    if (!described) {
+      generator.Reset(map_->grid, player);
+      for (size_t i = 0; i < cells_.size(); ++i) {
+        const Cell& cell = cells_[i];
+        if (!(cell.flags & Cell::kSand)) continue;
+        const bool has_entity = cell.flags & Cell::kHasEntity;
+        generator.AddTile(i, cell.owner,
+                          !has_entity || IsFreeEntity(cell.entity),
+                          has_entity ? DefenseOf(cell.entity, cell.level) : 0);
+      }
+      region.Assign(0);
+      described = true;
+    }
+
+    // The units of a region share it
+    if (region.size() == 0 || !region.Test(from)) {
+      generator.FindRegion(from, region);
+    }
+    generator.FindReachable(region, AttackOf(unit.entity, unit.level),
+                            reachable_bits);
+    const auto start = static_cast<uint32_t>(from);
+    reachable_bits.ForEach([&](size_t to) {
+      moves.push_back({start, static_cast<uint32_t>(to)});
+    });
+  }
+}
+
+void CompactState::Apply(Move move) {
+  if (move.is_end_turn()) {
+    NextTurn();
+    return;
+  }
+  // As Level::MoveUnit: whatever was on the target is destroyed
+  Cell unit = cells_[move.from];
+  SetEntity(cells_[move.from], Entity::EntityType::Unknown);
+  unit.flags |= Cell::kMoved;
+  cells_[move.to] = unit;
+}
+
+GameCommand CompactState::ToCommand(Move move) const {
+  if (move.is_end_turn()) return {GameCommand::Type::NextTurn};
+  return {GameCommand::Type::MoveUnit, map_->grid.position(move.from),
+          map_->grid.position(move.to)};
+}
+
+CompactState::Scores CompactState::Score() const {
+  Scores scores = {};
+  if (is_over()) {
+    if (!players_.empty() && is_player_id(players_.front())) {
+      scores[players_.front()] = 1;
+    }
+    return scores;
+  }
+  for (const Cell& cell : cells_) {
+    if (is_player_id(cell.owner) && (cell.flags & Cell::kSand)) {
+      scores[cell.owner] += 1;
+    }
+  }
+  for (float& score : scores) {
+    score /= map_->sand_count;
+  }
+  return scores;
+}
+
+void CompactState::SetEntity(Cell& cell, Entity::EntityType type) {
+  cell.entity = type;
+  cell.flags = (cell.flags & Cell::kSand) | Cell::kHasEntity;
+  cell.level = 0;
+  cell.upkeep = 1;  // As created by CreateEntity
+  cell.money = 0;
+}
+
+void CompactState::SetMoney(Cell& cell, int money) {
+  cell.money = money;
+  if (money >= 10 * cell.level) {
+    if (cell.level < map_->max_townhall_level) ++cell.level;
+  } else if (cell.level > 0) {
+    --cell.level;
+  }
+}
+
+void CompactState::NextTurn() {
+  // As Level::NextTurn
+  Board board(*this);
+  std::vector<size_t>& townhalls = townhall_bits;
+  townhalls.clear();
+  for (size_t bit = 0; bit < cells_.size(); ++bit) {
+    if (board.entity(bit) == Entity::EntityType::Townhall) {
+      townhalls.push_back(bit);
+    }
+  }
+  turn_rules.UpdateUpkeeps(board, townhalls);
+  if (current_ < players_.size()) {
+    turn_rules.CollectIncome(board, players_[current_]);
+  }
+  UpdateActivePlayers();
+  turn_rules.MoveBandits(board, bandit_random_);
+
+  if (!players_.empty()) current_ = (current_ + 1) % players_.size();
+  ++turn_;
+  for (Cell& cell : cells_) {
+    cell.flags &= ~Cell::kMoved;
+  }
+}
+
+void CompactState::UpdateActivePlayers() {
+  std::array<bool, kMaxPlayers> active = {};
+  for (const Cell& cell : cells_) {
+    if (is_player_id(cell.owner)) active[cell.owner] = true;
+  }
+  for (size_t i = 0; i < players_.size();) {
+    if (is_player_id(players_[i]) && active[players_[i]]) {
+      ++i;
+      continue;
+    }
+    if (current_ >= players_.size() - 1 && current_ > 0) --current_;
+    players_.erase(players_.begin() + i);
+  }
+}
+
+}  // namespace konkr
@@ -0,0 +1,152 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+//
+// compact_state.h
+//
+// Declares the CompactState class, a copy of the state of a level small and
+// flat enough to be cloned millions of times by the computer opponents.
+//
+
+#ifndef KONKR_AI_COMPACT_STATE_H
+#define KONKR_AI_COMPACT_STATE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "core/random.h"
+#include "rendering/graphics.h"
+#include "rendering/level.h"
+#include "world/entity.h"
+#include "world/move_generator.h"
+#include "world/rules.h"
+
+namespace konkr {
+
+// The tiles are a flat array of 12-byte cells indexed by the bits of a
+// HexGrid; the map itself (the grid and the tile types) doesn't change during
+// a game, so the clones of a state share it. Cloning a state copies the
+// cells, the players and the stream of the bandits, nothing else.
+//
+// The rules are those of Level, on cells: MoveUnit, and NextTurn, whose
+// upkeeps, incomes and bandit moves are those of TurnRules, the very rules
+// of Level::NextTurn, without the tiles, the observers and the console
+// output. The orphan, reachable and level fields of the tiles, which no rule
+// reads, aren't copied.
+class CompactState {
+ public:
+  static constexpr uint32_t kNone = UINT32_MAX;
+
+  // A unit moving from a cell to another, by bits of the grid, or the end of
+  // the turn. The bits of the largest maps don't fit in 16 bits.
+  struct Move {
+    uint32_t from = kNone;
+    uint32_t to = kNone;
+
+    static constexpr Move EndTurn() { return {}; }
+    constexpr bool is_end_turn() const { return from == kNone; }
+    constexpr bool operator==(const Move&) const = default;
+  };
+
+  // Share of the sand tiles owned by each player, indexed by player id, 1
+  // for the winner of a finished game
+  using Scores = std::array<float, kMaxPlayers>;
+
+  // Whether id indexes the arrays of the players, such as Scores. A player
+  // of another id counts as owning nothing.
+  static constexpr bool is_player_id(int id) {
+    return id >= 0 && static_cast<size_t>(id) < kMaxPlayers;
+  }
+
+  // Copies the state of level, which must be loaded
+  explicit CompactState(const Level& level);
+
+  // Appends the legal moves of the current player to moves: the end of the
+  // turn, then the moves of every unit that didn't move yet (see
+  // Level::CanMoveUnit), found by a MoveGenerator
+  void GenerateMoves(std::vector<Move>& moves) const;
+
+  // Applies a move returned by GenerateMoves
+  void Apply(Move move);
+
+  // Whether move takes a tile the current player doesn't own
+  inline bool is_capture(Move move) const {
+    return !move.is_end_turn() && cells_[move.to].owner != current_player();
+  }
+
+  // Converts a move to the command applying it to the level
+  GameCommand ToCommand(Move move) const;
+
+  // Over when a single player owns tiles
+  inline bool is_over() const { return players_.size() <= 1; }
+  inline int current_player() const { return players_[current_]; }
+  inline size_t player_count() const { return players_.size(); }
+  inline uint32_t turn() const { return turn_; }
+
+  Scores Score() const;
+
+  // Same cells, players, turn and draws of the bandits, the map being the
+  // same
+  bool operator==(const CompactState& other) const {
+    return cells_ == other.cells_ && players_ == other.players_ &&
+           current_ == other.current_ && turn_ == other.turn_ &&
+           bandit_random_.counter() == other.bandit_random_.counter();
+  }
+
+ private:
+  struct Cell {
+    enum Flags : uint8_t {
+      kSand = 1 << 0,
+      kHasEntity = 1 << 1,
+      kMoved = 1 << 2,
+    };
+
+    int8_t owner = -1;
+    Entity::EntityType entity = Entity::EntityType::Unknown;
+    int8_t level = 0;
+    uint8_t flags = 0;
+    int32_t upkeep = 0;  // Of the entity
+    int32_t money = 0;   // Of a townhall
+
+    bool operator==(const Cell&) const = default;
+  };
+
+  // What doesn't change during a game
+  struct Map {
+    HexGrid grid;  // Of the cells
+    int sand_count = 0;
+    int max_townhall_level = 0;
+  };
+
+  // The cells as the board of TurnRules
+  class Board;
+
+  inline bool is_unit(const Cell& cell) const {
+    return (cell.flags & Cell::kHasEntity) &&
+           cell.entity == Entity::EntityType::HumanUnit;
+  }
+
+  void SetEntity(Cell& cell, Entity::EntityType type);
+  // Level::set_money on a townhall
+  void SetMoney(Cell& cell, int money);
+
+  void NextTurn();
+  // Removes the players owning no cell, as Level::UpdateActivePlayers
+  void UpdateActivePlayers();
+
+  std::shared_ptr<const Map> map_;
+  std::vector<Cell> cells_;
+  // Ids of the active players, in the order of their turns
+  std::vector<int8_t> players_;
+  size_t current_ = 0;  // Index in players_
+  uint32_t turn_ = 0;
+  // RandomStreamId::Bandits of the level
+  RandomStream bandit_random_;
+};
+
+}  // namespace konkr
+
+#endif  // KONKR_AI_COMPACT_STATE_H
@@ -0,0 +1,221 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+
+#include "ai/mcts_player.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace konkr {
+
+namespace {
+
+// Iterations between two readings of the clock
+constexpr size_t kClockInterval = 32;
+// Out of 256: chance of a rollout ending the turn while units can move
+constexpr uint32_t kRolloutEndTurnChance = 32;
+
+}  // namespace
+
+MctsPlayer::MctsPlayer(Options options, JobSystem* job_system)
+    : options_(options), job_system_(job_system) {}
+
+GameCommand MctsPlayer::ChooseCommand(const Level& level) {
+  const CompactState state(level);
+  return state.ToCommand(ChooseMove(state));
+}
+
+std::vector<GameCommand> MctsPlayer::ChooseTurn(const Level& level) {
+  const auto turn_deadline =
+      std::chrono::steady_clock::now() + options_.turn_time_budget;
+  CompactState state(level);
+  std::vector<GameCommand> commands;
+  while (true) {
+    const auto now = std::chrono::steady_clock::now();
+    const CompactState::Move move =
+        now < turn_deadline
+            ? ChooseMove(state,
+                         std::min(now + options_.time_budget, turn_deadline))
+            : CompactState::Move::EndTurn();
+    commands.push_back(state.ToCommand(move));
+    if (move.is_end_turn()) return commands;
+    state.Apply(move);
+  }
+}
+
+CompactState::Move MctsPlayer::ChooseMove(const CompactState& state) {
+  return ChooseMove(state,
+                    std::chrono::steady_clock::now() + options_.time_budget);
+}
+
+CompactState::Move MctsPlayer::ChooseMove(
+    const CompactState& state,
+    std::chrono::steady_clock::time_point deadline) {
+  const auto start = std::chrono::steady_clock::now();
+  last_stats_ = {};
+  std::vector<CompactState::Move> moves;
+  state.GenerateMoves(moves);
+  if (moves.size() == 1) return moves.front();  // Nothing to search
+
+  size_t trees = options_.trees;
+  if (trees == 0) trees = job_system_ ? job_system_->worker_count() + 1 : 1;
+  std::vector<RootVisits> results(trees);
+  ++search_count_;
+  const auto search = [&](size_t i) {
+    results[i] = SearchTree(
+        state, RandomStream(options_.seed + search_count_, i), deadline);
+  };
+  if (job_system_) {
+    TaskGroup group(*job_system_);
+    for (size_t i = 1; i < trees; ++i) {
+      group.Run([&search, i] { search(i); });
+    }
+    search(0);
+    group.Wait();
+  } else {
+    for (size_t i = 0; i < trees; ++i) search(i);
+  }
+
+  // Every tree expanded the same root moves, in its own order
+  std::vector<uint64_t> visits(moves.size(), 0);
+  for (const RootVisits& result : results) {
+    for (size_t i = 0; i < result.moves.size(); ++i) {
+      for (size_t j = 0; j < moves.size(); ++j) {
+        if (moves[j] == result.moves[i]) {
+          visits[j] += result.visits[i];
+          break;
+        }
+      }
+    }
+    last_stats_.iterations += result.iterations;
+    last_stats_.rollout_moves += result.rollout_moves;
+  }
+  last_stats_.trees = trees;
+  last_stats_.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start);
+
+  size_t best = 0;
+  for (size_t j = 1; j < moves.size(); ++j) {
+    if (visits[j] > visits[best]) best = j;
+  }
+  return moves[best];
+}
+
+MctsPlayer::RootVisits MctsPlayer::SearchTree(
+    const CompactState& root, RandomStream random,
+    std::chrono::steady_clock::time_point deadline) const {
+  std::vector<Node> nodes(1);
+  std::vector<uint32_t> path;
+  std::vector<CompactState::Move> moves;
+  RootVisits result;
+
+  while (options_.max_iterations == 0 ||
+         result.iterations < options_.max_iterations) {
+    if (result.iterations % kClockInterval == 0 &&
+        std::chrono::steady_clock::now() >= deadline) {
+      break;
+    }
+    ++result.iterations;
+
+    // Selection
+    CompactState state = root;
+    uint32_t node = 0;
+    path.assign(1, 0);
+    while (nodes[node].expanded && nodes[node].child_count > 0 &&
+           !state.is_over()) {
+      node = SelectChild(nodes, nodes[node]);
+      state.Apply(nodes[node].move);
+      path.push_back(node);
+    }
+
+    // Expansion, the children in random order so that the unvisited ones are
+    // tried at random
+    if (!nodes[node].expanded && !state.is_over()) {
+      moves.clear();
+      state.GenerateMoves(moves);
+      if (nodes.size() + moves.size() <= options_.max_nodes) {
+        for (size_t i = moves.size(); i > 1; --i) {
+          std::swap(moves[i - 1], moves[random.NextBelow(i)]);
+        }
+        const auto first_child = static_cast<uint32_t>(nodes.size());
+        const auto mover = static_cast<int8_t>(state.current_player());
+        for (const auto& move : moves) {
+          nodes.push_back({.move = move, .mover = mover});
+        }
+        nodes[node].first_child = first_child;
+        nodes[node].child_count = static_cast<uint32_t>(moves.size());
+        nodes[node].expanded = true;
+
+        node = first_child;
+        state.Apply(nodes[node].move);
+        path.push_back(node);
+      }
+    }
+
+    // Simulation and backpropagation
+    result.rollout_moves += Rollout(state, random, moves);
+    const CompactState::Scores scores = state.Score();
+    for (uint32_t visited : path) {
+      Node& n = nodes[visited];
+      ++n.visits;
+      if (CompactState::is_player_id(n.mover)) {
+        n.value += scores[n.mover];
+      }
+    }
+  }
+
+  const Node& root_node = nodes[0];
+  for (uint32_t i = 0; i < root_node.child_count; ++i) {
+    const Node& child = nodes[root_node.first_child + i];
+    result.moves.push_back(child.move);
+    result.visits.push_back(child.visits);
+  }
+  return result;
+}
+
+uint32_t MctsPlayer::SelectChild(const std::vector<Node>& nodes,
+                                 const Node& parent) const {
+  const float log_visits = std::log(static_cast<float>(parent.visits));
+  uint32_t best = parent.first_child;
+  float best_score = -std::numeric_limits<float>::infinity();
+  for (uint32_t i = 0; i < parent.child_count; ++i) {
+    const uint32_t index = parent.first_child + i;
+    const Node& child = nodes[index];
+    if (child.visits == 0) return index;
+    const float visits = static_cast<float>(child.visits);
+    const float score = child.value / visits +
+                        options_.exploration * std::sqrt(log_visits / visits);
+    if (score > best_score) {
+      best_score = score;
+      best = index;
+    }
+  }
+  return best;
+}
+
+size_t MctsPlayer::Rollout(CompactState& state, RandomStream& random,
+                           std::vector<CompactState::Move>& moves) const {
+  size_t played = 0;
+  const uint32_t last_turn = state.turn() + options_.rollout_turns;
+  while (state.turn() < last_turn && !state.is_over()) {
+    moves.clear();
+    state.GenerateMoves(moves);
+    CompactState::Move move = moves.front();  // End of the turn
+    if (moves.size() > 1 && random.NextBelow(256) >= kRolloutEndTurnChance) {
+      // Captures gain tiles, so a move that isn't one is drawn again once
+      const auto draw = [&] {
+        return moves[1 + random.NextBelow(moves.size() - 1)];
+      };
+      move = draw();
+      if (!state.is_capture(move)) move = draw();
+    }
+    state.Apply(move);
+    ++played;
+  }
+  return played;
+}
+
+}  // namespace konkr
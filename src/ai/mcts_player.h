@@ -0,0 +1,124 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+//
+// mcts_player.h
+//
+// Declares the MctsPlayer class, a computer opponent searching its moves with
+// Monte Carlo Tree Search on all cores.
+//
+
+#ifndef KONKR_AI_MCTS_PLAYER_H
+#define KONKR_AI_MCTS_PLAYER_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "ai/compact_state.h"
+#include "core/job_system.h"
+#include "core/random.h"
+#include "rendering/computer_player.h"
+
+namespace konkr {
+
+// Plays one move at a time: each call grows a search tree from the current
+// state for the time budget, then plays the move of the root visited most. A
+// whole turn shares the turn time budget, each move being searched for the
+// time budget at most.
+// An iteration walks down the tree choosing children by UCT (the player to
+// move picks the child with the best score for itself), adds the children of
+// the leaf it reaches, plays random moves from there for a few turns and
+// scores the result by the share of the map each player owns.
+//
+// The search uses root parallelism: every thread of the JobSystem grows its
+// own tree from the same root with its own random stream, with no shared
+// state, and the visits of the root moves are summed at the end. Without a
+// JobSystem, the trees are grown one after the other on the calling thread.
+class MctsPlayer : public ComputerPlayer {
+ public:
+  struct Options {
+    // Of each move
+    std::chrono::milliseconds time_budget{200};
+    // Of all the moves of a turn (see ChooseTurn)
+    std::chrono::milliseconds turn_time_budget{2000};
+    // Iterations of each tree, 0 for as many as the time budget allows
+    size_t max_iterations = 0;
+    // Turns played at random from a new leaf before scoring it
+    uint32_t rollout_turns = 4;
+    // Weight of the exploration term of UCT
+    float exploration = 0.7f;
+    // Nodes of each tree, past which the leaves aren't expanded anymore
+    size_t max_nodes = 1 << 18;
+    // Trees searched, 0 for one per thread of the JobSystem (one without)
+    size_t trees = 0;
+    uint64_t seed = 0;
+  };
+
+  // Totals of the last search
+  struct Stats {
+    size_t trees = 0;
+    size_t iterations = 0;
+    size_t rollout_moves = 0;
+    std::chrono::microseconds elapsed{0};
+  };
+
+  // job_system may be nullptr, to search on the calling thread only
+  explicit MctsPlayer(Options options,
+                      JobSystem* job_system = &JobSystem::GetInstance());
+
+  GameCommand ChooseCommand(const Level& level) override;
+
+  // Searches the moves of the whole turn one after the other on a copy of
+  // the state, so the level only changes once the turn is chosen. The turn
+  // ends once the turn time budget is spent, whatever moves are left.
+  std::vector<GameCommand> ChooseTurn(const Level& level) override;
+
+  // Searches the best move of the current player of state
+  CompactState::Move ChooseMove(const CompactState& state);
+  // Same, searching until deadline at the latest
+  CompactState::Move ChooseMove(
+      const CompactState& state,
+      std::chrono::steady_clock::time_point deadline);
+
+  inline const Stats& last_stats() const { return last_stats_; }
+
+ private:
+  struct Node {
+    CompactState::Move move;
+    uint32_t first_child = 0;
+    uint32_t child_count = 0;
+    bool expanded = false;
+    int8_t mover = -1;  // Player who played move
+    uint32_t visits = 0;
+    float value = 0;  // Sum of the scores of mover
+  };
+
+  // Visits of each move of the root of a tree
+  struct RootVisits {
+    std::vector<CompactState::Move> moves;
+    std::vector<uint32_t> visits;
+    size_t iterations = 0;
+    size_t rollout_moves = 0;
+  };
+
+  RootVisits SearchTree(const CompactState& root, RandomStream random,
+                        std::chrono::steady_clock::time_point deadline) const;
+  uint32_t SelectChild(const std::vector<Node>& nodes,
+                       const Node& parent) const;
+  // Plays random moves from state for options_.rollout_turns turns, returns
+  // the number of moves played
+  size_t Rollout(CompactState& state, RandomStream& random,
+                 std::vector<CompactState::Move>& moves) const;
+
+  Options options_;
+  JobSystem* job_system_;
+  // Changes the random streams of every search
+  uint64_t search_count_ = 0;
+  Stats last_stats_;
+};
+
+}  // namespace konkr
+
+#endif  // KONKR_AI_MCTS_PLAYER_H
@@ -0,0 +1,100 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+//
+// bitset.h
+//
+// Declares the Bitset class, a set of indices stored as bits whose size is
+// chosen at run time.
+//
+
+#ifndef KONKR_CORE_BITSET_H
+#define KONKR_CORE_BITSET_H
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace konkr {
+
+// Set of the indices below size(), 64 to a word, so that set operations on a
+// whole map only take a few word operations. The words past size() stay
+// zero: callers writing words() directly must keep them so.
+class Bitset {
+ public:
+  static constexpr size_t kWordBits = 64;
+
+  Bitset() = default;
+  explicit Bitset(size_t size)
+      : size_(size), words_((size + kWordBits - 1) / kWordBits, 0) {}
+
+  inline size_t size() const { return size_; }
+  inline std::span<uint64_t> words() { return words_; }
+  inline std::span<const uint64_t> words() const { return words_; }
+
+  // Empties the set and sets its size, keeping the memory it already has
+  void Assign(size_t size) {
+    size_ = size;
+    words_.assign((size + kWordBits - 1) / kWordBits, 0);
+  }
+
+  inline bool Test(size_t index) const {
+    return (words_[index / kWordBits] >> (index % kWordBits)) & 1;
+  }
+  inline void Set(size_t index) {
+    words_[index / kWordBits] |= uint64_t{1} << (index % kWordBits);
+  }
+  inline void Reset(size_t index) {
+    words_[index / kWordBits] &= ~(uint64_t{1} << (index % kWordBits));
+  }
+  inline void Clear() { std::fill(words_.begin(), words_.end(), 0); }
+
+  bool Any() const {
+    return std::any_of(words_.begin(), words_.end(),
+                       [](uint64_t word) { return word != 0; });
+  }
+
+  size_t Count() const {
+    size_t count = 0;
+    for (uint64_t word : words_) count += std::popcount(word);
+    return count;
+  }
+
+  // The operations on two sets require sets of the same size
+  Bitset& operator|=(const Bitset& other) {
+    for (size_t i = 0; i < words_.size(); ++i) words_[i] |= other.words_[i];
+    return *this;
+  }
+  Bitset& operator&=(const Bitset& other) {
+    for (size_t i = 0; i < words_.size(); ++i) words_[i] &= other.words_[i];
+    return *this;
+  }
+  // Removes the indices of other
+  Bitset& Subtract(const Bitset& other) {
+    for (size_t i = 0; i < words_.size(); ++i) words_[i] &= ~other.words_[i];
+    return *this;
+  }
+
+  bool operator==(const Bitset& other) const = default;
+
+  // Calls function with every index of the set, in increasing order
+  template <typename Function>
+  void ForEach(Function&& function) const {
+    for (size_t i = 0; i < words_.size(); ++i) {
+      for (uint64_t word = words_[i]; word != 0; word &= word - 1) {
+        function(i * kWordBits + std::countr_zero(word));
+      }
+    }
+  }
+
+ private:
+  size_t size_ = 0;
+  std::vector<uint64_t> words_;
+};
+
+}  // namespace konkr
+
+#endif  // KONKR_CORE_BITSET_H
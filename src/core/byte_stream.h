@@ -0,0 +1,169 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+//
+// byte_stream.h
+//
+// Declares the ByteWriter and ByteReader classes, which write and read the
+// compact binary formats of the game: bytes, variable-length integers and
+// strings.
+//
+
+#ifndef KONKR_CORE_BYTE_STREAM_H
+#define KONKR_CORE_BYTE_STREAM_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace konkr {
+
+// Appends to a byte vector. Integers are written as varints: 7 bits per
+// byte, low bits first, the high bit set on every byte but the last, so small
+// values (tile coordinates, levels) take a single byte.
+//
+// A writer can also stream: given a block size and a flush function, it hands
+// every block_size bytes written to flush and reuses the vector, so large
+// outputs are never held in memory at once.
+class ByteWriter {
+ public:
+  // Receives a full block (or the last, partial one), returns false on error
+  using FlushFunction = std::function<bool(const uint8_t* data, size_t size)>;
+
+  explicit ByteWriter(std::vector<uint8_t>& bytes) : bytes_(bytes) {}
+  ByteWriter(std::vector<uint8_t>& buffer, size_t block_size,
+             FlushFunction flush)
+      : bytes_(buffer), block_size_(block_size), flush_(std::move(flush)) {
+    bytes_.reserve(block_size_ + kMaxVarintSize);
+  }
+
+  // Bytes written and not flushed yet
+  inline size_t size() const { return bytes_.size(); }
+
+  inline void WriteByte(uint8_t value) {
+    bytes_.push_back(value);
+    FlushFullBlocks();
+  }
+
+  inline void WriteBytes(const uint8_t* data, size_t size) {
+    bytes_.insert(bytes_.end(), data, data + size);
+    FlushFullBlocks();
+  }
+
+  inline void WriteVarint(uint64_t value) {
+    while (value >= 0x80) {
+      bytes_.push_back(static_cast<uint8_t>(value) | 0x80);
+      value >>= 7;
+    }
+    bytes_.push_back(static_cast<uint8_t>(value));
+    FlushFullBlocks();
+  }
+
+  // Zigzag encoded, so small negative values are small too
+  inline void WriteSignedVarint(int64_t value) {
+    WriteVarint((static_cast<uint64_t>(value) << 1) ^
+                static_cast<uint64_t>(value >> 63));
+  }
+
+  inline void WriteString(const std::string& value) {
+    WriteVarint(value.size());
+    WriteBytes(reinterpret_cast<const uint8_t*>(value.data()), value.size());
+  }
+
+  // Streaming writers: flushes the last bytes. Returns false if any flush
+  // failed.
+  inline bool Flush() {
+    if (flush_ && !bytes_.empty()) {
+      ok_ = flush_(bytes_.data(), bytes_.size()) && ok_;
+      bytes_.clear();
+    }
+    return ok_;
+  }
+
+ private:
+  static constexpr size_t kMaxVarintSize = 10;
+
+  inline void FlushFullBlocks() {
+    if (!flush_ || bytes_.size() < block_size_) return;
+    size_t flushed = 0;
+    while (bytes_.size() - flushed >= block_size_) {
+      ok_ = flush_(bytes_.data() + flushed, block_size_) && ok_;
+      flushed += block_size_;
+    }
+    bytes_.erase(bytes_.begin(), bytes_.begin() + flushed);
+  }
+
+  std::vector<uint8_t>& bytes_;
+  size_t block_size_ = 0;
+  FlushFunction flush_;
+  bool ok_ = true;
+};
+
+// Reads what ByteWriter writes. The Read methods return false, leaving the
+// value unchanged, if the data ends or is malformed.
+class ByteReader {
+ public:
+  ByteReader(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+  explicit ByteReader(const std::vector<uint8_t>& bytes)
+      : ByteReader(bytes.data(), bytes.size()) {}
+
+  inline size_t position() const { return position_; }
+  inline void set_position(size_t position) { position_ = position; }
+  inline bool at_end() const { return position_ >= size_; }
+
+  inline bool ReadByte(uint8_t& value) {
+    if (position_ >= size_) return false;
+    value = data_[position_++];
+    return true;
+  }
+
+  inline bool ReadBytes(uint8_t* data, size_t size) {
+    if (size > size_ - position_) return false;
+    std::copy(data_ + position_, data_ + position_ + size, data);
+    position_ += size;
+    return true;
+  }
+
+  inline bool ReadVarint(uint64_t& value) {
+    uint64_t result = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      if (position_ >= size_) return false;
+      const uint8_t byte = data_[position_++];
+      result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if (!(byte & 0x80)) {
+        value = result;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  inline bool ReadSignedVarint(int64_t& value) {
+    uint64_t zigzag;
+    if (!ReadVarint(zigzag)) return false;
+    value = static_cast<int64_t>(zigzag >> 1) ^
+            -static_cast<int64_t>(zigzag & 1);
+    return true;
+  }
+
+  inline bool ReadString(std::string& value) {
+    uint64_t size;
+    if (!ReadVarint(size) || size > size_ - position_) return false;
+    value.assign(reinterpret_cast<const char*>(data_ + position_), size);
+    position_ += size;
+    return true;
+  }
+
+ private:
+  const uint8_t* data_;
+  size_t size_;
+  size_t position_ = 0;
+};
+
+}  // namespace konkr
+
+#endif  // KONKR_CORE_BYTE_STREAM_H
@@ -0,0 +1,157 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+
+#include "core/compression.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace konkr {
+
+namespace {
+
+constexpr size_t kMinMatch = 4;
+constexpr int kHashBits = 12;
+// Length nibble meaning that more length bytes follow
+constexpr uint8_t kExtendedLength = 15;
+
+uint32_t Read32(const uint8_t* data) {
+  uint32_t value;
+  std::memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+uint32_t Hash(uint32_t sequence) {
+  return (sequence * 2654435761u) >> (32 - kHashBits);
+}
+
+// Lengths of 15 and more: the nibble is 15, then bytes of 255 and a last
+// byte below 255 add up to the rest
+void WriteExtendedLength(size_t length, std::vector<uint8_t>& out) {
+  length -= kExtendedLength;
+  while (length >= 255) {
+    out.push_back(255);
+    length -= 255;
+  }
+  out.push_back(static_cast<uint8_t>(length));
+}
+
+bool ReadExtendedLength(const uint8_t* data, size_t size, size_t& in,
+                        size_t& length) {
+  uint8_t byte;
+  do {
+    if (in >= size) return false;
+    byte = data[in++];
+    length += byte;
+  } while (byte == 255);
+  return true;
+}
+
+void WriteSequence(const uint8_t* literals, size_t literal_length,
+                   size_t offset, size_t match_length,
+                   std::vector<uint8_t>& out) {
+  const size_t match_code = match_length ? match_length - kMinMatch : 0;
+  const uint8_t token =
+      static_cast<uint8_t>(
+          std::min<size_t>(literal_length, kExtendedLength) << 4) |
+      static_cast<uint8_t>(std::min<size_t>(match_code, kExtendedLength));
+  out.push_back(token);
+  if (literal_length >= kExtendedLength) {
+    WriteExtendedLength(literal_length, out);
+  }
+  out.insert(out.end(), literals, literals + literal_length);
+  if (match_length == 0) return;  // Last sequence
+
+  out.push_back(static_cast<uint8_t>(offset));
+  out.push_back(static_cast<uint8_t>(offset >> 8));
+  if (match_code >= kExtendedLength) {
+    WriteExtendedLength(match_code, out);
+  }
+}
+
+}  // namespace
+
+bool CompressBlock(const uint8_t* data, size_t size,
+                   std::vector<uint8_t>& out) {
+  if (size > kMaxCompressionBlockSize) return false;
+  const size_t out_start = out.size();
+
+  // Position + 1 of the last sequence of 4 bytes with each hash, 0 if none
+  std::array<uint32_t, 1 << kHashBits> table = {};
+  size_t anchor = 0;
+  size_t i = 0;
+  while (i + kMinMatch <= size) {
+    const uint32_t sequence = Read32(data + i);
+    uint32_t& entry = table[Hash(sequence)];
+    const size_t candidate = entry;
+    entry = static_cast<uint32_t>(i + 1);
+    if (candidate == 0 || Read32(data + candidate - 1) != sequence) {
+      ++i;
+      continue;
+    }
+
+    const size_t match = candidate - 1;
+    size_t length = kMinMatch;
+    while (i + length < size && data[match + length] == data[i + length]) {
+      ++length;
+    }
+    WriteSequence(data + anchor, i - anchor, i - match, length, out);
+    i += length;
+    anchor = i;
+  }
+  WriteSequence(data + anchor, size - anchor, 0, 0, out);
+
+  if (out.size() - out_start >= size) {
+    out.resize(out_start);
+    return false;
+  }
+  return true;
+}
+
+bool DecompressBlock(const uint8_t* data, size_t size, size_t raw_size,
+                     std::vector<uint8_t>& out) {
+  const size_t out_start = out.size();
+  const size_t out_end = out_start + raw_size;
+  out.reserve(out_end);
+
+  size_t in = 0;
+  while (in < size) {
+    const uint8_t token = data[in++];
+    size_t literal_length = token >> 4;
+    if (literal_length == kExtendedLength &&
+        !ReadExtendedLength(data, size, in, literal_length)) {
+      return false;
+    }
+    if (literal_length > size - in ||
+        literal_length > out_end - out.size()) {
+      return false;
+    }
+    out.insert(out.end(), data + in, data + in + literal_length);
+    in += literal_length;
+    if (in == size) break;  // The last sequence has no match
+
+    if (size - in < 2) return false;
+    const size_t offset = data[in] | static_cast<size_t>(data[in + 1]) << 8;
+    in += 2;
+    size_t match_length = token & 0x0f;
+    if (match_length == kExtendedLength &&
+        !ReadExtendedLength(data, size, in, match_length)) {
+      return false;
+    }
+    match_length += kMinMatch;
+    if (offset == 0 || offset > out.size() - out_start ||
+        match_length > out_end - out.size()) {
+      return false;
+    }
+    // Byte by byte, as the match may overlap the bytes it produces
+    size_t from = out.size() - offset;
+    for (size_t j = 0; j < match_length; ++j) {
+      out.push_back(out[from++]);
+    }
+  }
+  return out.size() == out_end;
+}
+
+}  // namespace konkr
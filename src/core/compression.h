@@ -0,0 +1,36 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+//
+// compression.h
+//
+// Declares the functions compressing and decompressing blocks of bytes with
+// a small LZ77 codec, fast enough to run on every autosave.
+//
+
+#ifndef KONKR_CORE_COMPRESSION_H
+#define KONKR_CORE_COMPRESSION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace konkr {
+
+// Largest block CompressBlock accepts: matches are at most this far back
+constexpr size_t kMaxCompressionBlockSize = 64 * 1024;
+
+// Appends the compressed size bytes of data to out. A block is a sequence of
+// literal runs each followed by a match (a copy of at least 4 earlier bytes)
+// except the last, in the manner of LZ4. Returns false, appending nothing, if
+// size is too large or the data doesn't compress.
+bool CompressBlock(const uint8_t* data, size_t size, std::vector<uint8_t>& out);
+
+// Appends the raw_size bytes decompressed from a block written by
+// CompressBlock to out. Returns false if the block is malformed.
+bool DecompressBlock(const uint8_t* data, size_t size, size_t raw_size,
+                     std::vector<uint8_t>& out);
+
+}  // namespace konkr
+
+#endif  // KONKR_CORE_COMPRESSION_H
@@ -0,0 +1,123 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+
+#include "core/job_system.h"
+
+namespace konkr {
+
+namespace {
+
+// The job system the current thread is a worker of, and its index there
+thread_local const JobSystem* current_job_system = nullptr;
+thread_local size_t current_worker_index = 0;
+
+}  // namespace
+
+size_t JobSystem::DefaultWorkerCount() {
+  const unsigned cores = std::thread::hardware_concurrency();
+  return cores > 1 ? cores - 1 : 1;
+}
+
+JobSystem::JobSystem(size_t worker_count) {
+  worker_count = std::max<size_t>(worker_count, 1);
+  workers_.reserve(worker_count);
+  for (size_t i = 0; i < worker_count; ++i) {
+    workers_.push_back(std::make_unique<Worker>());
+  }
+  // Started once every deque exists, as workers steal from each other
+  for (size_t i = 0; i < worker_count; ++i) {
+    workers_[i]->thread = std::thread([this, i] { Run(i); });
+  }
+}
+
+JobSystem::~JobSystem() {
+  stop_.store(true, std::memory_order_release);
+  wake_count_.fetch_add(1, std::memory_order_release);
+  wake_count_.notify_all();
+  for (auto& worker : workers_) {
+    worker->thread.join();
+  }
+}
+
+void JobSystem::Submit(Job job) {
+  size_t index;
+  if (current_job_system == this) {
+    index = current_worker_index;
+  } else {
+    index = next_worker_.fetch_add(1, std::memory_order_relaxed) %
+            workers_.size();
+  }
+  {
+    Worker& worker = *workers_[index];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    worker.jobs.push_back(std::move(job));
+  }
+  wake_count_.fetch_add(1, std::memory_order_release);
+  wake_count_.notify_one();
+}
+
+bool JobSystem::RunPendingJob() {
+  const size_t index = current_job_system == this ? current_worker_index
+                                                  : workers_.size();
+  Job job;
+  if (!TakeJob(index, job)) return false;
+  job();
+  return true;
+}
+
+bool JobSystem::TakeJob(size_t index, Job& job) {
+  if (index < workers_.size()) {
+    Worker& own = *workers_[index];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    if (!own.jobs.empty()) {
+      job = std::move(own.jobs.back());
+      own.jobs.pop_back();
+      return true;
+    }
+  }
+  // Starts with the next worker, so thieves don't all go for the first one
+  for (size_t i = 1; i <= workers_.size(); ++i) {
+    Worker& victim = *workers_[(index + i) % workers_.size()];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.jobs.empty()) {
+      job = std::move(victim.jobs.front());
+      victim.jobs.pop_front();
+      return true;
+    }
+  }
+  return false;
+}
+
+void JobSystem::Run(size_t index) {
+  current_job_system = this;
+  current_worker_index = index;
+  while (true) {
+    // Read before looking for jobs: a job submitted after the search changes
+    // it, so the wait below returns immediately
+    const uint32_t wake_count = wake_count_.load(std::memory_order_acquire);
+    if (RunPendingJob()) continue;
+    if (stop_.load(std::memory_order_acquire)) return;
+    wake_count_.wait(wake_count, std::memory_order_acquire);
+  }
+}
+
+void TaskGroup::Run(JobSystem::Job job) {
+  pending_.fetch_add(1, std::memory_order_relaxed);
+  job_system_.Submit([this, job = std::move(job)] {
+    job();
+    // Last access to the group, which may be destroyed as soon as Wait sees
+    // no job pending
+    pending_.fetch_sub(1, std::memory_order_release);
+  });
+}
+
+void TaskGroup::Wait() {
+  while (pending_.load(std::memory_order_acquire) > 0) {
+    if (!job_system_.RunPendingJob()) {
+      std::this_thread::yield();
+    }
+  }
+}
+
+}  // namespace konkr
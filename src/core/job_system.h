@@ -0,0 +1,153 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+//
+// job_system.h
+//
+// Declares the JobSystem class, a work-stealing thread pool, the TaskGroup
+// class, which waits for a set of jobs, and ParallelFor, which splits a range
+// of indices between the workers.
+//
+
+#ifndef KONKR_CORE_JOB_SYSTEM_H
+#define KONKR_CORE_JOB_SYSTEM_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace konkr {
+
+// Runs jobs on a fixed set of worker threads. Each worker has its own deque:
+// jobs submitted from a worker go to the back of its deque and it runs them
+// last in, first out, which keeps the data of nested jobs in its cache. A
+// worker without jobs steals the oldest job of another worker, so the load
+// balances itself without a shared queue every thread contends on.
+//
+// Jobs must not throw. A job may submit and wait for other jobs: waiting
+// runs pending jobs instead of blocking (see TaskGroup::Wait).
+class JobSystem {
+ public:
+  using Job = std::function<void()>;
+
+  // Shared by the whole game, with one worker per core but one: the thread
+  // waiting for the jobs runs them too.
+  static JobSystem& GetInstance() {
+    static JobSystem instance(DefaultWorkerCount());
+    return instance;
+  }
+
+  static size_t DefaultWorkerCount();
+
+  // Starts worker_count worker threads, at least one
+  explicit JobSystem(size_t worker_count);
+  // Runs the jobs left, then joins the workers
+  ~JobSystem();
+
+  JobSystem(const JobSystem&) = delete;
+  JobSystem& operator=(const JobSystem&) = delete;
+
+  inline size_t worker_count() const { return workers_.size(); }
+
+  // Queues a job without waiting for it. Use a TaskGroup to wait.
+  void Submit(Job job);
+
+  // Runs one pending job on the calling thread, taken from its own deque if
+  // it is a worker, stolen from the others otherwise. Returns false if there
+  // was none.
+  bool RunPendingJob();
+
+ private:
+  struct Worker {
+    std::mutex mutex;
+    std::deque<Job> jobs;
+    std::thread thread;
+  };
+
+  void Run(size_t index);
+  // Pops the newest job of worker index, or steals the oldest one of another
+  // worker. index is worker_count() for threads that aren't workers.
+  bool TakeJob(size_t index, Job& job);
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  // Incremented for every job submitted, idle workers sleep while it doesn't
+  // change
+  std::atomic<uint32_t> wake_count_ = 0;
+  // Worker getting the next job submitted from outside the pool
+  std::atomic<size_t> next_worker_ = 0;
+  std::atomic<bool> stop_ = false;
+};
+
+// Set of jobs that can be waited for together. The group must outlive its
+// jobs, so it waits for them when destroyed.
+class TaskGroup {
+ public:
+  explicit TaskGroup(JobSystem& job_system = JobSystem::GetInstance())
+      : job_system_(job_system) {}
+  ~TaskGroup() { Wait(); }
+
+  TaskGroup(const TaskGroup&) = delete;
+  TaskGroup& operator=(const TaskGroup&) = delete;
+
+  void Run(JobSystem::Job job);
+
+  // Returns once every job run by the group is done, running pending jobs
+  // (of any group) in the meantime
+  void Wait();
+
+  inline JobSystem& job_system() const { return job_system_; }
+
+ private:
+  JobSystem& job_system_;
+  std::atomic<size_t> pending_ = 0;
+};
+
+// Calls function(chunk_begin, chunk_end) on consecutive chunks covering
+// [begin, end), in parallel, and returns once all of them are done. A chunk
+// holds at least grain indices, so that tiny chunks don't cost more to
+// schedule than to run. The calling thread runs one of the chunks.
+template <typename Function>
+void ParallelFor(size_t begin, size_t end, size_t grain, Function&& function,
+                 JobSystem& job_system = JobSystem::GetInstance()) {
+  if (begin >= end) return;
+  const size_t count = end - begin;
+  grain = std::max<size_t>(grain, 1);
+  // A few chunks per thread, so that the workers stealing them even out
+  // chunks slower than the others
+  const size_t max_chunks = (job_system.worker_count() + 1) * 4;
+  const size_t chunks = std::min((count + grain - 1) / grain, max_chunks);
+  if (chunks <= 1) {
+    function(begin, end);
+    return;
+  }
+
+  TaskGroup group(job_system);
+  const size_t chunk_size = count / chunks;
+  const size_t remainder = count % chunks;
+  size_t chunk_begin = begin;
+  for (size_t chunk = 0; chunk < chunks; ++chunk) {
+    const size_t chunk_end =
+        chunk_begin + chunk_size + (chunk < remainder ? 1 : 0);
+    if (chunk + 1 == chunks) {
+      function(chunk_begin, chunk_end);
+    } else {
+      group.Run([&function, chunk_begin, chunk_end] {
+        function(chunk_begin, chunk_end);
+      });
+    }
+    chunk_begin = chunk_end;
+  }
+  group.Wait();
+}
+
+}  // namespace konkr
+
+#endif  // KONKR_CORE_JOB_SYSTEM_H
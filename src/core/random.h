@@ -0,0 +1,98 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+//
+// random.h
+//
+// Declares the random number generators of the game: counter-based streams,
+// all derived from the seed of a game, so that a game can be reproduced.
+//
+
+#ifndef KONKR_CORE_RANDOM_H
+#define KONKR_CORE_RANDOM_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+
+namespace konkr {
+
+// The subsystems drawing random numbers, each from its own stream, so that
+// drawing more numbers in one of them doesn't change the others
+enum class RandomStreamId : uint8_t { PlayerNames, Bandits };
+constexpr size_t kRandomStreamCount = 2;
+
+// Counter-based generator: the n-th number of a stream is a hash of its key
+// and n (the SplitMix64 finalizer), so a stream is just two integers, is
+// cheap to copy, and can jump to any position.
+class RandomStream {
+ public:
+  constexpr RandomStream() = default;
+  constexpr RandomStream(uint64_t seed, uint64_t stream)
+      : key_(Mix(seed ^ Mix(stream + kGamma))) {}
+
+  // Number of values drawn so far
+  constexpr uint64_t counter() const { return counter_; }
+  constexpr void set_counter(uint64_t counter) { counter_ = counter; }
+
+  constexpr uint64_t Next() { return Mix(key_ + ++counter_ * kGamma); }
+
+  // Uniform in [0, bound), bound > 0. Uses the high bits of a multiplication
+  // rather than a modulo: faster, with a bias negligible for the small
+  // bounds of the game.
+  constexpr uint32_t NextBelow(uint32_t bound) {
+    return static_cast<uint32_t>(((Next() >> 32) * bound) >> 32);
+  }
+
+  constexpr bool NextBool() { return Next() >> 63; }
+
+ private:
+  static constexpr uint64_t kGamma = 0x9e3779b97f4a7c15;
+
+  static constexpr uint64_t Mix(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+    return z ^ (z >> 31);
+  }
+
+  uint64_t key_ = 0;
+  uint64_t counter_ = 0;
+};
+
+// The random streams of a game. Given the same seed and the same inputs, a
+// game draws the same numbers.
+class GameRandom {
+ public:
+  constexpr explicit GameRandom(uint64_t seed = 0) { Reseed(seed); }
+
+  constexpr uint64_t seed() const { return seed_; }
+
+  constexpr void Reseed(uint64_t seed) {
+    seed_ = seed;
+    for (size_t i = 0; i < kRandomStreamCount; ++i) {
+      streams_[i] = RandomStream(seed, i);
+    }
+  }
+
+  constexpr RandomStream& stream(RandomStreamId id) {
+    return streams_[static_cast<size_t>(id)];
+  }
+  constexpr const RandomStream& stream(RandomStreamId id) const {
+    return streams_[static_cast<size_t>(id)];
+  }
+
+ private:
+  uint64_t seed_ = 0;
+  std::array<RandomStream, kRandomStreamCount> streams_;
+};
+
+// Seed for a new game, the only source of randomness that isn't reproducible
+inline uint64_t NewGameSeed() {
+  std::random_device device;
+  return static_cast<uint64_t>(device()) << 32 | device();
+}
+
+}  // namespace konkr
+
+#endif  // KONKR_CORE_RANDOM_H
@@ -0,0 +1,66 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+//
+// spsc_queue.h
+//
+// Declares the SpscQueue class, a bounded lock-free queue between one
+// producer thread and one consumer thread.
+//
+
+#ifndef KONKR_CORE_SPSC_QUEUE_H
+#define KONKR_CORE_SPSC_QUEUE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <utility>
+
+namespace konkr {
+
+// Ring buffer of Capacity values. The producer only writes tail_ and the
+// consumer only writes head_, so pushing and popping are a few loads and
+// stores, never a lock.
+template <typename T, size_t Capacity>
+class SpscQueue {
+  static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                "The capacity must be a power of two");
+
+ public:
+  SpscQueue() = default;
+  SpscQueue(const SpscQueue&) = delete;
+  SpscQueue& operator=(const SpscQueue&) = delete;
+
+  // Producer thread: returns false if the queue is full
+  bool TryPush(T value) {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_.load(std::memory_order_acquire) == Capacity) {
+      return false;
+    }
+    items_[tail & (Capacity - 1)] = std::move(value);
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer thread: returns nullopt if the queue is empty
+  std::optional<T> TryPop() {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire)) {
+      return std::nullopt;
+    }
+    std::optional<T> value = std::move(items_[head & (Capacity - 1)]);
+    head_.store(head + 1, std::memory_order_release);
+    return value;
+  }
+
+ private:
+  std::array<T, Capacity> items_;
+  // On separate cache lines, as each is written by a different thread
+  alignas(64) std::atomic<size_t> head_ = 0;  // Next value to pop
+  alignas(64) std::atomic<size_t> tail_ = 0;  // Next slot to push to
+};
+
+}  // namespace konkr
+
+#endif  // KONKR_CORE_SPSC_QUEUE_H
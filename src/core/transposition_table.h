@@ -0,0 +1,92 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+//
+// transposition_table.h
+//
+// Declares the TranspositionTable class, a fixed-size cache of values indexed
+// by 64-bit hashes that threads share without locks.
+//
+
+#ifndef KONKR_CORE_TRANSPOSITION_TABLE_H
+#define KONKR_CORE_TRANSPOSITION_TABLE_H
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <type_traits>
+
+namespace konkr {
+
+// Lets search and analysis code skip states it already evaluated: Store the
+// result under the hash of a state (see ZobristHash), Probe for it later.
+//
+// The table never grows: a hash goes to the slot given by its low bits, and
+// a store replaces whatever the slot held. Each slot is two atomic words, the
+// value and the hash XOR the value. A reader racing a writer may see the
+// words of two different stores, but then they don't XOR back to the hash
+// it looks for, so the read is a miss rather than a wrong value.
+//
+// Value must be trivially copyable and fit in 8 bytes. The hash 0 isn't
+// stored, as empty slots use it.
+template <typename Value>
+class TranspositionTable {
+  static_assert(std::is_trivially_copyable_v<Value>);
+  static_assert(sizeof(Value) <= sizeof(uint64_t));
+
+ public:
+  // Holds at least capacity values, rounded up to a power of two
+  explicit TranspositionTable(size_t capacity)
+      : mask_(std::bit_ceil(std::max<size_t>(capacity, 1)) - 1),
+        slots_(std::make_unique<Slot[]>(mask_ + 1)) {}
+
+  TranspositionTable(const TranspositionTable&) = delete;
+  TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+  inline size_t capacity() const { return mask_ + 1; }
+
+  void Store(uint64_t hash, const Value& value) {
+    if (hash == 0) return;
+    uint64_t data = 0;
+    std::memcpy(&data, &value, sizeof(Value));
+    Slot& slot = slots_[hash & mask_];
+    slot.check.store(hash ^ data, std::memory_order_relaxed);
+    slot.data.store(data, std::memory_order_relaxed);
+  }
+
+  std::optional<Value> Probe(uint64_t hash) const {
+    const Slot& slot = slots_[hash & mask_];
+    const uint64_t data = slot.data.load(std::memory_order_relaxed);
+    const uint64_t check = slot.check.load(std::memory_order_relaxed);
+    if (hash == 0 || (check ^ data) != hash) return std::nullopt;
+    Value value;
+    std::memcpy(&value, &data, sizeof(Value));
+    return value;
+  }
+
+  // Not safe to call while other threads use the table
+  void Clear() {
+    for (size_t i = 0; i <= mask_; ++i) {
+      slots_[i].check.store(0, std::memory_order_relaxed);
+      slots_[i].data.store(0, std::memory_order_relaxed);
+    }
+  }
+
+ private:
+  struct Slot {
+    std::atomic<uint64_t> check{0};  // Hash XOR data
+    std::atomic<uint64_t> data{0};
+  };
+
+  size_t mask_;
+  std::unique_ptr<Slot[]> slots_;
+};
+
+}  // namespace konkr
+
+#endif  // KONKR_CORE_TRANSPOSITION_TABLE_H
@@ -0,0 +1,74 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+//
+// triple_buffer.h
+//
+// Declares the TripleBuffer class, which hands values over from one writer
+// thread to one reader thread without locking either of them.
+//
+
+#ifndef KONKR_CORE_TRIPLE_BUFFER_H
+#define KONKR_CORE_TRIPLE_BUFFER_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace konkr {
+
+// Three copies of T: the writer fills the back buffer and publishes it, the
+// reader takes the latest published one as its front buffer. The third
+// buffer sits in the middle, so neither side ever waits for the other: the
+// writer can publish again while the reader still uses the previous value,
+// and the reader always gets the most recent value, skipping the ones it
+// missed.
+//
+// Buffers are reused, so the writer should overwrite the back buffer in place
+// to keep its allocations.
+template <typename T>
+class TripleBuffer {
+ public:
+  TripleBuffer() = default;
+  TripleBuffer(const TripleBuffer&) = delete;
+  TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+  // Writer thread: the buffer to fill before Publish
+  T& back() { return buffers_[back_]; }
+
+  // Writer thread: makes the back buffer the latest value, and gets a new
+  // back buffer
+  void Publish() {
+    back_ = middle_.exchange(back_ | kFreshBit, std::memory_order_acq_rel) &
+            kIndexMask;
+  }
+
+  // Reader thread: takes the latest value, if one was published since the
+  // last call. Returns whether the front buffer changed.
+  bool Update() {
+    if (!(middle_.load(std::memory_order_relaxed) & kFreshBit)) return false;
+    front_ = middle_.exchange(front_, std::memory_order_acq_rel) & kIndexMask;
+    return true;
+  }
+
+  // Reader thread: the value taken by the last Update, valid until the next
+  // one
+  const T& front() const { return buffers_[front_]; }
+
+ private:
+  // The middle index and whether it was published since the reader's last
+  // Update, in one atomic
+  static constexpr uint8_t kIndexMask = 0x3;
+  static constexpr uint8_t kFreshBit = 0x4;
+
+  std::array<T, 3> buffers_;
+  // Only used by the writer
+  alignas(64) uint8_t back_ = 0;
+  alignas(64) std::atomic<uint8_t> middle_ = 1;
+  // Only used by the reader
+  alignas(64) uint8_t front_ = 2;
+};
+
+}  // namespace konkr
+
+#endif  // KONKR_CORE_TRIPLE_BUFFER_H
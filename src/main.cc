@@ -11,6 +11,7 @@
 #include "rendering/graphics.h"
 #include "rendering/level.h"
 #include "rendering/level_renderer.h"
+#include "rendering/resource_cache.h"
 #include "rendering/sprite_sheet.h"
 #include "ui/user_interface.h"
 #include "world/entity.h"
@@ -18,39 +19,28 @@
 #include "world/townhall.h"
 
 int main() {
-  konkr::SpriteSheet& sprite_sheet = konkr::SpriteSheet::GetInstance();
-
-  const std::filesystem::path atlas_json_path = "assets/atlas.json";
-  const std::filesystem::path atlas_png_path = "assets/atlas.png";
+  // Packed image of atlas.png, written by the atlas compiler at build time
+  // along with the sprite table and the downscaled pages
+  const std::filesystem::path atlas_path = "assets/atlas.bin";
 
-  std::cout << "Attempting to load sprite definitions from: " << atlas_json_path
-            << std::endl;
+  // Starts decoding the atlas and the font on worker threads, while the window
+  // is created
+  konkr::SpriteSheet& sprite_sheet = konkr::SpriteSheet::GetInstance();
+  sprite_sheet.Prefetch(atlas_path);
+  konkr::ResourceCache::GetInstance().Load<konkr::Font>(
+      konkr::LevelRenderer::kFontPath);
 
-  if (sprite_sheet.LoadSpriteDefinitions(atlas_json_path)) {
-    std::cout << "Successfully loaded sprite definitions." << std::endl;
-  } else {
-    std::cerr << "Failed to load sprite definitions." << std::endl;
-    return -1;
-  }
+  konkr::RenderTarget render_target({1920u, 1080u}, "konkr");
+  render_target.get_window().setFramerateLimit(144);
 
-  std::cout << "Attempting to load texture from: " << atlas_png_path
-            << std::endl;
-  if (sprite_sheet.LoadFromFile(atlas_png_path)) {
+  std::cout << "Attempting to load texture from: " << atlas_path << std::endl;
+  if (sprite_sheet.LoadFromFile(atlas_path)) {
     std::cout << "Successfully loaded texture." << std::endl;
   } else {
     std::cerr << "Failed to load texture." << std::endl;
     return -1;
   }
 
-  if (sprite_sheet.LoadEntitySpriteMappings("assets/entity_sprites.json")) {
-    std::cout << "Successfully loaded entity sprite mappings." << std::endl;
-  } else {
-    std::cerr << "Failed to load entity sprite mappings." << std::endl;
-    return -1;
-  }
-
-  konkr::RenderTarget render_target({1920u, 1080u}, "konkr");
-  render_target.get_window().setFramerateLimit(144);
   konkr::UserInterface ui(render_target);
 
   konkr::LevelRenderer renderer;
@@ -66,10 +56,18 @@ int main() {
 
     render_target.get_window().clear(konkr::ColorPalette::OceanBlue);
 
-    // Draw the level if in Game state
-    if (ui.current_state() == konkr::UserInterfaceState::Game &&
-        ui.is_level_selected()) {
-      renderer.Render(render_target, ui.selected_level(), 50.0f);
+    ui.Update();
+
+    // Draw the latest snapshot of the level if in Game state, the simulation
+    // runs on its own thread
+    if (const konkr::RenderSnapshot* snapshot = ui.latest_snapshot()) {
+      const sf::Vector2f mouse = render_target.get_window().mapPixelToCoords(
+          sf::Mouse::getPosition(render_target.get_window()));
+      const auto hovered_tile = konkr::LevelRenderer::PixelToTile(
+          *snapshot, render_target.get_size(),
+          konkr::LevelRenderer::kHexRadius, konkr::Vector2f(mouse.x, mouse.y));
+      renderer.Render(render_target, *snapshot,
+                      konkr::LevelRenderer::kHexRadius, hovered_tile);
     }
 
     ui.Draw();
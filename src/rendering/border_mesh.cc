@@ -0,0 +1,115 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+
+#include "rendering/border_mesh.h"
+
+#include <cmath>
+#include <numbers>
+
+#include "rendering/color_palette.h"
+
+namespace konkr {
+
+void BorderMesh::Update(const RenderSnapshot& snapshot, float hex_radius) {
+  if (snapshot.version == version_ && hex_radius == hex_radius_) return;
+  version_ = snapshot.version;
+
+  if (hex_radius != hex_radius_ || snapshot.columns != columns_ ||
+      snapshot.tiles.size() != walls_.size() ||
+      snapshot.indented_rows != indented_rows_) {
+    Reset(snapshot, hex_radius);
+  }
+
+  // Comparing a few bytes per tile is much cheaper than writing its walls
+  for (size_t index = 0; index < snapshot.tiles.size(); ++index) {
+    const TileSnapshot& tile = snapshot.tiles[index];
+    if (tile.walls != walls_[index] || tile.owner != owners_[index]) {
+      WriteTile(snapshot, static_cast<int>(index));
+    }
+  }
+}
+
+void BorderMesh::Draw(RenderTarget& target, Vector2f origin) {
+  if (mesh_.get_vertex_count() == 0) return;
+  mesh_.set_position(origin);
+  target.draw(mesh_);
+}
+
+void BorderMesh::Reset(const RenderSnapshot& snapshot, float hex_radius) {
+  hex_radius_ = hex_radius;
+  columns_ = snapshot.columns;
+  indented_rows_ = snapshot.indented_rows;
+  corners_.clear();
+  for (int corner = 0; corner < 6; ++corner) {
+    const float angle = std::numbers::pi_v<float> * (corner / 3.0f - 0.5f);
+    corners_.emplace_back(hex_radius * std::cos(angle),
+                          hex_radius * std::sin(angle));
+  }
+  walls_.assign(snapshot.tiles.size(), 0);
+  owners_.assign(snapshot.tiles.size(), -1);
+  slots_.assign(snapshot.tiles.size(), -1);
+  free_slots_.clear();
+  mesh_.resize(0);
+}
+
+void BorderMesh::WriteTile(const RenderSnapshot& snapshot, int index) {
+  const TileSnapshot& tile = snapshot.tiles[index];
+  walls_[index] = tile.walls;
+  owners_[index] = tile.owner;
+
+  int& slot = slots_[index];
+  const bool drawn = tile.walls != 0 && tile.owner >= 0;
+  if (slot < 0) {
+    if (!drawn) return;
+    if (free_slots_.empty()) {
+      slot = static_cast<int>(mesh_.get_vertex_count());
+      mesh_.resize(slot + kSlotVertices);
+    } else {
+      slot = free_slots_.back();
+      free_slots_.pop_back();
+    }
+  }
+
+  const int row = index / columns_;
+  const int column = index % columns_;
+  const float hex_width = std::sqrt(3.0f) * hex_radius_;
+  const Vector2f center(
+      column * hex_width + (indented_rows_[row] ? hex_width / 2 : 0),
+      row * hex_radius_ * 1.5f);
+  const Color color =
+      drawn ? ColorPalette::BorderColorForPlayer(tile.owner) : Color::Black;
+  const float inset = 1 - kWidth;
+  for (int wall = 0; wall < 6; ++wall) {
+    const int first = slot + wall * 6;
+    if (!drawn || !(tile.walls & (1 << wall))) {
+      // Degenerate triangles, at the center of the tile
+      for (int vertex = 0; vertex < 6; ++vertex) {
+        mesh_.set_vertex(first + vertex, center, color);
+      }
+      continue;
+    }
+    // The wall joins the corners at its ends, inset towards the center
+    const Vector2f start = corners_[wall];
+    const Vector2f end = corners_[(wall + 1) % 6];
+    const Vector2f outer_start(center.x + start.x, center.y + start.y);
+    const Vector2f outer_end(center.x + end.x, center.y + end.y);
+    const Vector2f inner_start(center.x + start.x * inset,
+                               center.y + start.y * inset);
+    const Vector2f inner_end(center.x + end.x * inset,
+                             center.y + end.y * inset);
+    mesh_.set_vertex(first, outer_start, color);
+    mesh_.set_vertex(first + 1, outer_end, color);
+    mesh_.set_vertex(first + 2, inner_end, color);
+    mesh_.set_vertex(first + 3, outer_start, color);
+    mesh_.set_vertex(first + 4, inner_end, color);
+    mesh_.set_vertex(first + 5, inner_start, color);
+  }
+
+  if (!drawn) {
+    free_slots_.push_back(slot);
+    slot = -1;
+  }
+}
+
+}  // namespace konkr
@@ -0,0 +1,66 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+//
+// border_mesh.h
+//
+// Declares the BorderMesh class, which draws the borders of the territories
+// of a level, the walls of its tiles, as a single mesh.
+
+#ifndef KONKR_RENDERING_BORDER_MESH_H
+#define KONKR_RENDERING_BORDER_MESH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "rendering/graphics.h"
+#include "rendering/render_snapshot.h"
+
+namespace konkr {
+
+// Each wall is a band along the side of its tile, of the color of the owner
+// of the tile, so a border between two territories shows both colors. The
+// walls of a tile are a slot of kSlotVertices vertices of the mesh, written
+// again only when its walls or its owner change, and drawn with the others
+// in one call rather than a shape per tile.
+class BorderMesh {
+ public:
+  // Width of the walls, relative to the radius of the tiles
+  static constexpr float kWidth = 0.08f;
+
+  // Brings the mesh up to date with snapshot, drawn with tiles of hex_radius
+  void Update(const RenderSnapshot& snapshot, float hex_radius);
+
+  // Draws the walls, origin being where the tile at row 0, column 0 would be
+  // without indentation
+  void Draw(RenderTarget& target, Vector2f origin);
+
+ private:
+  // Two triangles per wall
+  static constexpr int kSlotVertices = 6 * 6;
+
+  // Forgets the slots, for a snapshot of another size or radius
+  void Reset(const RenderSnapshot& snapshot, float hex_radius);
+  // Writes the walls of tile index of snapshot to its slot
+  void WriteTile(const RenderSnapshot& snapshot, int index);
+
+  TriangleMesh mesh_;
+  uint64_t version_ = 0;
+  float hex_radius_ = 0;
+  int columns_ = 0;
+  std::vector<bool> indented_rows_;
+  // Corners of a tile, clockwise from the top, relative to its center
+  std::vector<Vector2f> corners_;
+  // Walls and owner of each tile, as written to the mesh
+  std::vector<uint8_t> walls_;
+  std::vector<int8_t> owners_;
+  // First vertex of the slot of each tile, -1 for the tiles without walls
+  std::vector<int> slots_;
+  // Slots of the tiles that lost their walls, which draw nothing
+  std::vector<int> free_slots_;
+};
+
+}  // namespace konkr
+
+#endif  // KONKR_RENDERING_BORDER_MESH_H
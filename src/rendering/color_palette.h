@@ -70,6 +70,12 @@ struct ColorPalette {
                  static_cast<uint8_t>((g + m) * 255),
                  static_cast<uint8_t>((b + m) * 255));
   }
+
+  // Darker shade of the sand of a player, for the borders of its territory
+  static Color BorderColorForPlayer(int player_id) {
+    const Color sand = SandColorForPlayer(player_id);
+    return Color(sand.r() / 2, sand.g() / 2, sand.b() / 2);
+  }
 };
 
 }  // namespace konkr
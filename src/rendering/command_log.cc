@@ -0,0 +1,211 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+
+#include "rendering/command_log.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+namespace konkr {
+
+namespace {
+
+// Layout of a file: the magic, the version, the level (name, category and
+// path), the seed, the last turn, the command count, the command stream and
+// the keyframes, each integer as a varint
+constexpr uint8_t kMagic[4] = {'K', 'R', 'P', 'L'};
+// Versions of the format, numbered as those of the save games:
+//  1. the first one, with NextTurn, SelectTile, Undo and Redo;
+//  2. MoveUnit, and the units record whether they moved in the keyframes;
+//  3. BuyUnit, BuildCastle and MergeUnits;
+//  4. the bandits move at the end of every turn, drawing from their own
+//     random stream, saved in the keyframes.
+// A replay applies the commands under the rules of the game as it is, which
+// changed with every version, so older logs are rejected.
+constexpr uint64_t kVersion = 4;
+
+}  // namespace
+
+void CommandLog::Begin(const Level& level) {
+  level_name_ = level.name();
+  level_category_ = level.category();
+  level_path_ = level.file_path();
+  seed_ = level.seed();
+  commands_.clear();
+  command_count_ = 0;
+  last_turn_ = level.turn();
+  keyframes_.clear();
+  AddKeyframe(level);
+}
+
+void CommandLog::Record(const GameCommand& command, const Level& level) {
+  ByteWriter writer(commands_);
+  writer.WriteByte(static_cast<uint8_t>(command.type));
+  if (command.type == GameCommand::Type::SelectTile || command.is_action()) {
+    writer.WriteSignedVarint(command.tile.x);
+    writer.WriteSignedVarint(command.tile.y);
+  }
+  if (command.type == GameCommand::Type::MoveUnit ||
+      command.type == GameCommand::Type::MergeUnits) {
+    writer.WriteSignedVarint(command.target.x);
+    writer.WriteSignedVarint(command.target.y);
+  }
+  ++command_count_;
+  last_turn_ = level.turn();
+
+  if (command.type == GameCommand::Type::NextTurn &&
+      level.turn() % kKeyframeInterval == 0) {
+    AddKeyframe(level);
+  }
+}
+
+bool CommandLog::ReadCommand(ByteReader& reader, GameCommand& command) {
+  uint8_t type;
+  if (!reader.ReadByte(type)) return false;
+  switch (static_cast<GameCommand::Type>(type)) {
+    case GameCommand::Type::NextTurn:
+    case GameCommand::Type::Undo:
+    case GameCommand::Type::Redo:
+      command = {static_cast<GameCommand::Type>(type)};
+      return true;
+    case GameCommand::Type::SelectTile:
+    case GameCommand::Type::BuyUnit:
+    case GameCommand::Type::BuildCastle: {
+      int64_t row, col;
+      if (!reader.ReadSignedVarint(row) || !reader.ReadSignedVarint(col)) {
+        return false;
+      }
+      command = {static_cast<GameCommand::Type>(type),
+                 {static_cast<int>(row), static_cast<int>(col)}};
+      return true;
+    }
+    case GameCommand::Type::MoveUnit:
+    case GameCommand::Type::MergeUnits: {
+      int64_t row, col, target_row, target_col;
+      if (!reader.ReadSignedVarint(row) || !reader.ReadSignedVarint(col) ||
+          !reader.ReadSignedVarint(target_row) ||
+          !reader.ReadSignedVarint(target_col)) {
+        return false;
+      }
+      command = {static_cast<GameCommand::Type>(type),
+                 {static_cast<int>(row), static_cast<int>(col)},
+                 {static_cast<int>(target_row), static_cast<int>(target_col)}};
+      return true;
+    }
+  }
+  return false;
+}
+
+const CommandLog::Keyframe* CommandLog::FindKeyframe(uint32_t turn) const {
+  auto after = std::upper_bound(
+      keyframes_.begin(), keyframes_.end(), turn,
+      [](uint32_t turn, const Keyframe& k) { return turn < k.turn; });
+  if (after == keyframes_.begin()) return nullptr;
+  return &*std::prev(after);
+}
+
+void CommandLog::AddKeyframe(const Level& level) {
+  Keyframe keyframe;
+  keyframe.turn = level.turn();
+  keyframe.command_offset = commands_.size();
+  ByteWriter writer(keyframe.state);
+  level.WriteState(writer);
+  keyframes_.push_back(std::move(keyframe));
+}
+
+bool CommandLog::WriteToFile(const std::filesystem::path& path) const {
+  std::vector<uint8_t> data;
+  ByteWriter writer(data);
+  writer.WriteBytes(kMagic, sizeof(kMagic));
+  writer.WriteVarint(kVersion);
+  writer.WriteString(level_name_);
+  writer.WriteString(level_category_);
+  writer.WriteString(level_path_.generic_string());
+  writer.WriteVarint(seed_);
+  writer.WriteVarint(last_turn_);
+  writer.WriteVarint(command_count_);
+  writer.WriteVarint(commands_.size());
+  writer.WriteBytes(commands_.data(), commands_.size());
+  writer.WriteVarint(keyframes_.size());
+  for (const auto& keyframe : keyframes_) {
+    writer.WriteVarint(keyframe.turn);
+    writer.WriteVarint(keyframe.command_offset);
+    writer.WriteVarint(keyframe.state.size());
+    writer.WriteBytes(keyframe.state.data(), keyframe.state.size());
+  }
+
+  std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+  if (!stream.is_open()) {
+    std::cerr << "Failed to open command log file: " << path << std::endl;
+    return false;
+  }
+  stream.write(reinterpret_cast<const char*>(data.data()),
+               static_cast<std::streamsize>(data.size()));
+  return static_cast<bool>(stream);
+}
+
+bool CommandLog::ReadFromFile(const std::filesystem::path& path) {
+  std::ifstream stream(path, std::ios::binary);
+  if (!stream.is_open()) {
+    std::cerr << "Failed to open command log file: " << path << std::endl;
+    return false;
+  }
+  const std::vector<uint8_t> data(std::istreambuf_iterator<char>(stream),
+                                  {});
+  ByteReader reader(data);
+
+  uint8_t magic[sizeof(kMagic)];
+  uint64_t version, last_turn, command_count, commands_size, keyframe_count;
+  std::string level_path;
+  if (!reader.ReadBytes(magic, sizeof(magic)) ||
+      !std::equal(std::begin(kMagic), std::end(kMagic), magic) ||
+      !reader.ReadVarint(version)) {
+    std::cerr << "Invalid command log file: " << path << std::endl;
+    return false;
+  }
+  if (version != kVersion) {
+    std::cerr << "Unsupported command log version " << version
+              << " (expected " << kVersion << "): " << path << std::endl;
+    return false;
+  }
+  if (!reader.ReadString(level_name_) || !reader.ReadString(level_category_) ||
+      !reader.ReadString(level_path) || !reader.ReadVarint(seed_) ||
+      !reader.ReadVarint(last_turn) || !reader.ReadVarint(command_count) ||
+      !reader.ReadVarint(commands_size) ||
+      commands_size > data.size() - reader.position()) {
+    std::cerr << "Invalid command log file: " << path << std::endl;
+    return false;
+  }
+  level_path_ = level_path;
+  last_turn_ = static_cast<uint32_t>(last_turn);
+  command_count_ = command_count;
+  commands_.resize(commands_size);
+  reader.ReadBytes(commands_.data(), commands_size);
+
+  keyframes_.clear();
+  if (!reader.ReadVarint(keyframe_count)) {
+    std::cerr << "Invalid command log file: " << path << std::endl;
+    return false;
+  }
+  for (uint64_t i = 0; i < keyframe_count; ++i) {
+    Keyframe keyframe;
+    uint64_t turn, offset, state_size;
+    if (!reader.ReadVarint(turn) || !reader.ReadVarint(offset) ||
+        !reader.ReadVarint(state_size) || offset > commands_.size() ||
+        state_size > data.size() - reader.position()) {
+      std::cerr << "Invalid command log file: " << path << std::endl;
+      return false;
+    }
+    keyframe.turn = static_cast<uint32_t>(turn);
+    keyframe.command_offset = offset;
+    keyframe.state.resize(state_size);
+    reader.ReadBytes(keyframe.state.data(), state_size);
+    keyframes_.push_back(std::move(keyframe));
+  }
+  return true;
+}
+
+}  // namespace konkr
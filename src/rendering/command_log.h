@@ -0,0 +1,91 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+//
+// command_log.h
+//
+// Declares the CommandLog class, the record of a game: the level it was
+// played on, its seed, the commands applied to it and keyframes of its state.
+//
+
+#ifndef KONKR_RENDERING_COMMAND_LOG_H
+#define KONKR_RENDERING_COMMAND_LOG_H
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "core/byte_stream.h"
+#include "rendering/game_command.h"
+#include "rendering/level.h"
+
+namespace konkr {
+
+// The commands are stored as a compact byte stream: the type of a command in
+// one byte, followed by the tile coordinates as varints for the commands on
+// a tile (then the target for MoveUnit and MergeUnits), so a command usually
+// takes one, three or five bytes. Every kKeyframeInterval turns the
+// state of the level is saved too, so a replay can jump to any turn without
+// applying every command from the start (see ReplayPlayer).
+class CommandLog {
+ public:
+  static constexpr uint32_t kKeyframeInterval = 10;
+
+  // State of the level at the start of a turn
+  struct Keyframe {
+    uint32_t turn = 0;
+    // Position in the command stream of the first command of the turn
+    size_t command_offset = 0;
+    std::vector<uint8_t> state;  // Written by Level::WriteState
+  };
+
+  CommandLog() = default;
+
+  // Starts a new log of the game on level, with a keyframe of its current
+  // state
+  void Begin(const Level& level);
+
+  // Appends a command just applied to level, and a keyframe if it started a
+  // turn at a multiple of kKeyframeInterval
+  void Record(const GameCommand& command, const Level& level);
+
+  // Reads the next command of a command stream. Returns false at the end of
+  // the stream or if the command is malformed.
+  static bool ReadCommand(ByteReader& reader, GameCommand& command);
+
+  // Returns the keyframe closest before (or at) turn, nullptr if the log is
+  // empty
+  const Keyframe* FindKeyframe(uint32_t turn) const;
+
+  bool WriteToFile(const std::filesystem::path& path) const;
+  bool ReadFromFile(const std::filesystem::path& path);
+
+  inline const std::string& level_name() const { return level_name_; }
+  inline const std::string& level_category() const { return level_category_; }
+  inline const std::filesystem::path& level_path() const {
+    return level_path_;
+  }
+  inline uint64_t seed() const { return seed_; }
+  inline const std::vector<uint8_t>& commands() const { return commands_; }
+  inline const std::vector<Keyframe>& keyframes() const { return keyframes_; }
+  inline size_t command_count() const { return command_count_; }
+  // Turn reached after the last command
+  inline uint32_t last_turn() const { return last_turn_; }
+
+ private:
+  void AddKeyframe(const Level& level);
+
+  std::string level_name_;
+  std::string level_category_;
+  std::filesystem::path level_path_;
+  uint64_t seed_ = 0;
+  std::vector<uint8_t> commands_;
+  size_t command_count_ = 0;
+  uint32_t last_turn_ = 0;
+  std::vector<Keyframe> keyframes_;  // Sorted by turn
+};
+
+}  // namespace konkr
+
+#endif  // KONKR_RENDERING_COMMAND_LOG_H
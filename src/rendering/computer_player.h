@@ -0,0 +1,41 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+//
+// computer_player.h
+//
+// Declares the ComputerPlayer interface, which plays for the players the
+// computer controls.
+//
+
+#ifndef KONKR_RENDERING_COMPUTER_PLAYER_H
+#define KONKR_RENDERING_COMPUTER_PLAYER_H
+
+#include <vector>
+
+#include "rendering/game_command.h"
+#include "rendering/level.h"
+
+namespace konkr {
+
+// Called by the Simulation on its thread during the turns of the players the
+// computer controls, so it may take its time without blocking the rendering.
+class ComputerPlayer {
+ public:
+  virtual ~ComputerPlayer() = default;
+
+  // Returns the next command of the current player of level: a MoveUnit it
+  // can make (see Level::CanMoveUnit), or NextTurn to end its turn
+  virtual GameCommand ChooseCommand(const Level& level) = 0;
+
+  // Returns the next commands of the current player of level, applied as one
+  // batch (see Level::ApplyActions): at best the rest of its turn, ending
+  // with a NextTurn. By default the command of ChooseCommand alone.
+  virtual std::vector<GameCommand> ChooseTurn(const Level& level) {
+    return {ChooseCommand(level)};
+  }
+};
+
+}  // namespace konkr
+
+#endif  // KONKR_RENDERING_COMPUTER_PLAYER_H
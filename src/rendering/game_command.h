@@ -0,0 +1,50 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+//
+// game_command.h
+//
+// Declares the GameCommand struct, an action of a player on a level.
+//
+
+#ifndef KONKR_RENDERING_GAME_COMMAND_H
+#define KONKR_RENDERING_GAME_COMMAND_H
+
+#include <cstdint>
+
+#include "rendering/graphics.h"
+
+namespace konkr {
+
+// Everything a player can do to a level goes through a command, so that the
+// commands applied to a level (with its seed) are enough to replay a game.
+struct GameCommand {
+  // Undo and Redo take back and apply again the other commands of the turn.
+  // BuyUnit and BuildCastle place a villager or a castle on tile, MergeUnits
+  // merges the unit at tile into the unit at target.
+  enum class Type : uint8_t {
+    NextTurn,
+    SelectTile,
+    Undo,
+    Redo,
+    MoveUnit,
+    BuyUnit,
+    BuildCastle,
+    MergeUnits
+  };
+
+  Type type = Type::NextTurn;
+  Vector2i tile = {0, 0};  // Grid position, for all but NextTurn, Undo, Redo
+  // Where the unit at tile goes, for MoveUnit and MergeUnits
+  Vector2i target = {0, 0};
+
+  // Whether the command changes the game in a batch of Level::ApplyActions
+  inline bool is_action() const {
+    return type == Type::MoveUnit || type == Type::BuyUnit ||
+           type == Type::BuildCastle || type == Type::MergeUnits;
+  }
+};
+
+}  // namespace konkr
+
+#endif  // KONKR_RENDERING_GAME_COMMAND_H
@@ -11,10 +11,26 @@
 
 namespace konkr {
 
+// Image
+Image::Image() = default;
+Image::~Image() = default;
+
+Vector2u Image::get_size() const {
+  auto size = image_.getSize();
+  return {size.x, size.y};
+}
+
 // Texture
 Texture::Texture() = default;
 Texture::~Texture() = default;
 
+Vector2u Texture::get_size() const {
+  auto size = texture_.getSize();
+  return {size.x, size.y};
+}
+
+void Texture::set_smooth(bool smooth) { texture_.setSmooth(smooth); }
+
 // Sprite
 Sprite::Sprite(const Texture& texture)
     : texture_(&texture), sprite_(texture.texture_) {}
@@ -28,6 +44,8 @@ void Sprite::set_position(Vector2f position) {
   sprite_.setPosition({position.x, position.y});
 }
 
+void Sprite::set_scale(Vector2f scale) { sprite_.setScale({scale.x, scale.y}); }
+
 // Transform
 Transform::Transform(const sf::Transform& sfml_transform) {
   const float* mat = sfml_transform.getMatrix();
@@ -67,11 +85,36 @@ void CircleShape::set_fill_color(const Color& color) {
   circle_shape_.setFillColor(color.color_);
 }
 
+// TriangleMesh
+TriangleMesh::TriangleMesh() : vertices_(sf::PrimitiveType::Triangles) {}
+TriangleMesh::~TriangleMesh() = default;
+
+std::size_t TriangleMesh::get_vertex_count() const {
+  return vertices_.getVertexCount();
+}
+
+void TriangleMesh::resize(std::size_t vertex_count) {
+  vertices_.resize(vertex_count);
+}
+
+void TriangleMesh::set_vertex(std::size_t index, Vector2f position,
+                              const Color& color) {
+  vertices_[index].position = {position.x, position.y};
+  vertices_[index].color = color.color_;
+}
+
+void TriangleMesh::set_position(Vector2f position) { position_ = position; }
+
 Font::Font(const std::string& path) {
   if (font_.openFromFile(path)) {
     loaded_ = true;
   }
 }
+Font::Font(std::shared_ptr<const Data> data) : data_(std::move(data)) {
+  if (data_ && font_.openFromMemory(data_->data(), data_->size())) {
+    loaded_ = true;
+  }
+}
 Font::~Font() = default;
 
 Text::Text(const Font& font, const std::string& text, unsigned int size)
@@ -136,6 +179,12 @@ void RenderTarget::draw(const Text& text) { window_.draw(text.text_); }
 
 void RenderTarget::draw(const Sprite& sprite) { window_.draw(sprite.sprite_); }
 
+void RenderTarget::draw(const TriangleMesh& mesh) {
+  sf::RenderStates states;
+  states.transform.translate({mesh.position_.x, mesh.position_.y});
+  window_.draw(mesh.vertices_, states);
+}
+
 Vector2u RenderTarget::get_size() const {
   auto size = window_.getSize();
   return {size.x, size.y};
@@ -161,6 +210,29 @@ std::unique_ptr<Texture> Graphics::LoadTexture(const std::string& file_path) {
   return texture;
 }
 
+std::unique_ptr<Image> Graphics::DecodeImage(const std::string& file_path) {
+  auto image = std::make_unique<Image>();
+  if (!image->image_.loadFromFile(file_path)) {
+    return nullptr;
+  }
+  return image;
+}
+
+std::unique_ptr<Image> Graphics::CreateImage(Vector2u size,
+                                             const std::uint8_t* pixels) {
+  auto image = std::make_unique<Image>();
+  image->image_.resize({size.x, size.y}, pixels);
+  return image;
+}
+
+std::unique_ptr<Texture> Graphics::CreateTexture(const Image& image) {
+  auto texture = std::make_unique<Texture>();
+  if (!texture->texture_.loadFromImage(image.image_)) {
+    return nullptr;
+  }
+  return texture;
+}
+
 std::unique_ptr<Sprite> Graphics::CreateSprite(const Texture& texture,
                                                const IntRect& rect) {
   auto sprite = std::make_unique<Sprite>(texture);
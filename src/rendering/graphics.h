@@ -12,12 +12,17 @@
 
 #include <SFML/Graphics/CircleShape.hpp>
 #include <SFML/Graphics/Font.hpp>
+#include <SFML/Graphics/Image.hpp>
 #include <SFML/Graphics/RenderWindow.hpp>
 #include <SFML/Graphics/Sprite.hpp>
 #include <SFML/Graphics/Text.hpp>
 #include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace konkr {
 
@@ -42,6 +47,7 @@ struct Vector2 {
   T x;
   T y;
   Vector2(T x, T y) : x(x), y(y) {}
+  bool operator==(const Vector2&) const = default;
 };
 
 using Vector2f = Vector2<float>;
@@ -76,11 +82,30 @@ struct Rect {
 using IntRect = Rect<int>;
 using FloatRect = Rect<float>;
 
+// Pixels of an image in memory. Unlike textures, images can be decoded on any
+// thread.
+class Image {
+ public:
+  Image();
+  ~Image();
+
+  Vector2u get_size() const;
+
+ private:
+  friend class Graphics;
+  sf::Image image_;
+};
+
 class Texture {
  public:
   Texture();
   ~Texture();
 
+  Vector2u get_size() const;
+
+  // Whether the texture is filtered linearly when drawn scaled
+  void set_smooth(bool smooth);
+
  private:
   friend class Graphics;
   friend class Sprite;
@@ -94,6 +119,7 @@ class Sprite {
 
   void set_origin(Vector2f origin);
   void set_position(Vector2f position);
+  void set_scale(Vector2f scale);
 
  private:
   friend class Graphics;
@@ -135,6 +161,27 @@ class CircleShape {
   sf::CircleShape circle_shape_;
 };
 
+// Triangles drawn at once, three vertices each, unlike shapes drawn one by
+// one
+class TriangleMesh {
+ public:
+  TriangleMesh();
+  ~TriangleMesh();
+
+  std::size_t get_vertex_count() const;
+  // New vertices are at the origin, so they draw nothing
+  void resize(std::size_t vertex_count);
+  void set_vertex(std::size_t index, Vector2f position,
+                  const class Color& color);
+  // Offset of the vertices on the target
+  void set_position(Vector2f position);
+
+ private:
+  friend class RenderTarget;
+  sf::VertexArray vertices_;
+  Vector2f position_ = {0, 0};
+};
+
 class Color {
  public:
   Color(int r, int g, int b);
@@ -151,20 +198,30 @@ class Color {
  private:
   friend class CircleShape;
   friend class Text;
+  friend class TriangleMesh;
   sf::Color color_;
 };
 
 class Font {
  public:
+  using Data = std::vector<std::byte>;
+
   Font() = default;
   Font(const std::string& path);
+  // Loads the font from the content of a font file. The data is shared by the
+  // copies of the font, as glyphs are read from it lazily.
+  Font(std::shared_ptr<const Data> data);
   ~Font();
 
   bool is_loaded() const { return loaded_; }
 
+  // Content of the font file, if the font was loaded from memory.
+  inline const std::shared_ptr<const Data>& data() const { return data_; }
+
  private:
   friend class Text;
   sf::Font font_;
+  std::shared_ptr<const Data> data_;
   bool loaded_ = false;
 };
 
@@ -193,6 +250,7 @@ class RenderTarget {
   void draw(const CircleShape& shape);
   void draw(const Sprite& sprite);
   void draw(const Text& text);
+  void draw(const TriangleMesh& mesh);
   Vector2u get_size() const;
   sf::RenderWindow& get_window();
 
@@ -203,6 +261,11 @@ class RenderTarget {
 class Graphics {
  public:
   static std::unique_ptr<Texture> LoadTexture(const std::string& file_path);
+  static std::unique_ptr<Image> DecodeImage(const std::string& file_path);
+  // Copies size.x * size.y RGBA pixels into a new image
+  static std::unique_ptr<Image> CreateImage(Vector2u size,
+                                            const std::uint8_t* pixels);
+  static std::unique_ptr<Texture> CreateTexture(const Image& image);
   static std::unique_ptr<Sprite> CreateSprite(const Texture& texture,
                                               const IntRect& rect);
 };
@@ -11,42 +11,92 @@
 #include <memory>
 #include <optional>
 #include <queue>
-#include <set>
+#include <span>
 
+#include "core/job_system.h"
 #include "world/entity.h"
 #include "world/player.h"
+#include "world/rules.h"
+#include "world/townhall.h"
 
 namespace konkr {
 
-// Level names are in snake_case, we want to display them in a more
-// human-readable format. Replaces underscores with spaces and capitalizes the
-// first letter.
-std::string FormatLevelNameForDisplay(std::string name) {
-  std::replace(name.begin(), name.end(), '_', ' ');
-  name[0] = std::toupper(name[0]);
-  return name;
-}
-
-std::vector<std::shared_ptr<Level>> Level::GetAvailableLevels(
-    const std::filesystem::path& levels_directory) {
-  std::vector<std::shared_ptr<Level>> levels;
-
-  for (const auto& entry :
-       std::filesystem::recursive_directory_iterator(levels_directory)) {
-    if (entry.is_regular_file() && entry.path().extension() == ".level") {
-      std::string filename = entry.path().stem().string();
-      std::string category = entry.path().parent_path().filename().string();
-      category[0] = std::toupper(category[0]);
-      std::string formatted_name = FormatLevelNameForDisplay(filename);
-
-      levels.push_back(std::make_shared<Level>(
-          std::move(formatted_name), std::move(category), entry.path()));
-    }
-  }
+namespace {
 
-  return levels;
+// ParallelFor on job_system, or function(begin, end) on the calling thread
+// without one
+template <typename Function>
+void ParallelForOn(JobSystem* job_system, size_t begin, size_t end,
+                   size_t grain, Function&& function) {
+  if (!job_system) {
+    if (begin < end) function(begin, end);
+    return;
+  }
+  ParallelFor(begin, end, grain, function, *job_system);
 }
 
+}  // namespace
+
+// The tiles of a level, by the bits of its grid, as the board of TurnRules
+class Level::TileBoard {
+ public:
+  explicit TileBoard(Level& level) : level_(level) {}
+
+  inline const HexGrid& grid() const { return level_.grid_; }
+  inline bool is_land(size_t bit) const {
+    const Tile* tile = GetTile(bit);
+    return tile && Tile::is_sand(tile->type());
+  }
+  inline int owner(size_t bit) const {
+    const Tile* tile = GetTile(bit);
+    return tile ? tile->get_owner().value_or(-1) : -1;
+  }
+  inline Entity::EntityType entity(size_t bit) const {
+    const Entity* entity = GetEntity(bit);
+    return entity ? entity->type() : Entity::EntityType::Unknown;
+  }
+  inline int upkeep(size_t bit) const {
+    const Entity* entity = GetEntity(bit);
+    return entity ? entity->upkeep_cost() : 0;
+  }
+  inline int money(size_t bit) const {
+    return static_cast<const Townhall*>(GetEntity(bit))->money();
+  }
+
+  inline void set_upkeep(size_t bit, int upkeep) {
+    GetEntity(bit)->set_upkeep_cost(upkeep);
+  }
+  inline void set_money(size_t bit, int money) {
+    static_cast<Townhall*>(GetEntity(bit))->set_money(money);
+  }
+  void MakeBandit(size_t bit) {
+    GetTile(bit)->set_entity(CreateEntity(Entity::EntityType::Bandit));
+  }
+  std::span<const BanditSystem::Move> MoveBandits(RandomStream& random) {
+    return level_.bandit_system_->MoveBandits(random);
+  }
+  void MoveEntity(size_t from, size_t to) {
+    Tile* start = GetTile(from);
+    std::shared_ptr<Entity> entity = start->entity();
+    start->set_entity(CreateEntity(Entity::EntityType::Unknown));
+    GetTile(to)->set_entity(std::move(entity));
+  }
+
+ private:
+  inline Tile* GetTile(size_t bit) const {
+    const Vector2i position = level_.grid_.position(bit);
+    return level_.GetTile(position)
+               ? level_.tiles_[position.x][position.y].get()
+               : nullptr;
+  }
+  inline Entity* GetEntity(size_t bit) const {
+    const Tile* tile = GetTile(bit);
+    return tile ? tile->entity().get() : nullptr;
+  }
+
+  Level& level_;
+};
+
 bool Level::Load() {
   map_.clear();
   std::ifstream definition_stream(file_path_);
@@ -81,6 +131,10 @@ void Level::CreateTiles() {
   players_.clear();
   tiles_buildings_.clear();
   tiles_.reserve(map_.size());
+  cur_player_idx_ = 0;
+  turn_ = 0;
+  // Restarts the streams, so the tiles only depend on the map and the seed
+  random_.Reseed(random_.seed());
 
   int i = 0;
   for (const std::string& line : map_) {
@@ -100,7 +154,7 @@ void Level::CreateTiles() {
         ++col;
       } else {
         if (col + 1 < line.size() && std::isdigit(line[col + 1])) {
-          int player_id = line[col + 1] - '0';
+          int player_id = line[col + 1] - '0';  // Below kMaxPlayers
           tile = Tile::FromAscii(c, player_id);
           // if it's not sand we create an entity
           tile->set_entity(CreateEntity(c));
@@ -114,7 +168,9 @@ void Level::CreateTiles() {
                       [player_id](const std::pair<const int, Player>& p) {
                         return p.second.id() == player_id;
                       })) {
-                players_.emplace(player_id, Player(player_id));
+                auto& names = random_.stream(RandomStreamId::PlayerNames);
+                players_.emplace(player_id,
+                                 Player(player_id, GenerateWarriorName(names)));
               }
               // get the player
               auto& player = players_.at(player_id);
@@ -137,38 +193,53 @@ void Level::CreateTiles() {
     tiles_.push_back(std::move(row));
     ++i;
   }
+  LayOutGrid();
   UpdateTilesLevel();
+  UpdateWalls();
+  ObserveTiles();
 }
 
 void Level::UpdateTilesLevel() {
-  // For each building (e.g., Townhall or Castle), claim connected tiles
+  // For each building (e.g., Townhall or Castle), claim connected tiles.
+  // The regions of the buildings are labelled in one pass, along with the
+  // upkeep of the townhalls (see TurnRules), then each region is claimed
+  // once, however many buildings it holds.
+  std::vector<std::shared_ptr<Tile>> buildings;
+  std::vector<size_t> building_bits;
+  buildings.reserve(tiles_buildings_.size());
+  building_bits.reserve(tiles_buildings_.size());
   for (const auto& building : tiles_buildings_) {
     if (auto tile = building.lock()) {
-      auto connected = GetConnectedOwnedTiles(tile);
-      for (auto& t : connected) {
-        t->claim();
-        // if the tile is a townhall, then update the upkeep cost
-        // using the upkeep of the new connected tile
-        if (tile->entity()->is_townhall()) {
-          tile->entity()->set_upkeep_cost(tile->entity()->upkeep_cost() +
-                                          t->entity()->upkeep_cost());
-        }
-      }
+      building_bits.push_back(grid_.bit(tile->grid_position()));
+      buildings.push_back(std::move(tile));
+    }
+  }
+  TileBoard board(*this);
+  turn_rules_.UpdateUpkeeps(board, building_bits);
+  const RegionLabels& labels = turn_rules_.labels();
+  std::vector<bool> claimed(labels.region_count(), false);
+  for (const size_t building : building_bits) {
+    const int32_t region = labels.region(building);
+    if (region == RegionLabels::kNoRegion || claimed[region]) continue;
+    claimed[region] = true;
+    for (const size_t bit : labels.tiles(region)) {
+      const Vector2i position = grid_.position(bit);
+      tiles_[position.x][position.y]->claim();
     }
   }
 
   // if Tile is Townhall or Castle, or neighbor of a Townhall or Castle,
   // then set level_ to 1
-  for (const auto& building : tiles_buildings_) {
-    if (auto tile = building.lock()) {
-      tile->set_level(1);
-      auto neighbors = tile->GetNeighboringTilesGridPosition();
-      for (const auto& neighbor : neighbors) {
-        auto& neighbor_tile = tiles_[neighbor.x][neighbor.y];
-        if (neighbor_tile && !Tile::is_decoration(neighbor_tile->type()) &&
-            tile->get_owner() == neighbor_tile->get_owner()) {
-          neighbor_tile->set_level(1);
-        }
+  for (const auto& tile : buildings) {
+    tile->set_level(1);
+    auto neighbors = tile->GetNeighboringTilesGridPosition();
+    for (const auto& neighbor : neighbors) {
+      // A castle may be built on the edge of the map
+      if (!GetTile(neighbor)) continue;
+      auto& neighbor_tile = tiles_[neighbor.x][neighbor.y];
+      if (!Tile::is_decoration(neighbor_tile->type()) &&
+          tile->get_owner() == neighbor_tile->get_owner()) {
+        neighbor_tile->set_level(1);
       }
     }
   }
@@ -181,13 +252,28 @@ std::vector<std::shared_ptr<Tile>> Level::GetConnectedOwnedTiles(
 
 std::vector<std::shared_ptr<Tile>> Level::GetConnectedOwnedTiles(
     const std::shared_ptr<Tile>& start_tile) {
+  auto connected_tiles = CollectConnectedOwnedTiles(start_tile);
+  for (const auto& tile : connected_tiles) {
+    tile->claim();
+  }
+  return connected_tiles;
+}
+
+std::vector<std::shared_ptr<Tile>> Level::CollectConnectedOwnedTiles(
+    const std::shared_ptr<Tile>& start_tile) const {
   std::vector<std::shared_ptr<Tile>> connected_tiles;
   auto owner = start_tile->get_owner();
   if (!owner.has_value()) {
     return connected_tiles;
   }
 
-  std::set<std::pair<int, int>> visited;
+  // One flag per position of the grid, the rows padded to the longest one
+  size_t columns = 0;
+  for (const auto& row : tiles_) {
+    columns = std::max(columns, row.size());
+  }
+  std::vector<bool> visited(tiles_.size() * columns, false);
+
   std::queue<std::shared_ptr<Tile>> to_visit;
   to_visit.push(start_tile);
 
@@ -195,21 +281,24 @@ std::vector<std::shared_ptr<Tile>> Level::GetConnectedOwnedTiles(
     auto current_tile = to_visit.front();
     to_visit.pop();
 
-    auto pos = current_tile->grid_position();
-    auto key = std::make_pair(pos.x, pos.y);
-    if (visited.count(key)) continue;
-    visited.insert(key);
+    const auto& pos = current_tile->grid_position();
+    if (visited[pos.x * columns + pos.y]) continue;
+    visited[pos.x * columns + pos.y] = true;
 
     if (current_tile->get_owner() == owner &&
         !Tile::is_decoration(current_tile->type())) {
       connected_tiles.push_back(current_tile);
-      current_tile->claim();
 
       for (const auto& neighbor_pos :
            current_tile->GetNeighboringTilesGridPosition()) {
+        if (static_cast<size_t>(neighbor_pos.x) >= tiles_.size() ||
+            static_cast<size_t>(neighbor_pos.y) >=
+                tiles_[neighbor_pos.x].size()) {
+          continue;
+        }
         auto& neighbor_tile = tiles_[neighbor_pos.x][neighbor_pos.y];
         if (neighbor_tile &&
-            !visited.count(std::make_pair(neighbor_pos.x, neighbor_pos.y)) &&
+            !visited[neighbor_pos.x * columns + neighbor_pos.y] &&
             neighbor_tile->get_owner() == owner &&
             !Tile::is_decoration(neighbor_tile->type())) {
           to_visit.push(neighbor_tile);
@@ -223,18 +312,8 @@ std::vector<std::shared_ptr<Tile>> Level::GetConnectedOwnedTiles(
 void Level::UpdateMoney() {
   auto player = get_current_player();
   if (!player) return;
-
-  for (const auto& townhall : player->townhalls()) {
-    townhall->set_money(townhall->money() + townhall->upkeep_cost());
-    if (townhall->money() < 0) {
-      auto connected_tiles = GetConnectedOwnedTiles(townhall->grid_position());
-      for (const auto& tile : connected_tiles) {
-        if (tile->entity()->is_human_unit()) {
-          tile->set_entity(CreateEntity(Entity::EntityType::Bandit));
-        }
-      }
-    }
-  }
+  TileBoard board(*this);
+  turn_rules_.CollectIncome(board, player->id());
 }
 
 void Level::UpdateActivePlayers() {
@@ -243,47 +322,722 @@ void Level::UpdateActivePlayers() {
 
   if (tiles_.empty()) return;
 
-  std::vector<std::optional<int>> active_players;
-
-  for (size_t row = 0; row < tiles_.size(); ++row) {
-    const auto& tile_row = tiles_[row];
+  // Owners found on each row, as a mask of their ids, rows being scanned in
+  // parallel
+  static_assert(kMaxPlayers <= 32);
+  std::vector<uint32_t> row_owners(tiles_.size(), 0);
+  const auto scan_rows = [&](size_t begin, size_t end) {
+    for (size_t row = begin; row < end; ++row) {
+      uint32_t owners = 0;
+      for (const auto& tile : tiles_[row]) {
+        if (!tile) continue;
 
-    for (size_t col = 0; col < tile_row.size(); ++col) {
-      const auto& tile = tile_row[col];
-      if (!tile) continue;
-
-      std::optional<int> tile_owner = tile->get_owner();
-      // If current "winner" isn't the only one left on the map, then the game
-      // isn't over:
-      if (tile_owner.has_value()) {
-        active_players.push_back(tile_owner);
+        std::optional<int> tile_owner = tile->get_owner();
+        if (tile_owner.has_value() && *tile_owner >= 0 &&
+            static_cast<size_t>(*tile_owner) < kMaxPlayers) {
+          owners |= 1u << *tile_owner;
+        }
       }
+      row_owners[row] = owners;
     }
+  };
+  ParallelForOn(job_system_, 0, tiles_.size(), kRowsPerJob, scan_rows);
+
+  uint32_t active_players = 0;
+  for (const uint32_t owners : row_owners) {
+    active_players |= owners;
   }
 
+  const size_t old_player_idx = cur_player_idx_;
   for (auto it = players_.begin(); it != players_.end();) {
-    bool active = false;
-    for (auto pid : active_players) {
-      if (pid.has_value() && pid.value() == it->first) {
-        active = true;
-        break;
-      }
-    }
-    if (!active) {
+    if (it->first < 0 || static_cast<size_t>(it->first) >= kMaxPlayers ||
+        !(active_players >> it->first & 1)) {
       if (cur_player_idx_ >= players_.size() - 1) {
         if (cur_player_idx_ > 0) cur_player_idx_--;
       }
+      change_bus_->OnPlayerRemoved(it->first);
       it = players_.erase(it);
     } else {
       ++it;
     }
   }
+  if (cur_player_idx_ != old_player_idx) {
+    change_bus_->OnCurrentPlayerChanged(old_player_idx, cur_player_idx_);
+  }
 }
 
 void Level::NextTurn() {
   UpdateActivePlayers();
+  MoveBandits();
+  const size_t old_player_idx = cur_player_idx_;
   cur_player_idx_ = (cur_player_idx_ + 1) % active_players_count();
-  std::cout << "Next turn: " << cur_player_idx_ << std::endl;
+  ++turn_;
+  change_bus_->OnCurrentPlayerChanged(old_player_idx, cur_player_idx_);
+  change_bus_->OnTurnChanged(turn_ - 1, turn_);
+  for (const auto& row : tiles_) {
+    for (const auto& tile : row) {
+      if (tile && tile->entity()) tile->entity()->set_moved(false);
+    }
+  }
+  ClearSelection();
+  // The actions of the previous player can't be taken back anymore
+  journal_->ClearHistory();
+}
+
+void Level::SelectTile(Vector2i grid_position) {
+  const Tile* tile = GetTile(grid_position);
+  if (!tile || !get_current_player()) return;
+
+  if (tile->is_reachable() && selected_unit_ &&
+      MoveUnit(*selected_unit_, grid_position)) {
+    ClearSelection();
+    return;
+  }
+  ClearSelection();
+  const Bitset reachable = ReachableTiles(grid_position);
+  if (!reachable.Any()) return;
+  selected_unit_ = grid_position;
+  reachable.ForEach([this](size_t bit) {
+    const Vector2i position = grid_.position(bit);
+    tiles_[position.x][position.y]->set_reachability(true);
+  });
+}
+
+void Level::ClearSelection() {
+  selected_unit_.reset();
+  for (const auto& row : tiles_) {
+    for (const auto& tile : row) {
+      if (tile) tile->set_reachability(false);
+    }
+  }
+}
+
+namespace {
+
+// Describes tile, at bit of the grid, to generator as it is now
+void DescribeTile(MoveGenerator& generator, size_t bit, const Tile& tile,
+                  bool replace) {
+  const auto& entity = tile.entity();
+  const int owner = tile.get_owner().value_or(-1);
+  const bool free = !entity || IsFreeEntity(entity->type());
+  const int defense = entity ? DefenseOf(entity->type(), entity->level()) : 0;
+  if (replace) {
+    generator.ReplaceTile(bit, owner, free, defense);
+  } else {
+    generator.AddTile(bit, owner, free, defense);
+  }
+}
+
+}  // namespace
+
+Entity* Level::MovableUnit(Vector2i from, int player) const {
+  const Tile* start = GetTile(from);
+  if (!start || start->get_owner() != player) return nullptr;
+  Entity* unit = start->entity().get();
+  if (!unit || !unit->is_human_unit() || unit->has_moved()) return nullptr;
+  return unit;
+}
+
+void Level::DescribeTiles(MoveGenerator& generator, int player) const {
+  generator.Reset(grid_, player);
+  for (size_t row = 0; row < tiles_.size(); ++row) {
+    for (size_t column = 0; column < tiles_[row].size(); ++column) {
+      const auto& tile = tiles_[row][column];
+      if (!tile || !Tile::is_sand(tile->type())) continue;
+      DescribeTile(
+          generator,
+          grid_.bit(Vector2i(static_cast<int>(row), static_cast<int>(column))),
+          *tile, /*replace=*/false);
+    }
+  }
+}
+
+Bitset Level::ReachableTiles(Vector2i from) const {
+  auto player = get_current_player();
+  const Entity* unit = player ? MovableUnit(from, player->id()) : nullptr;
+  if (!unit) return Bitset(grid_.bit_count());
+
+  MoveGenerator generator;
+  DescribeTiles(generator, player->id());
+  return generator.Reachable(grid_.bit(from),
+                             AttackOf(unit->type(), unit->level()));
+}
+
+bool Level::CanMoveUnit(Vector2i from, Vector2i to) const {
+  return GetTile(to) && ReachableTiles(from).Test(grid_.bit(to));
+}
+
+bool Level::MoveUnit(Vector2i from, Vector2i to) {
+  const GameCommand command{GameCommand::Type::MoveUnit, from, to};
+  return ApplyActions(std::span(&command, 1));
+}
+
+bool Level::ApplyActions(std::span<const GameCommand> actions) {
+  const bool ends_turn =
+      !actions.empty() && actions.back().type == GameCommand::Type::NextTurn;
+  if (ends_turn) actions = actions.first(actions.size() - 1);
+
+  journal_->BeginAction();
+  BeginActions();
+  bool applied = true;
+  for (const GameCommand& action : actions) {
+    if (!ApplyAction(action)) {
+      applied = false;
+      break;
+    }
+  }
+  EndActions();
+  if (!applied) {
+    journal_->CancelAction(tiles_);
+    // The townhalls captured by the actions undone are theirs again
+    RelinkTownhalls();
+    return false;
+  }
+  journal_->EndAction();
+  if (ends_turn) NextTurn();
+  return true;
+}
+
+void Level::BeginActions() {
+  auto player = get_current_player();
+  actions_player_ = player ? player->id() : -1;
+  buildings_changed_ = false;
+  if (player) DescribeTiles(actions_view_, actions_player_);
+}
+
+void Level::UpdateActionsView(Vector2i position) {
+  DescribeTile(actions_view_, grid_.bit(position),
+               *tiles_[position.x][position.y], /*replace=*/true);
+}
+
+void Level::EndActions() {
+  if (buildings_changed_) FindBuildings();
+  buildings_changed_ = false;
+}
+
+std::shared_ptr<Townhall> Level::FindPayer(const Bitset& region,
+                                           int price) const {
+  auto player = players_.find(actions_player_);
+  if (player == players_.end()) return nullptr;
+  for (const auto& townhall : player->second.townhalls()) {
+    if (townhall->money() >= price &&
+        region.Test(grid_.bit(townhall->grid_position()))) {
+      return townhall;
+    }
+  }
+  return nullptr;
+}
+
+bool Level::ApplyAction(const GameCommand& action) {
+  if (actions_player_ < 0) return false;
+  switch (action.type) {
+    case GameCommand::Type::MoveUnit: {
+      const Entity* moving = MovableUnit(action.tile, actions_player_);
+      if (!moving || !GetTile(action.target)) return false;
+      actions_view_.FindRegion(grid_.bit(action.tile), action_region_);
+      actions_view_.FindReachable(action_region_,
+                                  AttackOf(moving->type(), moving->level()),
+                                  action_reachable_);
+      if (!action_reachable_.Test(grid_.bit(action.target))) return false;
+
+      const auto& start = tiles_[action.tile.x][action.tile.y];
+      const auto& target = tiles_[action.target.x][action.target.y];
+      std::shared_ptr<Entity> unit = start->entity();
+      const std::shared_ptr<Entity> captured = target->entity();
+      if (captured && captured->is_townhall()) {
+        // The player loses the townhall, and its money
+        auto owner = players_.find(target->get_owner().value_or(-1));
+        if (owner != players_.end()) {
+          std::erase(owner->second.townhalls_mutable(), captured);
+        }
+      }
+      buildings_changed_ |= captured && captured->is_building();
+
+      const bool conquered = target->get_owner() != actions_player_;
+      start->set_entity(CreateEntity(Entity::EntityType::Unknown));
+      target->change_owner(actions_player_);
+      target->set_entity(unit);
+      unit->set_moved(true);
+      if (conquered) UpdateWalls(action.target);
+      UpdateActionsView(action.tile);
+      UpdateActionsView(action.target);
+      return true;
+    }
+    case GameCommand::Type::BuyUnit:
+    case GameCommand::Type::BuildCastle: {
+      const Tile* tile = GetTile(action.tile);
+      if (!tile || !Tile::is_sand(tile->type()) ||
+          tile->get_owner() != actions_player_ ||
+          (tile->entity() && !IsFreeEntity(tile->entity()->type()))) {
+        return false;
+      }
+      const bool castle = action.type == GameCommand::Type::BuildCastle;
+      const int price = castle ? kCastlePrice : kUnitPrice;
+      actions_view_.FindRegion(grid_.bit(action.tile), action_region_);
+      const auto townhall = FindPayer(action_region_, price);
+      if (!townhall) return false;
+
+      townhall->set_money(townhall->money() - price);
+      tiles_[action.tile.x][action.tile.y]->set_entity(
+          CreateEntity(castle ? Entity::EntityType::Castle
+                              : Entity::EntityType::HumanUnit));
+      buildings_changed_ |= castle;
+      UpdateActionsView(action.tile);
+      return true;
+    }
+    case GameCommand::Type::MergeUnits: {
+      const Tile* tile = GetTile(action.tile);
+      const Tile* target = GetTile(action.target);
+      if (action.tile == action.target || !tile || !target ||
+          tile->get_owner() != actions_player_ ||
+          target->get_owner() != actions_player_) {
+        return false;
+      }
+      Entity* unit = tile->entity().get();
+      Entity* merged = target->entity().get();
+      if (!unit || !merged || !unit->is_human_unit() ||
+          !merged->is_human_unit() || unit->level() != merged->level() ||
+          merged->level() >= kMaxUnitLevel) {
+        return false;
+      }
+      actions_view_.FindRegion(grid_.bit(action.tile), action_region_);
+      if (!action_region_.Test(grid_.bit(action.target))) return false;
+
+      merged->set_moved(merged->has_moved() || unit->has_moved());
+      merged->setLevel(merged->level() + 1);
+      tiles_[action.tile.x][action.tile.y]->set_entity(
+          CreateEntity(Entity::EntityType::Unknown));
+      UpdateActionsView(action.tile);
+      UpdateActionsView(action.target);
+      return true;
+    }
+    default:
+      // NextTurn may only end a batch, the other commands aren't actions
+      return false;
+  }
+}
+
+const Tile* Level::GetTile(Vector2i grid_position) const {
+  if (grid_position.x < 0 || grid_position.y < 0 ||
+      static_cast<size_t>(grid_position.x) >= tiles_.size() ||
+      static_cast<size_t>(grid_position.y) >=
+          tiles_[grid_position.x].size()) {
+    return nullptr;
+  }
+  return tiles_[grid_position.x][grid_position.y].get();
+}
+
+void Level::ApplyCommand(const GameCommand& command) {
+  switch (command.type) {
+    case GameCommand::Type::NextTurn:
+      NextTurn();
+      break;
+    case GameCommand::Type::SelectTile:
+      // Only the move it may make is an action to undo, see MoveUnit
+      SelectTile(command.tile);
+      break;
+    case GameCommand::Type::MoveUnit:
+    case GameCommand::Type::BuyUnit:
+    case GameCommand::Type::BuildCastle:
+    case GameCommand::Type::MergeUnits:
+      ApplyActions(std::span(&command, 1));
+      break;
+    case GameCommand::Type::Undo:
+      // The selected unit may not be there anymore
+      ClearSelection();
+      if (journal_->Undo(tiles_)) RelinkTownhalls();
+      break;
+    case GameCommand::Type::Redo:
+      ClearSelection();
+      if (journal_->Redo(tiles_)) RelinkTownhalls();
+      break;
+  }
+}
+
+LevelSnapshot Level::TakeSnapshot() const {
+  LevelSnapshot snapshot;
+  snapshot.chunks.assign(journal_->chunks().begin(), journal_->chunks().end());
+  snapshot.columns = journal_->columns();
+  snapshot.turn = turn_;
+  snapshot.current_player = cur_player_idx_;
+  for (size_t i = 0; i < kRandomStreamCount; ++i) {
+    snapshot.random_counters[i] =
+        random_.stream(static_cast<RandomStreamId>(i)).counter();
+  }
+  snapshot.players.reserve(players_.size());
+  for (const auto& [id, player] : players_) {
+    LevelSnapshot::PlayerRecord record{id, player.name(), {}};
+    for (const auto& townhall : player.townhalls()) {
+      record.townhalls.push_back(townhall->grid_position());
+    }
+    snapshot.players.push_back(std::move(record));
+  }
+  return snapshot;
+}
+
+void Level::RestoreSnapshot(const LevelSnapshot& snapshot) {
+  ClearSelection();
+  if (journal_->Restore(snapshot, tiles_)) FindBuildings();
+  journal_->ClearHistory();
+  turn_ = snapshot.turn;
+  cur_player_idx_ = snapshot.current_player;
+  for (size_t i = 0; i < kRandomStreamCount; ++i) {
+    random_.stream(static_cast<RandomStreamId>(i))
+        .set_counter(snapshot.random_counters[i]);
+  }
+  LinkPlayers(snapshot.players);
+  change_bus_->OnReset();
+}
+
+bool Level::LinkPlayers(
+    const std::vector<LevelSnapshot::PlayerRecord>& players) {
+  players_.clear();
+  for (const auto& record : players) {
+    Player player(record.id, record.name);
+    for (const auto& position : record.townhalls) {
+      if (static_cast<size_t>(position.x) >= tiles_.size() ||
+          static_cast<size_t>(position.y) >= tiles_[position.x].size()) {
+        return false;
+      }
+      const auto& tile = tiles_[position.x][position.y];
+      auto townhall = tile ? std::dynamic_pointer_cast<Townhall>(tile->entity())
+                           : nullptr;
+      if (!townhall) return false;
+      player.townhalls_mutable().push_back(std::move(townhall));
+    }
+    players_.emplace(record.id, std::move(player));
+  }
+  return true;
+}
+
+void Level::UpdateWalls(Vector2i position) {
+  for (int wall = -1; wall < 6; ++wall) {
+    const Vector2i neighbor =
+        wall < 0 ? position
+                 : Tile::GetNeighborGridPosition(
+                       position, static_cast<WallPosition>(wall));
+    if (!GetTile(neighbor)) continue;
+    tiles_[neighbor.x][neighbor.y]->set_walls_mask(ComputeWalls(neighbor));
+  }
+}
+
+void Level::UpdateWalls() {
+  for (const auto& row : tiles_) {
+    for (const auto& tile : row) {
+      if (tile) tile->set_walls_mask(ComputeWalls(tile->grid_position()));
+    }
+  }
+}
+
+int Level::ComputeWalls(Vector2i position) const {
+  const auto owner = GetTile(position)->get_owner();
+  if (!owner) return 0;
+  int walls = 0;
+  for (int wall = 0; wall < 6; ++wall) {
+    const Tile* neighbor = GetTile(Tile::GetNeighborGridPosition(
+        position, static_cast<WallPosition>(wall)));
+    if (!neighbor || neighbor->get_owner() != owner) walls |= 1 << wall;
+  }
+  return walls;
+}
+
+void Level::LayOutGrid() {
+  size_t columns = 0;
+  for (const auto& row : tiles_) {
+    columns = std::max(columns, row.size());
+  }
+  grid_ = HexGrid(tiles_.size(), columns);
+}
+
+void Level::ObserveTiles() {
+  for (const auto& row : tiles_) {
+    for (const auto& tile : row) {
+      if (tile) tile->set_observer(observers_.get());
+    }
+  }
+  LayOutGrid();
+  selected_unit_.reset();
+  journal_->Reset(tiles_);
+  hash_->Reset(tiles_);
+  bandit_system_->Reset(grid_, tiles_);
+  influence_map_->Reset(grid_, tiles_);
+  economy_->Reset(grid_, tiles_);
+  change_bus_->OnReset();
+}
+
+void Level::MoveBandits() {
+  TileBoard board(*this);
+  turn_rules_.MoveBandits(board, random_.stream(RandomStreamId::Bandits));
+}
+
+void Level::RelinkTownhalls() {
+  FindBuildings();
+  for (auto& [id, player] : players_) {
+    player.townhalls_mutable().clear();
+  }
+  for (const auto& building : tiles_buildings_) {
+    auto tile = building.lock();
+    auto player = players_.find(tile->get_owner().value_or(-1));
+    if (player != players_.end() && tile->entity()->is_townhall()) {
+      player->second.townhalls_mutable().push_back(
+          std::static_pointer_cast<Townhall>(tile->entity()));
+    }
+  }
+}
+
+void Level::FindBuildings() {
+  tiles_buildings_.clear();
+  for (const auto& row : tiles_) {
+    for (const auto& tile : row) {
+      if (tile && tile->entity() && tile->entity()->is_building()) {
+        tiles_buildings_.push_back(tile);
+      }
+    }
+  }
+}
+
+namespace {
+
+// Bits of the flags written for every tile. Older states also marked with
+// 1 << 1 the tiles reachable by the selected unit, which isn't part of the
+// game, and is now ignored.
+constexpr uint8_t kOrphanFlag = 1 << 0;
+constexpr uint8_t kMovedFlag = 1 << 2;  // Of the entity
+// Written instead of the type of the entity for tiles without one
+constexpr uint8_t kNoEntity = 0xff;
+// Written instead of the type of a tile for empty grid positions
+constexpr uint8_t kNoTile = 0xff;
+
+}  // namespace
+
+void Level::WriteLayout(ByteWriter& writer) const {
+  writer.WriteVarint(map_.size());
+  for (const auto& line : map_) {
+    writer.WriteString(line);
+  }
+  writer.WriteVarint(tiles_.size());
+  for (const auto& row : tiles_) {
+    writer.WriteVarint(row.size());
+    for (const auto& tile : row) {
+      writer.WriteByte(tile ? static_cast<uint8_t>(tile->type()) : kNoTile);
+    }
+  }
+}
+
+bool Level::ReadLayout(ByteReader& reader) {
+  loaded_ = false;
+  map_.clear();
+  tiles_.clear();
+  players_.clear();
+  tiles_buildings_.clear();
+
+  uint64_t line_count;
+  if (!reader.ReadVarint(line_count)) return false;
+  for (uint64_t i = 0; i < line_count; ++i) {
+    std::string line;
+    if (!reader.ReadString(line)) return false;
+    map_.push_back(std::move(line));
+  }
+
+  uint64_t row_count;
+  if (!reader.ReadVarint(row_count)) return false;
+  for (uint64_t i = 0; i < row_count; ++i) {
+    uint64_t column_count;
+    if (!reader.ReadVarint(column_count)) return false;
+    std::vector<std::shared_ptr<Tile>> row;
+    for (uint64_t j = 0; j < column_count; ++j) {
+      uint8_t type;
+      if (!reader.ReadByte(type)) return false;
+      if (type == kNoTile) {
+        row.push_back(nullptr);
+        continue;
+      }
+      if (type > static_cast<uint8_t>(TileType::Sand)) return false;
+      auto tile = std::make_shared<Tile>(static_cast<TileType>(type));
+      tile->set_grid_position({static_cast<int>(i), static_cast<int>(j)});
+      row.push_back(std::move(tile));
+    }
+    tiles_.push_back(std::move(row));
+  }
+  loaded_ = true;
+  return true;
+}
+
+void Level::WriteState(ByteWriter& writer) const {
+  writer.WriteVarint(turn_);
+  writer.WriteVarint(cur_player_idx_);
+  writer.WriteVarint(kRandomStreamCount);
+  for (size_t i = 0; i < kRandomStreamCount; ++i) {
+    writer.WriteVarint(
+        random_.stream(static_cast<RandomStreamId>(i)).counter());
+  }
+
+  writer.WriteVarint(players_.size());
+  for (const auto& [id, player] : players_) {
+    writer.WriteSignedVarint(id);
+    writer.WriteString(player.name());
+    writer.WriteVarint(player.townhalls().size());
+    for (const auto& townhall : player.townhalls()) {
+      writer.WriteVarint(townhall->grid_position().x);
+      writer.WriteVarint(townhall->grid_position().y);
+    }
+  }
+
+  writer.WriteVarint(tiles_.size());
+  for (const auto& row : tiles_) {
+    writer.WriteVarint(row.size());
+    for (const auto& tile : row) {
+      if (!tile) continue;
+      writer.WriteSignedVarint(tile->get_owner().value_or(-1));
+      uint8_t flags = 0;
+      if (tile->is_orphan()) flags |= kOrphanFlag;
+      if (tile->entity() && tile->entity()->has_moved()) flags |= kMovedFlag;
+      writer.WriteByte(flags);
+      writer.WriteSignedVarint(tile->level());
+      uint8_t walls = 0;
+      for (int wall = 0; wall < 6; ++wall) {
+        if (tile->has_wall(static_cast<WallPosition>(wall))) {
+          walls |= 1 << wall;
+        }
+      }
+      writer.WriteByte(walls);
+
+      const auto& entity = tile->entity();
+      if (!entity) {
+        writer.WriteByte(kNoEntity);
+        continue;
+      }
+      writer.WriteByte(static_cast<uint8_t>(entity->type()));
+      writer.WriteSignedVarint(entity->level());
+      writer.WriteSignedVarint(entity->upkeep_cost());
+      if (entity->is_townhall()) {
+        writer.WriteSignedVarint(
+            std::static_pointer_cast<Townhall>(entity)->money());
+      }
+    }
+  }
+}
+
+bool Level::ReadState(ByteReader& reader, size_t stream_count) {
+  uint64_t turn, player_index, state_stream_count;
+  if (stream_count > kRandomStreamCount || !reader.ReadVarint(turn) ||
+      !reader.ReadVarint(player_index) ||
+      !reader.ReadVarint(state_stream_count) ||
+      state_stream_count != stream_count) {
+    return false;
+  }
+  for (size_t i = 0; i < kRandomStreamCount; ++i) {
+    if (i >= stream_count) {
+      random_.stream(static_cast<RandomStreamId>(i)).set_counter(0);
+      continue;
+    }
+    uint64_t counter;
+    if (!reader.ReadVarint(counter)) return false;
+    random_.stream(static_cast<RandomStreamId>(i)).set_counter(counter);
+  }
+  turn_ = static_cast<uint32_t>(turn);
+  cur_player_idx_ = player_index;
+
+  // The townhalls of the players are linked once the entities are restored
+  uint64_t player_count;
+  if (!reader.ReadVarint(player_count)) return false;
+  std::vector<LevelSnapshot::PlayerRecord> players;
+  for (uint64_t i = 0; i < player_count; ++i) {
+    LevelSnapshot::PlayerRecord player;
+    int64_t id;
+    uint64_t townhall_count;
+    if (!reader.ReadSignedVarint(id) || id < 0 ||
+        static_cast<uint64_t>(id) >= kMaxPlayers ||
+        !reader.ReadString(player.name) || !reader.ReadVarint(townhall_count)) {
+      return false;
+    }
+    player.id = static_cast<int>(id);
+    for (uint64_t j = 0; j < townhall_count; ++j) {
+      uint64_t row, col;
+      if (!reader.ReadVarint(row) || !reader.ReadVarint(col)) return false;
+      player.townhalls.push_back(
+          {static_cast<int>(row), static_cast<int>(col)});
+    }
+    players.push_back(std::move(player));
+  }
+
+  uint64_t row_count;
+  if (!reader.ReadVarint(row_count) || row_count != tiles_.size()) {
+    return false;
+  }
+  for (auto& row : tiles_) {
+    uint64_t column_count;
+    if (!reader.ReadVarint(column_count) || column_count != row.size()) {
+      return false;
+    }
+    for (auto& tile : row) {
+      if (!tile) continue;
+      int64_t owner, level;
+      uint8_t flags, walls, entity_type;
+      if (!reader.ReadSignedVarint(owner) ||
+          owner >= static_cast<int64_t>(kMaxPlayers) ||
+          !reader.ReadByte(flags) || !reader.ReadSignedVarint(level) ||
+          !reader.ReadByte(walls) || !reader.ReadByte(entity_type)) {
+        return false;
+      }
+      if (owner < 0) {
+        tile->remove_owner();
+      } else {
+        tile->change_owner(static_cast<int>(owner));
+      }
+      if (flags & kOrphanFlag) {
+        tile->orphan();
+      } else {
+        tile->claim();
+      }
+      // No unit is selected once the state is restored (see ObserveTiles)
+      tile->set_reachability(false);
+      tile->set_level(static_cast<int>(level));
+      for (int wall = 0; wall < 6; ++wall) {
+        if (walls & (1 << wall)) {
+          tile->add_wall(static_cast<WallPosition>(wall));
+        } else {
+          tile->remove_wall(static_cast<WallPosition>(wall));
+        }
+      }
+
+      if (entity_type == kNoEntity) {
+        // Land always holds an entity, the placeholder of CreateTiles if
+        // none, which the rules (e.g. UpdateMoney) expect
+        tile->set_entity(Tile::is_decoration(tile->type())
+                             ? nullptr
+                             : CreateEntity(Entity::EntityType::Unknown));
+        continue;
+      }
+      if (entity_type >= Entity::kEntityTypeCount) return false;
+      int64_t entity_level, upkeep_cost, money = 0;
+      if (!reader.ReadSignedVarint(entity_level) ||
+          !reader.ReadSignedVarint(upkeep_cost)) {
+        return false;
+      }
+      const auto type = static_cast<Entity::EntityType>(entity_type);
+      if (type == Entity::EntityType::Townhall &&
+          !reader.ReadSignedVarint(money)) {
+        return false;
+      }
+      std::unique_ptr<Entity> entity = CreateEntity(type);
+      if (type == Entity::EntityType::Townhall) {
+        static_cast<Townhall&>(*entity).restore_money(static_cast<int>(money));
+      }
+      entity->setLevel(static_cast<int>(entity_level));
+      entity->set_upkeep_cost(static_cast<int>(upkeep_cost));
+      entity->set_moved(flags & kMovedFlag);
+      tile->set_entity(std::move(entity));
+    }
+  }
+
+  FindBuildings();
+  if (!LinkPlayers(players)) return false;
+  // The walls follow from the owners, states saved before they were set
+  // have none
+  UpdateWalls();
+  ObserveTiles();
+  return true;
 }
 
 const bool Level::CheckEnd() {
@@ -14,11 +14,26 @@
 #include <filesystem>
 #include <map>
 #include <memory>
+#include <optional>
+#include <span>
 #include <string>
 #include <vector>
 
+#include "core/bitset.h"
+#include "core/byte_stream.h"
+#include "core/job_system.h"
+#include "core/random.h"
+#include "rendering/game_command.h"
+#include "rendering/state_journal.h"
+#include "rendering/zobrist_hash.h"
+#include "world/bandit_system.h"
+#include "world/change_bus.h"
+#include "world/economy.h"
+#include "world/influence_map.h"
+#include "world/move_generator.h"
 #include "world/player.h"
 #include "world/tile.h"
+#include "world/turn_rules.h"
 
 namespace konkr {
 
@@ -34,20 +49,17 @@ class Level {
   Level(Level&&) = default;
   Level& operator=(Level&&) = default;
 
-  // Creates Level objects for all levels found in the specified directory.
-  // The directory should contain subdirectories for each category, and each
-  // level file should have a ".level" extension.
-  // The level name is derived from the file name, and the category is derived
-  // from the directory name.
-  // It doesn't load the contents of the level files, just prepares the Level
-  // objects.
-  static std::vector<std::shared_ptr<Level>> GetAvailableLevels(
-      const std::filesystem::path& levels_directory);
-
   Level(std::string name, std::string category, std::filesystem::path file_path)
       : name_(std::move(name)),
         category_(std::move(category)),
-        file_path_(std::move(file_path)) {}
+        file_path_(std::move(file_path)) {
+    observers_->Add(journal_.get());
+    observers_->Add(hash_.get());
+    observers_->Add(change_bus_.get());
+    observers_->Add(bandit_system_.get());
+    observers_->Add(influence_map_.get());
+    observers_->Add(economy_.get());
+  }
 
   // Loads the level from the file_path_ if not already loaded
   bool Load();
@@ -58,6 +70,22 @@ class Level {
   inline const std::vector<std::string>& map() const { return map_; }
   inline bool is_loaded() const { return loaded_; }
 
+  // Every random decision of the game is drawn from the streams of random(),
+  // so the same seed and the same commands give the same game. A level gets
+  // a new seed when created, set_seed replaces it before Load (or before
+  // CreateTiles, to restart the game).
+  inline uint64_t seed() const { return random_.seed(); }
+  inline void set_seed(uint64_t seed) { random_.Reseed(seed); }
+  inline GameRandom& random() { return random_; }
+  inline const GameRandom& random() const { return random_; }
+
+  // Runs the parallel parts of the turns (see UpdateActivePlayers), the
+  // shared JobSystem unless set. nullptr runs them on the calling thread,
+  // for the tools playing a game per thread.
+  inline void set_job_system(JobSystem* job_system) {
+    job_system_ = job_system;
+  }
+
   void DisplayMapAscii() const;
 
   void CreateTiles();
@@ -70,7 +98,15 @@ class Level {
     return players_;
   }
 
-  inline size_t active_players_count() { return active_players().size(); }
+  inline size_t active_players_count() const {
+    return active_players().size();
+  }
+
+  // Index of the current player in active_players()
+  inline size_t current_player_index() const { return cur_player_idx_; }
+
+  // Number of NextTurn since the tiles were created
+  inline uint32_t turn() const { return turn_; }
 
   inline std::shared_ptr<Player> get_current_player() const {
     if (players_.empty() || cur_player_idx_ >= players_.size()) return nullptr;
@@ -91,17 +127,167 @@ class Level {
 
   void UpdateActivePlayers();
 
+  // Adds the income of the townhalls of the current player to their money,
+  // turning the units of bankrupt regions into bandits, from the regions
+  // labelled by the last UpdateTilesLevel (see TurnRules)
   void UpdateMoney();
 
   // @brief Updates the level of the tiles based on the players' townhalls.
-  // also updates what tiles the players own
+  // also updates what tiles the players own. The regions of the buildings
+  // are labelled in a single pass (see RegionLabels).
   void UpdateTilesLevel();
 
   /**
-    @brief Goes to the next turn.
+    @brief Goes to the next turn, after moving every bandit to a random free
+    tile next to it, of the same owner (see BanditSystem).
   */
   void NextTurn();
 
+  /**
+    @brief Handles a click of the current player on a tile: on a tile the
+    selected unit can reach, moves the unit there. Otherwise, if the tile
+    holds one of its units that can move, selects it and marks the tiles it
+    can reach (see Tile::is_reachable), clearing the previous marks.
+    @param grid_position Position of the tile in the grid.
+  */
+  void SelectTile(Vector2i grid_position);
+
+  // Unit selected by SelectTile, whose reachable tiles are marked
+  inline const std::optional<Vector2i>& selected_unit() const {
+    return selected_unit_;
+  }
+
+  // Layout of the tiles in the bitsets of ReachableTiles
+  inline const HexGrid& grid() const { return grid_; }
+
+  /**
+    @brief Every tile the unit of the current player at from can move to,
+    found in one pass by a MoveGenerator. Empty if there is no unit of the
+    current player at from, or if it already moved.
+  */
+  Bitset ReachableTiles(Vector2i from) const;
+
+  /**
+    @brief Whether the unit of the current player at from can move to to:
+    to an empty tile of its region, or to a tile bordering its region that it
+    captures, if its attack is greater than the defense of the tile (see
+    world/rules.h). A unit moves once per turn. See ReachableTiles to find
+    every move of a unit at once.
+  */
+  bool CanMoveUnit(Vector2i from, Vector2i to) const;
+
+  /**
+    @brief Moves the unit at from to to if CanMoveUnit. A unit moving to a
+    tile of another player captures it, destroying the entity on it. The
+    move is an action of its own (see ApplyActions).
+    @returns false if the move isn't allowed.
+  */
+  bool MoveUnit(Vector2i from, Vector2i to);
+
+  /**
+    @brief Applies the actions of the current player (see
+    GameCommand::is_action), which may be followed by a NextTurn, all or
+    none: each action is checked against the state the actions before it
+    leave, and if one isn't allowed the tiles are restored as they were.
+    - MoveUnit: see MoveUnit.
+    - BuyUnit, BuildCastle: places a villager or a castle on a free tile of
+      the player, paid by a townhall of its region (see world/rules.h).
+    - MergeUnits: merges two units of the same level, below a hero, of the
+      same region into a unit of the next level at target, which can only
+      move if neither of them did.
+    The tiles are described to a MoveGenerator once for the whole batch,
+    then only the tiles an action changes again. The buildings are found
+    once at the end, and the updates of the end of a turn (income, money,
+    eliminations) only run for the NextTurn. The batch is undone as one.
+    @returns false if an action isn't allowed.
+  */
+  bool ApplyActions(std::span<const GameCommand> actions);
+
+  // nullptr outside the grid and for empty positions
+  const Tile* GetTile(Vector2i grid_position) const;
+
+  // Applies a command of the current player, an action being a batch of one
+  // (see ApplyActions). The commands of a turn can be undone and redone
+  // (GameCommand::Undo and Redo) until the NextTurn.
+  void ApplyCommand(const GameCommand& command);
+
+  // Zobrist hash of the state of the game (see ZobristHash) and of the
+  // current player, equal for equal states. Kept up to date as the tiles
+  // change, so reading it is O(1).
+  inline uint64_t hash() const {
+    return hash_->value() ^ ZobristHash::CurrentPlayerKey(cur_player_idx_);
+  }
+
+  // Events of the changes of the tiles, of their entities and of the
+  // players, for the subscribers that update what they derive from the game
+  // as it changes rather than reading it all again
+  inline ChangeBus& change_bus() { return *change_bus_; }
+
+  // Threat and defense of every tile, indexed by the bits of grid(), kept up
+  // to date as the tiles change, for the evaluations that read them often
+  inline const InfluenceMap& influence_map() const { return *influence_map_; }
+
+  // Brings economy() up to date with the changes of the tiles since the
+  // last call, does nothing if none changed them
+  inline void UpdateEconomy() { economy_->Update(); }
+
+  // Income, money and forecast of every townhall as of the last
+  // UpdateEconomy (or load), for the panels and the evaluations that would
+  // otherwise search the regions
+  inline const Economy& economy() const { return *economy_; }
+
+  inline bool can_undo() const { return journal_->can_undo(); }
+  inline bool can_redo() const { return journal_->can_redo(); }
+
+  /**
+    @brief Takes a snapshot of the state of the game, which shares the tiles
+    of the level until they change, so taking one is cheap enough to do
+    every frame or every turn.
+  */
+  LevelSnapshot TakeSnapshot() const;
+
+  /**
+    @brief Restores a snapshot taken on this level since its tiles were
+    created. Only the chunks of tiles changed since are set again. Forgets
+    the actions that could be undone.
+  */
+  void RestoreSnapshot(const LevelSnapshot& snapshot);
+
+  /**
+    @brief Writes the map of the level: its ASCII representation and the
+    type of every tile, which don't change during a game.
+    @param writer Where the layout is appended.
+  */
+  void WriteLayout(ByteWriter& writer) const;
+
+  /**
+    @brief Creates the tiles from a layout written by WriteLayout, without
+    entities nor owners: a state read by ReadState completes them. Unlike
+    Load, the map isn't parsed nor the regions computed.
+    @returns false if the layout is malformed.
+  */
+  bool ReadLayout(ByteReader& reader);
+
+  /**
+    @brief Writes what changes during a game (the tiles' owners and entities,
+    the players, the turn, the random streams) but not the map itself, nor
+    the selection of the player.
+    @param writer Where the state is appended.
+  */
+  void WriteState(ByteWriter& writer) const;
+
+  /**
+    @brief Restores a state written by WriteState on a level created from the
+    same map.
+    @param stream_count Number of random streams the state must hold, fewer
+    than kRandomStreamCount for a state written before the streams after
+    them were added, which then start from the beginning.
+    @returns false if the state is malformed or from another map, in which
+    case the level is left partially restored.
+  */
+  bool ReadState(ByteReader& reader,
+                 size_t stream_count = kRandomStreamCount);
+
   /**
     @brief Checks if the game is over.
     @returns true if the game is over (only one player remaining), false
@@ -110,6 +296,68 @@ class Level {
   const bool CheckEnd();
 
  private:
+  class TileBoard;
+
+  // Rows of tiles scanned by each job of UpdateActivePlayers
+  static constexpr size_t kRowsPerJob = 8;
+
+  // Tiles of the region of start_tile, as GetConnectedOwnedTiles, without
+  // claiming them
+  std::vector<std::shared_ptr<Tile>> CollectConnectedOwnedTiles(
+      const std::shared_ptr<Tile>& start_tile) const;
+
+  // Links the players to the townhalls at their positions, returns false if
+  // a position holds none
+  bool LinkPlayers(const std::vector<LevelSnapshot::PlayerRecord>& players);
+
+  // Collects the tiles holding buildings in tiles_buildings_
+  void FindBuildings();
+
+  // Gives each player the townhalls on its tiles, after the journal changed
+  // the buildings
+  void RelinkTownhalls();
+
+  // Sets the walls of the tile at position and of its neighbors, after its
+  // owner changed: an owned tile has a wall on each side facing a tile of
+  // another owner, or no tile, so the walls outline the territories
+  void UpdateWalls(Vector2i position);
+  // Sets the walls of every tile
+  void UpdateWalls();
+  // Walls of the tile at position, as a Tile::walls_mask
+  int ComputeWalls(Vector2i position) const;
+
+  // Moves the bandits, drawing their tiles from the Bandits random stream
+  void MoveBandits();
+
+  // Lays the tiles out in grid_
+  void LayOutGrid();
+  // Makes observers_ follow the changes of the tiles, from their current
+  // state, and lays them out in grid_
+  void ObserveTiles();
+
+  // Forgets the selected unit and the tiles marked reachable from it
+  void ClearSelection();
+
+  // The unit of player at from if it can still move this turn
+  Entity* MovableUnit(Vector2i from, int player) const;
+
+  // Describes the land tiles to generator, for the moves of player
+  void DescribeTiles(MoveGenerator& generator, int player) const;
+
+  // Starts a batch of actions of the current player by describing the tiles
+  // to actions_view_
+  void BeginActions();
+  // Checks an action against actions_view_ and applies it, returns false if
+  // it isn't allowed (and then changes nothing)
+  bool ApplyAction(const GameCommand& action);
+  // Describes the tile at position to actions_view_ again, after an action
+  // changed it
+  void UpdateActionsView(Vector2i position);
+  // Finds the buildings again if the actions of the batch changed them
+  void EndActions();
+  // Townhall of the player of the batch in region with at least price money
+  std::shared_ptr<Townhall> FindPayer(const Bitset& region, int price) const;
+
   std::string name_;
   std::string category_;
   std::filesystem::path file_path_;
@@ -118,7 +366,37 @@ class Level {
   std::vector<std::weak_ptr<Tile>> tiles_buildings_;
   std::map<int, Player> players_;
   size_t cur_player_idx_ = 0;  // Current index in players_
+  uint32_t turn_ = 0;
+  HexGrid grid_;
+  // The rules of the ends of turns, shared with CompactState, which keep the
+  // regions of the last UpdateTilesLevel
+  TurnRules turn_rules_;
+  // Unit whose reachable tiles are marked, until the marks are cleared or
+  // the journal changes the tiles
+  std::optional<Vector2i> selected_unit_;
+  // The tiles as left by the actions of the batch being applied (see
+  // ApplyActions), for the player of the batch
+  MoveGenerator actions_view_;
+  int actions_player_ = -1;
+  Bitset action_region_;
+  Bitset action_reachable_;
+  bool buildings_changed_ = false;
+  GameRandom random_{NewGameSeed()};
+  JobSystem* job_system_ = &JobSystem::GetInstance();
   bool loaded_ = false;
+  // On the heap, as the tiles keep pointers to them when the level moves
+  std::unique_ptr<StateJournal> journal_ = std::make_unique<StateJournal>();
+  std::unique_ptr<ZobristHash> hash_ = std::make_unique<ZobristHash>();
+  std::unique_ptr<ChangeBus> change_bus_ = std::make_unique<ChangeBus>();
+  std::unique_ptr<BanditSystem> bandit_system_ =
+      std::make_unique<BanditSystem>();
+  std::unique_ptr<InfluenceMap> influence_map_ =
+      std::make_unique<InfluenceMap>();
+  std::unique_ptr<Economy> economy_ = std::make_unique<Economy>();
+  // Notifies journal_, hash_, change_bus_, bandit_system_, influence_map_ and
+  // economy_, observes every tile
+  std::unique_ptr<TileObserverList> observers_ =
+      std::make_unique<TileObserverList>();
 };
 
 }  // namespace konkr
@@ -0,0 +1,273 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+
+#include "rendering/level_catalog.h"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <system_error>
+
+#include "world/tile.h"
+
+namespace konkr {
+
+namespace {
+
+constexpr const char* kManifestHeader = "konkr-level-catalog 1";
+
+// Level names are in snake_case, we want to display them in a more
+// human-readable format. Replaces underscores with spaces and capitalizes the
+// first letter.
+std::string FormatLevelNameForDisplay(std::string name) {
+  std::replace(name.begin(), name.end(), '_', ' ');
+  name[0] = std::toupper(name[0]);
+  return name;
+}
+
+std::string FormatCategoryForDisplay(std::string category) {
+  category[0] = std::toupper(category[0]);
+  return category;
+}
+
+int64_t LastWriteTime(const std::filesystem::path& path) {
+  std::error_code ec;
+  auto time = std::filesystem::last_write_time(path, ec);
+  return ec ? 0 : static_cast<int64_t>(time.time_since_epoch().count());
+}
+
+// Fills the fields of info that are derived from its path.
+void SetDisplayNames(LevelInfo& info) {
+  info.name = FormatLevelNameForDisplay(info.file_path.stem().string());
+  info.category = FormatCategoryForDisplay(
+      info.file_path.parent_path().filename().string());
+}
+
+}  // namespace
+
+std::shared_ptr<Level> LevelCatalog::CreateLevel(const LevelInfo& info) {
+  return std::make_shared<Level>(info.name, info.category, info.file_path);
+}
+
+bool LevelCatalog::ReadLevelMetadata(const std::filesystem::path& file_path,
+                                     LevelInfo& info) {
+  std::ifstream definition_stream(file_path);
+  if (!definition_stream.is_open()) {
+    std::cerr << "Failed to open level file: " << file_path << std::endl;
+    return false;
+  }
+
+  std::array<bool, 10> has_townhall = {false};
+  int rows = 0;
+  int columns = 0;
+  std::string line;
+  // Same tokenization as Level::CreateTiles, without building the tiles
+  while (std::getline(definition_stream, line)) {
+    int row_columns = 0;
+    size_t col = (!line.empty() && line[0] == '|') ? 1 : 0;
+    while (col < line.size()) {
+      char c = line[col];
+      if (Tile::is_decoration(c)) {
+        ++row_columns;
+        ++col;
+      } else if (col + 1 < line.size() && std::isdigit(line[col + 1])) {
+        if (Entity::is_townhall(c)) {
+          has_townhall[line[col + 1] - '0'] = true;
+        }
+        ++row_columns;
+        col += 2;
+      } else {
+        ++col;
+      }
+    }
+    columns = std::max(columns, row_columns);
+    ++rows;
+  }
+
+  info.rows = rows;
+  info.columns = columns;
+  info.player_count = static_cast<int>(
+      std::count(has_townhall.begin(), has_townhall.end(), true));
+  return rows > 0;
+}
+
+bool LevelCatalog::Refresh(bool full_scan) {
+  if (!manifest_loaded_) {
+    manifest_loaded_ = true;
+    LoadManifest();
+  }
+
+  std::error_code ec;
+  if (!std::filesystem::is_directory(levels_directory_, ec)) {
+    std::cerr << "Levels directory not found: " << levels_directory_
+              << std::endl;
+    levels_.clear();
+    directories_.clear();
+    return false;
+  }
+
+  // Previous entries, grouped by the directory they live in
+  std::multimap<std::filesystem::path, const LevelInfo*> previous;
+  for (const auto& info : levels_) {
+    previous.emplace(info.file_path.parent_path(), &info);
+  }
+
+  std::vector<LevelInfo> levels;
+  std::map<std::filesystem::path, int64_t> directories;
+  levels.reserve(levels_.size());
+  ScanDirectory(levels_directory_, full_scan, previous, levels, directories);
+
+  std::sort(levels.begin(), levels.end(),
+            [](const LevelInfo& a, const LevelInfo& b) {
+              if (a.category != b.category) return a.category < b.category;
+              return a.name < b.name;
+            });
+
+  if (levels.size() != levels_.size() || directories != directories_) {
+    dirty_ = true;
+  }
+  levels_ = std::move(levels);
+  directories_ = std::move(directories);
+
+  if (dirty_ && SaveManifest()) {
+    dirty_ = false;
+  }
+  return true;
+}
+
+void LevelCatalog::ScanDirectory(
+    const std::filesystem::path& directory, bool full_scan,
+    const std::multimap<std::filesystem::path, const LevelInfo*>& previous,
+    std::vector<LevelInfo>& levels,
+    std::map<std::filesystem::path, int64_t>& directories) {
+  const int64_t mtime = LastWriteTime(directory);
+  directories[directory] = mtime;
+
+  auto known = directories_.find(directory);
+  if (!full_scan && known != directories_.end() && known->second == mtime) {
+    // Nothing was added to or removed from the directory since the last scan
+    auto [first, last] = previous.equal_range(directory);
+    for (auto it = first; it != last; ++it) {
+      levels.push_back(*it->second);
+    }
+    for (const auto& [path, path_mtime] : directories_) {
+      if (path.parent_path() == directory && path != directory) {
+        ScanDirectory(path, full_scan, previous, levels, directories);
+      }
+    }
+    return;
+  }
+
+  std::error_code ec;
+  for (const auto& entry :
+       std::filesystem::directory_iterator(directory, ec)) {
+    if (entry.is_directory(ec)) {
+      ScanDirectory(entry.path(), full_scan, previous, levels, directories);
+      continue;
+    }
+    if (!entry.is_regular_file(ec) || entry.path().extension() != ".level") {
+      continue;
+    }
+
+    LevelInfo info;
+    info.file_path = entry.path();
+    info.mtime = LastWriteTime(entry.path());
+    info.size = entry.file_size(ec);
+
+    auto [first, last] = previous.equal_range(directory);
+    auto cached = std::find_if(first, last, [&info](const auto& p) {
+      return p.second->file_path == info.file_path;
+    });
+    if (cached != last && cached->second->mtime == info.mtime &&
+        cached->second->size == info.size) {
+      levels.push_back(*cached->second);
+      continue;
+    }
+
+    SetDisplayNames(info);
+    if (ReadLevelMetadata(info.file_path, info)) {
+      levels.push_back(std::move(info));
+      dirty_ = true;
+    }
+  }
+  if (ec) {
+    std::cerr << "Failed to list levels directory: " << directory << " ("
+              << ec.message() << ")" << std::endl;
+  }
+}
+
+bool LevelCatalog::LoadManifest() {
+  std::ifstream manifest_stream(manifest_path_);
+  if (!manifest_stream.is_open()) {
+    return false;
+  }
+
+  std::string line;
+  if (!std::getline(manifest_stream, line) || line != kManifestHeader) {
+    std::cerr << "Ignoring outdated level manifest: " << manifest_path_
+              << std::endl;
+    return false;
+  }
+
+  levels_.clear();
+  directories_.clear();
+  while (std::getline(manifest_stream, line)) {
+    std::istringstream fields(line);
+    char kind = 0;
+    std::string path;
+    if (!(fields >> kind)) continue;
+
+    if (kind == 'D') {
+      int64_t mtime = 0;
+      if (fields >> mtime && fields.get() == ' ' && std::getline(fields, path))
+        directories_[path] = mtime;
+    } else if (kind == 'L') {
+      LevelInfo info;
+      if (fields >> info.mtime >> info.size >> info.rows >> info.columns >>
+              info.player_count &&
+          fields.get() == ' ' && std::getline(fields, path)) {
+        info.file_path = path;
+        SetDisplayNames(info);
+        levels_.push_back(std::move(info));
+      }
+    }
+  }
+  return true;
+}
+
+bool LevelCatalog::SaveManifest() const {
+  // Written to a temporary file first, so that a crash never leaves a
+  // truncated manifest behind
+  std::filesystem::path temporary_path = manifest_path_;
+  temporary_path += ".tmp";
+  {
+    std::ofstream manifest_stream(temporary_path, std::ios::trunc);
+    if (!manifest_stream.is_open()) {
+      std::cerr << "Failed to write level manifest: " << manifest_path_
+                << std::endl;
+      return false;
+    }
+
+    manifest_stream << kManifestHeader << '\n';
+    for (const auto& [path, mtime] : directories_) {
+      manifest_stream << "D " << mtime << ' ' << path.string() << '\n';
+    }
+    for (const auto& info : levels_) {
+      manifest_stream << "L " << info.mtime << ' ' << info.size << ' '
+                      << info.rows << ' ' << info.columns << ' '
+                      << info.player_count << ' ' << info.file_path.string()
+                      << '\n';
+    }
+    if (!manifest_stream) return false;
+  }
+
+  std::error_code ec;
+  std::filesystem::rename(temporary_path, manifest_path_, ec);
+  return !ec;
+}
+
+}  // namespace konkr
@@ -0,0 +1,89 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+//
+// level_catalog.h
+//
+// Declares the LevelCatalog class, which keeps a persistent manifest of the
+// levels available on disk so that the level selection screen can list them
+// without walking the whole directory tree or opening the level files.
+//
+
+#ifndef KONKR_RENDERING_LEVEL_CATALOG_H
+#define KONKR_RENDERING_LEVEL_CATALOG_H
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rendering/level.h"
+
+namespace konkr {
+
+// Metadata of a level file, as stored in the catalog manifest.
+struct LevelInfo {
+  std::filesystem::path file_path;
+  int64_t mtime = 0;  // Last write time of the file, in file clock ticks
+  uintmax_t size = 0;
+  std::string name;      // Display name, derived from the file name
+  std::string category;  // Display category, derived from the directory name
+  int rows = 0;
+  int columns = 0;  // Number of tiles of the widest row
+  int player_count = 0;
+};
+
+// Keeps an index of the ".level" files found under a levels directory.
+// The index is saved to a manifest file and refreshed incrementally: a
+// directory is only listed again when its mtime changed, and a level file is
+// only parsed again when its mtime or size changed.
+class LevelCatalog {
+ public:
+  LevelCatalog(std::filesystem::path levels_directory,
+               std::filesystem::path manifest_path)
+      : levels_directory_(std::move(levels_directory)),
+        manifest_path_(std::move(manifest_path)) {}
+
+  // Brings the index up to date with the levels directory, loading the
+  // manifest first if this is the first refresh.
+  // With full_scan, every level file is checked, which also picks up files
+  // that were edited in place without touching their directory.
+  // Returns false if the levels directory couldn't be read.
+  bool Refresh(bool full_scan = false);
+
+  // Levels sorted by category, then by name.
+  inline const std::vector<LevelInfo>& levels() const { return levels_; }
+
+  // Creates a Level for the given entry. The level is not loaded.
+  static std::shared_ptr<Level> CreateLevel(const LevelInfo& info);
+
+  // Reads the dimensions and the number of players of a level file.
+  static bool ReadLevelMetadata(const std::filesystem::path& file_path,
+                                LevelInfo& info);
+
+ private:
+  bool LoadManifest();
+  bool SaveManifest() const;
+
+  // Adds the levels found in directory (and its subdirectories) to levels,
+  // reusing the entries of the previous index when they are still valid.
+  void ScanDirectory(
+      const std::filesystem::path& directory, bool full_scan,
+      const std::multimap<std::filesystem::path, const LevelInfo*>& previous,
+      std::vector<LevelInfo>& levels,
+      std::map<std::filesystem::path, int64_t>& directories);
+
+  std::filesystem::path levels_directory_;
+  std::filesystem::path manifest_path_;
+  std::vector<LevelInfo> levels_;
+  // Last seen mtime of every directory of the tree
+  std::map<std::filesystem::path, int64_t> directories_;
+  bool manifest_loaded_ = false;
+  bool dirty_ = false;
+};
+
+}  // namespace konkr
+
+#endif  // KONKR_RENDERING_LEVEL_CATALOG_H
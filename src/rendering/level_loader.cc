@@ -0,0 +1,133 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+
+#include "rendering/level_loader.h"
+
+#include <algorithm>
+#include <iostream>
+#include <utility>
+
+namespace konkr {
+
+LevelLoader::LevelLoader() = default;
+
+LevelLoader::~LevelLoader() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  // Levels being loaded are finished, the queued ones are skipped
+  tasks_.Wait();
+}
+
+void LevelLoader::Request(const LevelInfo& info) {
+  const auto& file_path = info.file_path;
+  if (requested_paths_.contains(file_path)) return;
+
+  auto preloaded = std::find_if(
+      preloaded_.begin(), preloaded_.end(),
+      [&file_path](const LoadedLevel& l) { return l.file_path == file_path; });
+  if (preloaded != preloaded_.end()) {
+    ready_.push_back(std::move(*preloaded));
+    preloaded_.erase(preloaded);
+    return;
+  }
+
+  requested_paths_.insert(file_path);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto queued =
+        std::find_if(jobs_.begin(), jobs_.end(), [&file_path](const Job& job) {
+          return job.info.file_path == file_path;
+        });
+    if (queued != jobs_.end()) {
+      jobs_.erase(queued);
+    } else if (preloading_paths_.contains(file_path)) {
+      // Already being loaded by a job, the result is routed to the
+      // requested levels by TakeCompleted
+      return;
+    }
+    jobs_.push_front(Job{info, true});
+  }
+  tasks_.Run([this] { RunNextJob(); });
+}
+
+void LevelLoader::Preload(const LevelInfo& info) {
+  const auto& file_path = info.file_path;
+  if (requested_paths_.contains(file_path) ||
+      preloading_paths_.contains(file_path) ||
+      std::any_of(preloaded_.begin(), preloaded_.end(),
+                  [&file_path](const LoadedLevel& l) {
+                    return l.file_path == file_path;
+                  })) {
+    return;
+  }
+
+  preloading_paths_.insert(file_path);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    jobs_.push_back(Job{info, false});
+
+    // The cursor moved on, drop the oldest preloads that didn't start yet
+    size_t preload_jobs =
+        std::count_if(jobs_.begin(), jobs_.end(),
+                      [](const Job& job) { return !job.requested; });
+    for (auto it = jobs_.begin();
+         it != jobs_.end() && preload_jobs > kMaxPreloadedLevels;) {
+      if (!it->requested) {
+        preloading_paths_.erase(it->info.file_path);
+        it = jobs_.erase(it);
+        --preload_jobs;
+      } else {
+        ++it;
+      }
+    }
+  }
+  tasks_.Run([this] { RunNextJob(); });
+}
+
+std::vector<LoadedLevel> LevelLoader::TakeCompleted() {
+  std::vector<LoadedLevel> completed;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    completed.swap(completed_);
+  }
+
+  std::vector<LoadedLevel> requested = std::move(ready_);
+  ready_.clear();
+  for (auto& loaded : completed) {
+    preloading_paths_.erase(loaded.file_path);
+    if (requested_paths_.erase(loaded.file_path)) {
+      requested.push_back(std::move(loaded));
+    } else if (loaded.level) {
+      preloaded_.push_back(std::move(loaded));
+      if (preloaded_.size() > kMaxPreloadedLevels) {
+        preloaded_.pop_front();
+      }
+    }
+  }
+  return requested;
+}
+
+void LevelLoader::RunNextJob() {
+  Job job;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // The job may have been dropped, or loaded by an earlier call
+    if (stopping_ || jobs_.empty()) return;
+    job = std::move(jobs_.front());
+    jobs_.pop_front();
+  }
+
+  std::shared_ptr<Level> level = LevelCatalog::CreateLevel(job.info);
+  if (!level->Load()) {
+    std::cerr << "Failed to load level: " << job.info.file_path << std::endl;
+    level = nullptr;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  completed_.push_back(LoadedLevel{job.info.file_path, std::move(level)});
+}
+
+}  // namespace konkr
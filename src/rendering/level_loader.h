@@ -0,0 +1,93 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+//
+// level_loader.h
+//
+// Declares the LevelLoader class, which loads levels on the JobSystem and
+// hands the loaded levels back to the UI thread through a completion queue.
+//
+
+#ifndef KONKR_RENDERING_LEVEL_LOADER_H
+#define KONKR_RENDERING_LEVEL_LOADER_H
+
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+
+#include "core/job_system.h"
+#include "rendering/level.h"
+#include "rendering/level_catalog.h"
+
+namespace konkr {
+
+// A level that finished loading. level is nullptr if the loading failed.
+struct LoadedLevel {
+  std::filesystem::path file_path;
+  std::shared_ptr<Level> level;
+};
+
+// Loads levels (parsing and tile creation) on the workers of the JobSystem,
+// several at a time. Requested levels are loaded before preloaded ones, and
+// preloaded levels are kept until they are requested, so that selecting a
+// level next to the one under the cursor is instant.
+// All the methods must be called from the same (UI) thread.
+class LevelLoader {
+ public:
+  LevelLoader();
+  ~LevelLoader();
+
+  LevelLoader(const LevelLoader&) = delete;
+  LevelLoader& operator=(const LevelLoader&) = delete;
+
+  // Queues the level ahead of every preload. The loaded level is returned by
+  // a later call to TakeCompleted.
+  void Request(const LevelInfo& info);
+
+  // Queues the level behind the other jobs, and keeps it once loaded until
+  // it is requested. Only the most recent preloads are kept.
+  void Preload(const LevelInfo& info);
+
+  // Returns the requested levels that finished loading since the last call.
+  std::vector<LoadedLevel> TakeCompleted();
+
+  inline bool is_requested(const std::filesystem::path& file_path) const {
+    return requested_paths_.contains(file_path);
+  }
+
+ private:
+  struct Job {
+    LevelInfo info;
+    bool requested;
+  };
+
+  // Runs on the JobSystem: loads the job at the front of the queue, if any.
+  // One is submitted for every job queued.
+  void RunNextJob();
+
+  // Maximum number of preloaded levels waiting to be requested, and of
+  // preload jobs waiting to be run
+  static constexpr size_t kMaxPreloadedLevels = 8;
+
+  // Shared with the jobs
+  std::mutex mutex_;
+  std::deque<Job> jobs_;
+  std::vector<LoadedLevel> completed_;
+  bool stopping_ = false;
+
+  // Only accessed from the UI thread
+  std::set<std::filesystem::path> requested_paths_;
+  std::set<std::filesystem::path> preloading_paths_;
+  std::deque<LoadedLevel> preloaded_;
+  std::vector<LoadedLevel> ready_;
+
+  // Last, so the jobs are done before the rest is destroyed
+  TaskGroup tasks_;
+};
+
+}  // namespace konkr
+
+#endif  // KONKR_RENDERING_LEVEL_LOADER_H
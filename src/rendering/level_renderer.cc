@@ -4,75 +4,196 @@
 
 #include "rendering/level_renderer.h"
 
+#include <algorithm>
 #include <cmath>
+#include <iostream>
+#include <limits>
 #include <memory>
 #include <string>
 
+#include "rendering/color_palette.h"
 #include "rendering/graphics.h"
+#include "rendering/resource_cache.h"
 #include "rendering/sprite_sheet.h"
 
 namespace konkr {
 
-static Font g_font;
-static bool g_font_loaded = false;
+namespace {
+
+// Where the tiles of a level are on the window: the map is centered
+struct MapLayout {
+  float hex_width;
+  float vert_spacing;
+  float x_origin;
+  float y_origin;
+
+  MapLayout(const RenderSnapshot& snapshot, Vector2u window_size,
+            float hex_radius) {
+    const float hex_height = 2 * hex_radius;
+    hex_width = std::sqrt(3.0f) * hex_radius;
+    vert_spacing = hex_height * 0.75f;
+
+    const float x_padding = 40.0f;
+    const float y_padding = 40.0f;
+
+    // We want to center the map in the window
+    const float map_width = snapshot.columns * hex_width + (hex_width / 2);
+    const float map_height = snapshot.rows * vert_spacing;
+    x_origin = (window_size.x - map_width) / 2.0f + x_padding;
+    y_origin = (window_size.y - map_height) / 2.0f + y_padding;
+  }
 
-bool LevelRenderer::LoadFont(const std::string& path) {
-  if (!g_font_loaded) {
-    g_font = Font(path);
-    if (g_font.is_loaded()) {
-      g_font_loaded = true;
-      return true;
-    }
-    return false;
+  Vector2f TileCenter(const RenderSnapshot& snapshot, int row,
+                      int col) const {
+    const bool indent = snapshot.indented_rows[row];
+    return Vector2f(col * hex_width + (indent ? (hex_width / 2) : 0) + x_origin,
+                    row * vert_spacing + y_origin);
   }
-  return true;
+};
+
+void DrawLabel(RenderTarget& target, const char* label, Vector2f position,
+               float radius) {
+  Text text(LevelRenderer::get_font(), label, 16);
+  text.set_fill_color(Color::Yellow);
+  text.set_outline_color(Color::Black);
+  text.set_outline_thickness(2);
+
+  FloatRect bounds = text.get_local_bounds();
+  text.set_origin({bounds.size.x / 2, bounds.size.y / 2});
+  text.set_position({position.x, position.y - radius / 2});
+  target.draw(text);
 }
 
-const Font& LevelRenderer::get_font() { return g_font; }
+}  // namespace
+
+const Font& LevelRenderer::get_font() {
+  static const ResourceHandle<Font> font =
+      ResourceCache::GetInstance().Load<Font>(kFontPath);
+  return font.get();
+}
 
 void LevelRenderer::Render(RenderTarget& target,
-                           std::shared_ptr<const Level> level,
-                           float hex_radius) const {
-  auto& sprite_sheet = SpriteSheet::GetInstance();
-  LoadFont("assets/fonts/OCRA/OCRA.ttf");
-  const float hex_height = 2 * hex_radius;
-  const float hex_width = std::sqrt(3.0f) * hex_radius;
-  const float vert_spacing = hex_height * 0.75f;
-
-  const float x_padding = 40.0f;
-  const float y_padding = 40.0f;
-
-  const auto& tiles = level->tiles();
-  if (tiles.empty()) return;
-
-  // We want to center the map in the window
-  const size_t num_rows = tiles.size();
-  const size_t num_cols = tiles[0].size();
-  const float map_width = num_cols * hex_width + (hex_width / 2);
-  const float map_height = num_rows * vert_spacing;
-
-  const Vector2u window_size = target.get_size();
-  const float window_width = static_cast<float>(window_size.x);
-  const float window_height = static_cast<float>(window_size.y);
-
-  const float x_offset = (window_width - map_width) / 2.0f;
-  const float y_offset = (window_height - map_height) / 2.0f;
-
-  for (size_t row = 0; row < tiles.size(); ++row) {
-    const auto& tile_row = tiles[row];
-    bool indent = !level->map()[row].empty() && level->map()[row][0] == '|';
-
-    for (size_t col = 0; col < tile_row.size(); ++col) {
-      const auto& tile_opt = tile_row[col];
-      if (!tile_opt) continue;
-
-      float x = col * hex_width + (indent ? (hex_width / 2) : 0) + x_padding +
-                x_offset;
-      float y = row * vert_spacing + y_padding + y_offset;
-
-      tile_opt->Render(target, Vector2f(x, y), hex_radius, sprite_sheet);
+                           const RenderSnapshot& snapshot, float hex_radius,
+                           std::optional<Vector2i> hovered_tile) {
+  if (snapshot.empty()) return;
+
+  const MapLayout layout(snapshot, target.get_size(), hex_radius);
+  for (int row = 0; row < snapshot.rows; ++row) {
+    for (int col = 0; col < snapshot.columns; ++col) {
+      const TileSnapshot& tile = snapshot.tile(row, col);
+      if (!tile.has(TileSnapshot::kPresent)) continue;
+      DrawTile(target, tile, layout.TileCenter(snapshot, row, col),
+               hex_radius);
+    }
+  }
+
+  // Over the tiles, as a wall is drawn along the side of its tile
+  border_mesh_.Update(snapshot, hex_radius);
+  border_mesh_.Draw(target, Vector2f(layout.x_origin, layout.y_origin));
+
+  move_preview_.Update(snapshot);
+  if (!hovered_tile) return;
+  const float dot_radius = hex_radius * kPathDotSize;
+  for (const Vector2i position : move_preview_.PathTo(*hovered_tile)) {
+    CircleShape dot(dot_radius, 12);
+    dot.set_origin({dot_radius, dot_radius});
+    dot.set_position(layout.TileCenter(snapshot, position.x, position.y));
+    dot.set_fill_color(Color::Yellow);
+    target.draw(dot);
+  }
+}
+
+std::optional<Vector2i> LevelRenderer::PixelToTile(
+    const RenderSnapshot& snapshot, Vector2u window_size, float hex_radius,
+    Vector2f point) {
+  if (snapshot.empty()) return std::nullopt;
+
+  // The hexagons tile the plane, so the tile under the point is the one whose
+  // center is the closest, among the rows around the point
+  const MapLayout layout(snapshot, window_size, hex_radius);
+  const int center_row = static_cast<int>(
+      std::lround((point.y - layout.y_origin) / layout.vert_spacing));
+
+  std::optional<Vector2i> closest;
+  float closest_distance = std::numeric_limits<float>::max();
+  for (int row = std::max(0, center_row - 1);
+       row <= std::min(snapshot.rows - 1, center_row + 1); ++row) {
+    const float indent = snapshot.indented_rows[row] ? layout.hex_width / 2 : 0;
+    const int center_col = static_cast<int>(std::lround(
+        (point.x - layout.x_origin - indent) / layout.hex_width));
+    for (int col = std::max(0, center_col - 1);
+         col <= std::min(snapshot.columns - 1, center_col + 1); ++col) {
+      if (!snapshot.tile(row, col).has(TileSnapshot::kPresent)) continue;
+      const Vector2f center = layout.TileCenter(snapshot, row, col);
+      const float dx = point.x - center.x;
+      const float dy = point.y - center.y;
+      const float distance = dx * dx + dy * dy;
+      if (distance < closest_distance) {
+        closest_distance = distance;
+        closest = Vector2i(row, col);
+      }
     }
   }
+
+  if (closest_distance > hex_radius * hex_radius) return std::nullopt;
+  return closest;
+}
+
+void LevelRenderer::DrawTile(RenderTarget& target, const TileSnapshot& tile,
+                             Vector2f position, float radius) const {
+  CircleShape shape(radius, 6);
+  shape.set_origin({radius, radius});
+  shape.set_position(position);
+
+  if (tile.type == TileType::Sand) {
+    Color base = ColorPalette::SandColorForPlayer(
+        tile.owner >= 0 ? std::optional<int>(tile.owner) : std::nullopt);
+    if (tile.has(TileSnapshot::kOrphan)) {
+      base = Color(std::max(0, base.r() - 60), std::max(0, base.g() - 60),
+                   std::max(0, base.b() - 60));
+    }
+    shape.set_fill_color(base);
+  } else if (tile.type == TileType::Water) {
+    shape.set_fill_color(ColorPalette::OceanBlue);
+  } else if (tile.type == TileType::Forest) {
+    shape.set_fill_color(Color(60, 120, 60));
+  }
+  target.draw(shape);
+
+  if (tile.entity != Entity::EntityType::Unknown) {
+    // Sprites are drawn from the smallest page at least as large as needed,
+    // then scaled down to the size of the tile
+    const auto& sprite_sheet = SpriteSheet::GetInstance();
+    const float scale = radius / SpriteSheet::kNativeHexRadius;
+    const int mip_level = sprite_sheet.GetMipLevel(scale);
+    const SpriteInfo* native_info =
+        sprite_sheet.GetEntitySpriteInfo(tile.entity, tile.entity_level);
+    const SpriteInfo* info = sprite_sheet.GetEntitySpriteInfo(
+        tile.entity, tile.entity_level, mip_level);
+    if (info) {
+      auto sprite = Graphics::CreateSprite(sprite_sheet.GetTexture(mip_level),
+                                           info->rect);
+      // Sets origin to center of the sprite
+      if (sprite) {
+        const float sprite_scale = scale * native_info->rect.size.x /
+                                   static_cast<float>(info->rect.size.x);
+        sprite->set_origin({info->rect.size.x / 2.f, info->rect.size.y / 2.f});
+        sprite->set_scale({sprite_scale, sprite_scale});
+        sprite->set_position(position);
+        target.draw(*sprite);
+      }
+    } else {
+      std::cerr << "Failed to get sprite for entity: "
+                << Entity::entity_type_to_string(tile.entity) << std::endl;
+    }
+  }
+
+  if (tile.has(TileSnapshot::kDefended)) {
+    DrawLabel(target, "D", position, radius);
+  }
+  if (tile.has(TileSnapshot::kReachable)) {
+    DrawLabel(target, "R", position, radius);
+  }
 }
 
 }  // namespace konkr
@@ -4,37 +4,67 @@
 //
 // level_renderer.h
 //
-// TODO: add .h description
+// Declares the LevelRenderer class, which draws the snapshots of a level
+// published by the simulation, and finds the tiles under the mouse.
 
 #ifndef KONKR_RENDERING_LEVEL_RENDERER_H
 #define KONKR_RENDERING_LEVEL_RENDERER_H
 
-#include <memory>
+#include <optional>
 
+#include "rendering/border_mesh.h"
 #include "rendering/graphics.h"
-#include "rendering/level.h"
+#include "rendering/move_preview.h"
+#include "rendering/render_snapshot.h"
 
 namespace konkr {
 
 class LevelRenderer {
  public:
-  static bool LoadFont(const std::string& path);
+  static constexpr const char* kFontPath = "assets/fonts/OCRA/OCRA.ttf";
 
+  // Radius of the tiles on the screen
+  static constexpr float kHexRadius = 50.0f;
+  // Radius of the dots of a move preview, relative to that of the tiles
+  static constexpr float kPathDotSize = 0.15f;
+
+  // Font used to draw text on the map, shared through the ResourceCache.
   static const Font& get_font();
 
   /**
-     @brief Renders the level on the window.
+     @brief Renders the level on the window. The borders of the territories
+     are kept from the previous call, and only updated where they changed.
      @param target SFML RenderTarget.
-     @param level Level to render.
+     @param snapshot Snapshot of the level to render.
      @param hex_radius Radius of the hexagon representing a tile.
+     @param hovered_tile Tile under the mouse, if any: the way the selected
+     unit would go there is drawn over the map (see MovePreview).
   */
-  void Render(RenderTarget& target, std::shared_ptr<const Level> level,
-              float hex_radius) const;
+  void Render(RenderTarget& target, const RenderSnapshot& snapshot,
+              float hex_radius,
+              std::optional<Vector2i> hovered_tile = std::nullopt);
+
+  /**
+     @brief Finds the tile drawn at a point of the window by Render.
+     @param snapshot Snapshot of the level, as rendered.
+     @param window_size Size of the window the snapshot is rendered on.
+     @param hex_radius Radius the snapshot is rendered with.
+     @param point Point of the window.
+     @returns The grid position (row, column) of the tile, nullopt if there is
+     no tile at this point.
+  */
+  static std::optional<Vector2i> PixelToTile(const RenderSnapshot& snapshot,
+                                             Vector2u window_size,
+                                             float hex_radius, Vector2f point);
 
  private:
-  bool font_loaded_ = false;
+  void DrawTile(RenderTarget& target, const TileSnapshot& tile,
+                Vector2f position, float radius) const;
+
+  BorderMesh border_mesh_;
+  MovePreview move_preview_;
 };
 
 }  // namespace konkr
 
-#endif  // KONKR_RENDERING_LEVEL_RENDERER_H
\ No newline at end of file
+#endif  // KONKR_RENDERING_LEVEL_RENDERER_H
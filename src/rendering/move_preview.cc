@@ -0,0 +1,72 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+
+#include "rendering/move_preview.h"
+
+#include <algorithm>
+
+namespace konkr {
+
+void MovePreview::Update(const RenderSnapshot& snapshot) {
+  if (snapshot.version == version_) return;
+  version_ = snapshot.version;
+  path_target_.reset();
+
+  if (static_cast<size_t>(snapshot.rows) != grid_.rows() ||
+      static_cast<size_t>(snapshot.columns) != grid_.columns()) {
+    Reset(snapshot);
+  }
+
+  unit_ = snapshot.selected_unit;
+  const int owner = unit_ ? snapshot.tile(unit_->x, unit_->y).owner : -1;
+  // The finder only drops what a tile whose passability changed touches
+  for (int row = 0; row < snapshot.rows; ++row) {
+    for (int column = 0; column < snapshot.columns; ++column) {
+      const TileSnapshot& tile = snapshot.tile(row, column);
+      const size_t bit = grid_.bit({row, column});
+      const bool reachable = tile.has(TileSnapshot::kReachable);
+      if (reachable) {
+        reachable_.Set(bit);
+      } else {
+        reachable_.Reset(bit);
+      }
+      finder_.SetPassable(
+          {row, column},
+          tile.has(TileSnapshot::kPresent) && tile.type == TileType::Sand &&
+              (reachable || (owner >= 0 && tile.owner == owner)));
+    }
+  }
+}
+
+std::span<const Vector2i> MovePreview::PathTo(Vector2i target) {
+  if (path_target_ == target) return path_;
+  path_target_ = target;
+  path_.clear();
+  if (!unit_ || !grid_.contains(target) ||
+      !reachable_.Test(grid_.bit(target))) {
+    return path_;
+  }
+
+  // Walked back from target along the distances to the unit
+  path_.push_back(target);
+  while (path_.back() != *unit_) {
+    const std::optional<Vector2i> step =
+        finder_.NextStep(path_.back(), *unit_);
+    if (!step) {
+      path_.clear();
+      break;
+    }
+    path_.push_back(*step);
+  }
+  std::reverse(path_.begin(), path_.end());
+  return path_;
+}
+
+void MovePreview::Reset(const RenderSnapshot& snapshot) {
+  grid_ = HexGrid(snapshot.rows, snapshot.columns);
+  finder_.Reset(grid_);
+  reachable_.Assign(grid_.bit_count());
+}
+
+}  // namespace konkr
@@ -0,0 +1,56 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+//
+// move_preview.h
+//
+// Declares the MovePreview class, which finds the way the selected unit of a
+// snapshot would go to a tile, to draw it before the move.
+
+#ifndef KONKR_RENDERING_MOVE_PREVIEW_H
+#define KONKR_RENDERING_MOVE_PREVIEW_H
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "core/bitset.h"
+#include "rendering/graphics.h"
+#include "rendering/render_snapshot.h"
+#include "world/move_generator.h"
+#include "world/path_finder.h"
+
+namespace konkr {
+
+// The way of the selected unit to a tile it can reach (see
+// Level::SelectTile) is a shortest path through the land of its owner and the
+// tiles it can reach. The render thread searches it on the snapshots, with a
+// PathFinder whose tiles are described again only where a new snapshot
+// changed them. The distances to the selected unit are kept by the finder
+// until then, so following the mouse over the map only walks them.
+class MovePreview {
+ public:
+  // Brings the tiles the paths go through up to date with snapshot
+  void Update(const RenderSnapshot& snapshot);
+
+  // Positions from the selected unit to target, both included, empty if no
+  // unit is selected or it can't reach target. Valid until the next call.
+  std::span<const Vector2i> PathTo(Vector2i target);
+
+ private:
+  // Forgets the tiles, for a snapshot of another size
+  void Reset(const RenderSnapshot& snapshot);
+
+  uint64_t version_ = 0;
+  HexGrid grid_;
+  PathFinder finder_;
+  std::optional<Vector2i> unit_;
+  Bitset reachable_;  // Bits of grid_
+  std::vector<Vector2i> path_;
+  std::optional<Vector2i> path_target_;  // Of path_, as of version_
+};
+
+}  // namespace konkr
+
+#endif  // KONKR_RENDERING_MOVE_PREVIEW_H
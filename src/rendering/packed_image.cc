@@ -0,0 +1,165 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+
+#include "rendering/packed_image.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+namespace konkr {
+
+namespace {
+
+// Layout: the magic, then the version, width and height as little endian
+// 32-bit integers, then packets until all the pixels are described. A packet
+// starts with a control byte: if its high bit is set, the next pixel is
+// repeated (control & 0x7f) + 1 times, otherwise (control + 1) pixels follow.
+constexpr char kMagic[4] = {'K', 'I', 'M', 'G'};
+constexpr uint32_t kVersion = 1;
+constexpr size_t kHeaderSize = 16;
+constexpr size_t kPixelSize = 4;
+constexpr size_t kMaxPacketLength = 128;
+constexpr uint8_t kRunFlag = 0x80;
+
+void WriteUint32(std::vector<uint8_t>& out, uint32_t value) {
+  for (int shift = 0; shift < 32; shift += 8) {
+    out.push_back(static_cast<uint8_t>(value >> shift));
+  }
+}
+
+uint32_t ReadUint32(const uint8_t* in) {
+  return static_cast<uint32_t>(in[0]) | static_cast<uint32_t>(in[1]) << 8 |
+         static_cast<uint32_t>(in[2]) << 16 |
+         static_cast<uint32_t>(in[3]) << 24;
+}
+
+bool SamePixel(const uint8_t* a, const uint8_t* b) {
+  return std::memcmp(a, b, kPixelSize) == 0;
+}
+
+}  // namespace
+
+std::vector<uint8_t> EncodePackedImage(uint32_t width, uint32_t height,
+                                       const uint8_t* pixels) {
+  std::vector<uint8_t> out(std::begin(kMagic), std::end(kMagic));
+  WriteUint32(out, kVersion);
+  WriteUint32(out, width);
+  WriteUint32(out, height);
+
+  const size_t pixel_count = static_cast<size_t>(width) * height;
+  size_t i = 0;
+  while (i < pixel_count) {
+    const uint8_t* pixel = pixels + i * kPixelSize;
+    size_t run = 1;
+    while (i + run < pixel_count && run < kMaxPacketLength &&
+           SamePixel(pixel, pixel + run * kPixelSize)) {
+      ++run;
+    }
+    if (run > 1) {
+      out.push_back(kRunFlag | static_cast<uint8_t>(run - 1));
+      out.insert(out.end(), pixel, pixel + kPixelSize);
+      i += run;
+      continue;
+    }
+
+    // Literal packet, up to the next run of at least two pixels
+    size_t length = 1;
+    while (i + length < pixel_count && length < kMaxPacketLength &&
+           (i + length + 1 >= pixel_count ||
+            !SamePixel(pixel + length * kPixelSize,
+                       pixel + (length + 1) * kPixelSize))) {
+      ++length;
+    }
+    out.push_back(static_cast<uint8_t>(length - 1));
+    out.insert(out.end(), pixel, pixel + length * kPixelSize);
+    i += length;
+  }
+  return out;
+}
+
+std::optional<PackedImage> DecodePackedImage(const std::vector<uint8_t>& data) {
+  if (data.size() < kHeaderSize ||
+      !std::equal(std::begin(kMagic), std::end(kMagic), data.begin()) ||
+      ReadUint32(data.data() + 4) != kVersion) {
+    return std::nullopt;
+  }
+
+  PackedImage image;
+  image.width = ReadUint32(data.data() + 8);
+  image.height = ReadUint32(data.data() + 12);
+  const size_t size =
+      static_cast<size_t>(image.width) * image.height * kPixelSize;
+  image.pixels.resize(size);
+
+  size_t in = kHeaderSize;
+  size_t out = 0;
+  while (out < size) {
+    if (in >= data.size()) return std::nullopt;
+    const uint8_t control = data[in++];
+    const size_t length = (control & ~kRunFlag) + 1u;
+    if (out + length * kPixelSize > size) return std::nullopt;
+
+    if (control & kRunFlag) {
+      if (in + kPixelSize > data.size()) return std::nullopt;
+      for (size_t j = 0; j < length; ++j) {
+        std::memcpy(&image.pixels[out], &data[in], kPixelSize);
+        out += kPixelSize;
+      }
+      in += kPixelSize;
+    } else {
+      const size_t bytes = length * kPixelSize;
+      if (in + bytes > data.size()) return std::nullopt;
+      std::memcpy(&image.pixels[out], &data[in], bytes);
+      out += bytes;
+      in += bytes;
+    }
+  }
+  return image;
+}
+
+std::optional<PackedImage> ReadPackedImage(const std::filesystem::path& path) {
+  std::ifstream stream(path, std::ios::binary);
+  if (!stream.is_open()) {
+    return std::nullopt;
+  }
+  // Checks the magic first, so other images aren't read twice
+  char magic[sizeof(kMagic)] = {};
+  if (!stream.read(magic, sizeof(magic)) ||
+      !std::equal(std::begin(kMagic), std::end(kMagic), magic)) {
+    return std::nullopt;
+  }
+  std::vector<uint8_t> data(std::begin(kMagic), std::end(kMagic));
+  data.insert(data.end(), std::istreambuf_iterator<char>(stream),
+              std::istreambuf_iterator<char>());
+  return DecodePackedImage(data);
+}
+
+bool WritePackedImage(const std::filesystem::path& path, uint32_t width,
+                      uint32_t height, const uint8_t* pixels) {
+  const std::vector<uint8_t> data = EncodePackedImage(width, height, pixels);
+  std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+  if (!stream.is_open()) {
+    return false;
+  }
+  stream.write(reinterpret_cast<const char*>(data.data()),
+               static_cast<std::streamsize>(data.size()));
+  return static_cast<bool>(stream);
+}
+
+std::filesystem::path MipPagePath(const std::filesystem::path& path,
+                                  int mip_level) {
+  if (mip_level == 0) {
+    return path;
+  }
+  std::filesystem::path page_path = path;
+  page_path.replace_filename(path.stem().string() + "_mip" +
+                             std::to_string(mip_level) +
+                             path.extension().string());
+  return page_path;
+}
+
+}  // namespace konkr
@@ -0,0 +1,50 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+//
+// packed_image.h
+//
+// Declares the functions reading and writing packed images, the binary format
+// the atlas compiler converts the sprite atlas to. A packed image holds the
+// RGBA pixels run-length encoded, so loading it needs no PNG decoding.
+//
+
+#ifndef KONKR_RENDERING_PACKED_IMAGE_H
+#define KONKR_RENDERING_PACKED_IMAGE_H
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+namespace konkr {
+
+struct PackedImage {
+  uint32_t width = 0;
+  uint32_t height = 0;
+  // width * height RGBA pixels, row by row
+  std::vector<uint8_t> pixels;
+};
+
+// Encodes width * height RGBA pixels. Runs of identical pixels (the
+// transparent space between the sprites of an atlas) take 5 bytes each.
+std::vector<uint8_t> EncodePackedImage(uint32_t width, uint32_t height,
+                                       const uint8_t* pixels);
+
+// Returns nullopt if data isn't a valid packed image
+std::optional<PackedImage> DecodePackedImage(const std::vector<uint8_t>& data);
+
+// Returns nullopt if the file can't be read or isn't a packed image
+std::optional<PackedImage> ReadPackedImage(const std::filesystem::path& path);
+
+bool WritePackedImage(const std::filesystem::path& path, uint32_t width,
+                      uint32_t height, const uint8_t* pixels);
+
+// Path of a downscaled page of the packed image at path: the page of mip level
+// 0 is the image itself, atlas.bin has atlas_mip1.bin, atlas_mip2.bin, ...
+std::filesystem::path MipPagePath(const std::filesystem::path& path,
+                                  int mip_level);
+
+}  // namespace konkr
+
+#endif  // KONKR_RENDERING_PACKED_IMAGE_H
@@ -0,0 +1,111 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+
+#include "rendering/render_snapshot.h"
+
+#include <algorithm>
+
+namespace konkr {
+
+namespace {
+
+TileSnapshot SnapshotTile(const Tile& tile) {
+  TileSnapshot snapshot;
+  snapshot.type = tile.type();
+  snapshot.flags = TileSnapshot::kPresent;
+  if (tile.is_orphan()) snapshot.flags |= TileSnapshot::kOrphan;
+  if (tile.is_reachable()) snapshot.flags |= TileSnapshot::kReachable;
+  if (tile.level() == 1) snapshot.flags |= TileSnapshot::kDefended;
+  if (auto owner = tile.get_owner()) {
+    snapshot.owner = static_cast<int8_t>(*owner);
+  }
+  snapshot.walls = static_cast<uint8_t>(tile.walls_mask());
+  if (const auto& entity = tile.entity()) {
+    snapshot.entity = entity->type();
+    snapshot.entity_level = static_cast<int8_t>(entity->level());
+  }
+  return snapshot;
+}
+
+void CapturePlayers(const Level& level, RenderSnapshot& snapshot) {
+  const auto& players = level.active_players();
+  const Economy& economy = level.economy();
+  snapshot.players.resize(players.size());
+  size_t index = 0;
+  for (const auto& [id, player] : players) {
+    PlayerSnapshot& player_snapshot = snapshot.players[index++];
+    player_snapshot.id = id;
+    player_snapshot.name = player.name();
+    player_snapshot.townhall_economy.clear();
+    const auto [first, last] = economy.townhalls(id);
+    for (size_t i = first; i < last; ++i) {
+      player_snapshot.townhall_economy.push_back(
+          {.money = economy.money()[i],
+           .income = economy.income()[i],
+           .bankruptcy_turn = economy.bankruptcy_turns()[i]});
+    }
+  }
+  snapshot.current_player =
+      level.current_player_index() < players.size()
+          ? static_cast<int>(level.current_player_index())
+          : -1;
+}
+
+}  // namespace
+
+void CaptureRenderSnapshot(const Level& level, RenderSnapshot& snapshot) {
+  snapshot.level_name = level.name();
+  snapshot.level_category = level.category();
+
+  const auto& tiles = level.tiles();
+  snapshot.rows = static_cast<int>(tiles.size());
+  snapshot.columns = 0;
+  for (const auto& row : tiles) {
+    snapshot.columns = std::max(snapshot.columns, static_cast<int>(row.size()));
+  }
+
+  snapshot.tiles.assign(snapshot.rows * snapshot.columns, TileSnapshot{});
+  snapshot.indented_rows.assign(snapshot.rows, false);
+  for (int row = 0; row < snapshot.rows; ++row) {
+    const std::string& line = level.map()[row];
+    snapshot.indented_rows[row] = !line.empty() && line[0] == '|';
+    for (size_t col = 0; col < tiles[row].size(); ++col) {
+      if (const auto& tile = tiles[row][col]) {
+        snapshot.tiles[row * snapshot.columns + col] = SnapshotTile(*tile);
+      }
+    }
+  }
+
+  CapturePlayers(level, snapshot);
+  snapshot.selected_unit = level.selected_unit();
+}
+
+void UpdateRenderSnapshot(const Level& level,
+                          std::span<const ChangeEvent> changes,
+                          RenderSnapshot& snapshot) {
+  const bool reset = std::any_of(
+      changes.begin(), changes.end(), [](const ChangeEvent& change) {
+        return change.kind == ChangeEvent::Kind::Reset;
+      });
+  if (reset || snapshot.empty()) {
+    CaptureRenderSnapshot(level, snapshot);
+    return;
+  }
+
+  for (const ChangeEvent& change : changes) {
+    if (change.kind != ChangeEvent::Kind::Tile &&
+        change.kind != ChangeEvent::Kind::Entity) {
+      continue;
+    }
+    const Vector2i position = change.position;
+    if (const Tile* tile = level.GetTile(position)) {
+      snapshot.tiles[position.x * snapshot.columns + position.y] =
+          SnapshotTile(*tile);
+    }
+  }
+  CapturePlayers(level, snapshot);
+  snapshot.selected_unit = level.selected_unit();
+}
+
+}  // namespace konkr
@@ -0,0 +1,114 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+//
+// render_snapshot.h
+//
+// Declares the RenderSnapshot struct, a copy of what the screen shows of a
+// level, made by the simulation thread for the render thread.
+//
+
+#ifndef KONKR_RENDERING_RENDER_SNAPSHOT_H
+#define KONKR_RENDERING_RENDER_SNAPSHOT_H
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "rendering/level.h"
+#include "world/change_bus.h"
+#include "world/entity.h"
+#include "world/tile.h"
+
+namespace konkr {
+
+// What is drawn of a tile, in a few bytes
+struct TileSnapshot {
+  enum Flags : uint8_t {
+    kPresent = 1 << 0,  // There is a tile at this position of the grid
+    kOrphan = 1 << 1,
+    kReachable = 1 << 2,
+    kDefended = 1 << 3,  // Next to a building of its owner
+  };
+
+  TileType type = TileType::Water;
+  uint8_t flags = 0;
+  int8_t owner = -1;  // Player id, -1 if the tile has no owner
+  uint8_t walls = 0;  // Borders of the territory, see Tile::walls_mask
+  Entity::EntityType entity = Entity::EntityType::Unknown;
+  int8_t entity_level = 0;
+
+  inline bool has(Flags flag) const { return flags & flag; }
+};
+
+// Of a townhall, as forecast by Level::economy
+struct TownhallEconomy {
+  int money = 0;
+  int income = 0;  // Added to the money at the end of the player's turn
+  // Turns of the player until the townhall goes bankrupt, 0 if not within
+  // Economy::kForecastTurns
+  int bankruptcy_turn = 0;
+
+  bool operator==(const TownhallEconomy&) const = default;
+};
+
+struct PlayerSnapshot {
+  int id = 0;
+  std::string name;
+  // Of each townhall, in the order of their positions
+  std::vector<TownhallEconomy> townhall_economy;
+};
+
+// Immutable once published: the render thread only reads it, so it holds
+// values rather than pointers to the tiles of the level. The tiles are stored
+// row by row, rows * columns of them, columns being the length of the longest
+// row.
+struct RenderSnapshot {
+  // Incremented at every snapshot published by a simulation
+  uint64_t version = 0;
+  std::string level_name;
+  std::string level_category;
+
+  int rows = 0;
+  int columns = 0;
+  std::vector<TileSnapshot> tiles;
+  // Rows drawn half a tile to the right
+  std::vector<bool> indented_rows;
+
+  std::vector<PlayerSnapshot> players;
+  int current_player = -1;  // Index in players, -1 if there is none
+  // Unit whose reachable tiles are marked, see Level::SelectTile
+  std::optional<Vector2i> selected_unit;
+
+  inline bool empty() const { return tiles.empty(); }
+
+  inline const TileSnapshot& tile(int row, int column) const {
+    return tiles[row * columns + column];
+  }
+
+  inline const PlayerSnapshot* get_current_player() const {
+    if (current_player < 0) return nullptr;
+    return &players[current_player];
+  }
+};
+
+// Overwrites snapshot with the state of the level, except for its version.
+// The vectors of snapshot are reused, so taking a snapshot of the same level
+// again doesn't allocate. The economy of the townhalls is that of the last
+// Level::UpdateEconomy.
+void CaptureRenderSnapshot(const Level& level, RenderSnapshot& snapshot);
+
+// Brings snapshot, captured from level before changes happened (see
+// ChangeBus::Drain), up to date: only the tiles changed are captured again,
+// unless changes hold a Reset or snapshot is empty. The players and the
+// selected unit, a few values, are always captured again, with the economy of the last
+// Level::UpdateEconomy.
+void UpdateRenderSnapshot(const Level& level,
+                          std::span<const ChangeEvent> changes,
+                          RenderSnapshot& snapshot);
+
+}  // namespace konkr
+
+#endif  // KONKR_RENDERING_RENDER_SNAPSHOT_H
@@ -0,0 +1,97 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+
+#include "rendering/replay_player.h"
+
+#include <iostream>
+
+namespace konkr {
+
+bool ReplayPlayer::Open() {
+  level_ = std::make_shared<Level>(log_.level_name(), log_.level_category(),
+                                   log_.level_path());
+  level_->set_seed(log_.seed());
+  offset_ = 0;
+  if (!level_->Load()) {
+    std::cerr << "Failed to load the level of the replay: "
+              << log_.level_path() << std::endl;
+    level_ = nullptr;
+    return false;
+  }
+  return true;
+}
+
+bool ReplayPlayer::SeekToTurn(uint32_t turn) {
+  if (!level_ || turn > log_.last_turn()) return false;
+
+  // Going forward within the keyframe interval, the commands in between are
+  // cheaper than a restore
+  const CommandLog::Keyframe* keyframe = log_.FindKeyframe(turn);
+  if (!keyframe) return false;
+  if (level_->turn() >= turn || keyframe->turn > level_->turn()) {
+    ByteReader state(keyframe->state);
+    if (!level_->ReadState(state)) {
+      std::cerr << "Invalid keyframe in the replay at turn " << keyframe->turn
+                << std::endl;
+      return false;
+    }
+    offset_ = keyframe->command_offset;
+  }
+
+  // Actions followed by a NextTurn are applied as one batch with it (see
+  // Level::ApplyActions), as the computer players play them: the journal
+  // forgets them once the turn ends anyway. Actions followed by another
+  // command are applied one by one, as a human played them, so that an Undo
+  // takes back only the last one. offset_ only moves past whole batches.
+  ByteReader reader(log_.commands());
+  reader.set_position(offset_);
+  std::vector<GameCommand> actions;
+  while (level_->turn() < turn) {
+    GameCommand command;
+    if (!CommandLog::ReadCommand(reader, command)) return false;
+    if (command.is_action()) {
+      actions.push_back(command);
+      continue;
+    }
+    if (command.type == GameCommand::Type::NextTurn) {
+      actions.push_back(command);
+      ApplyBatch(actions);
+    } else {
+      ApplyEach(actions);
+      level_->ApplyCommand(command);
+    }
+    offset_ = reader.position();
+  }
+  return true;
+}
+
+void ReplayPlayer::ApplyBatch(std::vector<GameCommand>& actions) {
+  if (actions.empty()) return;
+  // A command the game rejected was recorded anyway, and rejected alone
+  if (!level_->ApplyActions(actions)) {
+    ApplyEach(actions);
+    return;
+  }
+  actions.clear();
+}
+
+void ReplayPlayer::ApplyEach(std::vector<GameCommand>& actions) {
+  for (const GameCommand& action : actions) {
+    level_->ApplyCommand(action);
+  }
+  actions.clear();
+}
+
+bool ReplayPlayer::Step() {
+  if (!level_) return false;
+  ByteReader reader(log_.commands());
+  reader.set_position(offset_);
+  GameCommand command;
+  if (!CommandLog::ReadCommand(reader, command)) return false;
+  level_->ApplyCommand(command);
+  offset_ = reader.position();
+  return true;
+}
+
+}  // namespace konkr
@@ -0,0 +1,62 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+//
+// replay_player.h
+//
+// Declares the ReplayPlayer class, which plays a CommandLog back on a new
+// level and seeks to any of its turns.
+//
+
+#ifndef KONKR_RENDERING_REPLAY_PLAYER_H
+#define KONKR_RENDERING_REPLAY_PLAYER_H
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "rendering/command_log.h"
+#include "rendering/level.h"
+
+namespace konkr {
+
+// Rebuilds the game of a command log. Seeking restores the keyframe closest
+// before the turn and applies the commands from there, without rendering
+// anything, so jumping anywhere in a long game costs at most
+// CommandLog::kKeyframeInterval turns.
+class ReplayPlayer {
+ public:
+  explicit ReplayPlayer(CommandLog log) : log_(std::move(log)) {}
+
+  // Loads the level of the log, with its seed, at turn 0
+  bool Open();
+
+  // Moves to the start of turn (before its first command), which must be at
+  // most log().last_turn()
+  bool SeekToTurn(uint32_t turn);
+
+  // Applies the next command. Returns false at the end of the log.
+  bool Step();
+
+  inline bool at_end() const { return offset_ >= log_.commands().size(); }
+  inline const CommandLog& log() const { return log_; }
+  inline const std::shared_ptr<Level>& level() const { return level_; }
+
+ private:
+  // Applies actions as one batch, or one by one if the batch is rejected,
+  // then clears them
+  void ApplyBatch(std::vector<GameCommand>& actions);
+  // Applies actions one by one, each its own action of the journal, then
+  // clears them
+  void ApplyEach(std::vector<GameCommand>& actions);
+
+  CommandLog log_;
+  std::shared_ptr<Level> level_;
+  // Position of the next command in the command stream
+  size_t offset_ = 0;
+};
+
+}  // namespace konkr
+
+#endif  // KONKR_RENDERING_REPLAY_PLAYER_H
@@ -0,0 +1,70 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+
+#include "rendering/resource_cache.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+#include "rendering/packed_image.h"
+
+namespace konkr {
+
+std::shared_ptr<Image> ResourceTraits<Texture>::Decode(
+    const std::filesystem::path& path) {
+  // The atlas compiler's packed images only need copying, other images are
+  // decoded by SFML
+  if (auto packed = ReadPackedImage(path)) {
+    return Graphics::CreateImage({packed->width, packed->height},
+                                 packed->pixels.data());
+  }
+  return Graphics::DecodeImage(path.string());
+}
+
+std::unique_ptr<Texture> ResourceTraits<Texture>::Finalize(
+    std::shared_ptr<Image> decoded) {
+  auto texture = Graphics::CreateTexture(*decoded);
+  // Sprites are scaled with the tiles they are drawn on
+  if (texture) texture->set_smooth(true);
+  return texture;
+}
+
+std::shared_ptr<const Font::Data> ResourceTraits<Font>::Decode(
+    const std::filesystem::path& path) {
+  std::ifstream font_stream(path, std::ios::binary);
+  if (!font_stream.is_open()) {
+    return nullptr;
+  }
+  auto data = std::make_shared<Font::Data>();
+  std::error_code ec;
+  data->reserve(std::filesystem::file_size(path, ec));
+  std::transform(std::istreambuf_iterator<char>(font_stream),
+                 std::istreambuf_iterator<char>(), std::back_inserter(*data),
+                 [](char c) { return static_cast<std::byte>(c); });
+  return data;
+}
+
+std::unique_ptr<Font> ResourceTraits<Font>::Finalize(
+    std::shared_ptr<const Font::Data> decoded) {
+  auto font = std::make_unique<Font>(std::move(decoded));
+  if (!font->is_loaded()) {
+    return nullptr;
+  }
+  return font;
+}
+
+size_t ResourceCache::Purge() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto unused = [](const auto& entry) {
+    return entry.second.use_count() == 1;
+  };
+  return std::apply(
+      [&unused](auto&... slot_maps) {
+        return (std::erase_if(slot_maps, unused) + ...);
+      },
+      slots_);
+}
+
+}  // namespace konkr
@@ -0,0 +1,178 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+//
+// resource_cache.h
+//
+// Declares the ResourceCache class, which loads the textures and fonts of the
+// game once, decoding them on the JobSystem's workers, and shares them through
+// reference-counted handles.
+//
+
+#ifndef KONKR_RENDERING_RESOURCE_CACHE_H
+#define KONKR_RENDERING_RESOURCE_CACHE_H
+
+#include <chrono>
+#include <filesystem>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+
+#include "core/job_system.h"
+#include "rendering/graphics.h"
+
+namespace konkr {
+
+// How a resource is loaded: Decode runs on a worker thread and does the
+// expensive part (file reading, image decoding), Finalize runs on the first
+// thread using the resource, as it may need the graphics context.
+template <typename T>
+struct ResourceTraits;
+
+template <>
+struct ResourceTraits<Texture> {
+  using Decoded = Image;
+  static std::shared_ptr<Decoded> Decode(const std::filesystem::path& path);
+  static std::unique_ptr<Texture> Finalize(std::shared_ptr<Decoded> decoded);
+};
+
+template <>
+struct ResourceTraits<Font> {
+  using Decoded = const Font::Data;
+  static std::shared_ptr<Decoded> Decode(const std::filesystem::path& path);
+  static std::unique_ptr<Font> Finalize(std::shared_ptr<Decoded> decoded);
+};
+
+namespace detail {
+
+template <typename T>
+class ResourceSlot {
+ public:
+  using Decoded = typename ResourceTraits<T>::Decoded;
+
+  ResourceSlot(std::filesystem::path path,
+               std::shared_future<std::shared_ptr<Decoded>> decoded)
+      : path_(std::move(path)), decoded_(std::move(decoded)) {}
+
+  // Waits for the decoding and finalizes the resource the first time.
+  // Returns nullptr if the resource couldn't be loaded.
+  const T* Get() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!finalized_) {
+      if (auto decoded = decoded_.get()) {
+        resource_ = ResourceTraits<T>::Finalize(std::move(decoded));
+      }
+      if (!resource_) {
+        std::cerr << "Failed to load resource: " << path_ << std::endl;
+      }
+      decoded_ = {};  // The decoded data isn't needed anymore
+      finalized_ = true;
+    }
+    return resource_.get();
+  }
+
+  bool IsReady() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return finalized_ || decoded_.wait_for(std::chrono::seconds(0)) ==
+                             std::future_status::ready;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::filesystem::path path_;
+  std::shared_future<std::shared_ptr<Decoded>> decoded_;
+  std::unique_ptr<T> resource_;
+  bool finalized_ = false;
+};
+
+}  // namespace detail
+
+// Shared handle to a resource of the ResourceCache. Copies of a handle
+// refer to the same resource.
+template <typename T>
+class ResourceHandle {
+ public:
+  ResourceHandle() = default;
+
+  // Returns the resource, waiting for it to be decoded if needed.
+  // If the resource couldn't be loaded, returns an empty resource.
+  const T& get() const {
+    static const T empty;
+    const T* resource = slot_ ? slot_->Get() : nullptr;
+    return resource ? *resource : empty;
+  }
+
+  // Whether get() would succeed, waiting for the decoding if needed.
+  bool is_loaded() const { return slot_ && slot_->Get() != nullptr; }
+
+  // Whether get() would return without waiting for the decoding.
+  bool is_ready() const { return slot_ && slot_->IsReady(); }
+
+  explicit operator bool() const { return slot_ != nullptr; }
+
+ private:
+  friend class ResourceCache;
+  explicit ResourceHandle(std::shared_ptr<detail::ResourceSlot<T>> slot)
+      : slot_(std::move(slot)) {}
+
+  std::shared_ptr<detail::ResourceSlot<T>> slot_;
+};
+
+// Keeps one copy of every resource, identified by its path. Loading a
+// resource starts decoding it in the background and returns immediately, so
+// resources can be prefetched early (e.g. before the window is created) and
+// be ready by the time they are first used.
+class ResourceCache {
+ public:
+  static ResourceCache& GetInstance() {
+    static ResourceCache instance;
+    return instance;
+  }
+
+  // Returns the handle to the resource at path, starting to decode it on the
+  // JobSystem if it isn't in the cache yet.
+  template <typename T>
+  ResourceHandle<T> Load(const std::filesystem::path& path);
+
+  // Drops the resources that aren't referenced by any handle.
+  // Returns the number of resources dropped.
+  size_t Purge();
+
+ private:
+  template <typename T>
+  using SlotMap = std::unordered_map<
+      std::string, std::shared_ptr<detail::ResourceSlot<T>>>;
+
+  ResourceCache() = default;
+  ResourceCache(const ResourceCache&) = delete;
+  ResourceCache& operator=(const ResourceCache&) = delete;
+
+  std::mutex mutex_;
+  std::tuple<SlotMap<Texture>, SlotMap<Font>> slots_;
+};
+
+template <typename T>
+ResourceHandle<T> ResourceCache::Load(const std::filesystem::path& path) {
+  const std::string key = path.lexically_normal().generic_string();
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& slot = std::get<SlotMap<T>>(slots_)[key];
+  if (!slot) {
+    using Decoded = typename ResourceTraits<T>::Decoded;
+    auto decoded = std::make_shared<std::promise<std::shared_ptr<Decoded>>>();
+    slot = std::make_shared<detail::ResourceSlot<T>>(
+        path, decoded->get_future().share());
+    JobSystem::GetInstance().Submit([path, decoded] {
+      decoded->set_value(ResourceTraits<T>::Decode(path));
+    });
+  }
+  return ResourceHandle<T>(slot);
+}
+
+}  // namespace konkr
+
+#endif  // KONKR_RENDERING_RESOURCE_CACHE_H
@@ -0,0 +1,187 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+
+#include "rendering/save_game.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "core/byte_stream.h"
+#include "core/compression.h"
+
+namespace konkr {
+
+namespace {
+
+// Layout: the magic and the version, then blocks until one with a raw size
+// of 0. A block is its raw size and stored size as varints, then the stored
+// bytes, compressed if the stored size is smaller than the raw size.
+constexpr uint8_t kMagic[4] = {'K', 'S', 'A', 'V'};
+// Versions of the format, numbered as those of the command logs:
+//  1. the first one;
+//  2. the units record whether they moved, not set in older saves;
+//  3. the actions are applied in batches, which didn't change the save;
+//  4. the bandits draw from their own random stream, which starts from the
+//     beginning when an older save is loaded.
+constexpr uint64_t kVersion = 4;
+constexpr uint64_t kBanditStreamVersion = 4;
+
+bool WriteToStream(std::ofstream& stream, const uint8_t* data, size_t size) {
+  stream.write(reinterpret_cast<const char*>(data),
+               static_cast<std::streamsize>(size));
+  return static_cast<bool>(stream);
+}
+
+// Appends the raw bytes of the blocks read by reader to data, up to the end
+// marker
+bool ReadBlocks(ByteReader& reader, size_t file_size,
+                std::vector<uint8_t>& data) {
+  while (true) {
+    uint64_t raw_size, stored_size;
+    if (!reader.ReadVarint(raw_size)) return false;
+    if (raw_size == 0) return true;
+    if (!reader.ReadVarint(stored_size) ||
+        raw_size > kMaxCompressionBlockSize || stored_size > raw_size ||
+        stored_size > file_size - reader.position()) {
+      return false;
+    }
+    std::vector<uint8_t> stored(stored_size);
+    reader.ReadBytes(stored.data(), stored_size);
+    if (stored_size == raw_size) {
+      data.insert(data.end(), stored.begin(), stored.end());
+    } else if (!DecompressBlock(stored.data(), stored_size, raw_size, data)) {
+      return false;
+    }
+  }
+}
+
+// Writes the game to stream, as laid out above
+bool WriteGame(const Level& level, std::ofstream& stream, bool compress) {
+  std::vector<uint8_t> header;
+  ByteWriter header_writer(header);
+  header_writer.WriteBytes(kMagic, sizeof(kMagic));
+  header_writer.WriteVarint(kVersion);
+  if (!WriteToStream(stream, header.data(), header.size())) return false;
+
+  // Reused for every block
+  std::vector<uint8_t> compressed;
+  compressed.reserve(kMaxCompressionBlockSize);
+  const auto write_block = [&](const uint8_t* data, size_t size) {
+    compressed.clear();
+    const bool is_compressed =
+        compress && CompressBlock(data, size, compressed);
+    header.clear();
+    header_writer.WriteVarint(size);
+    header_writer.WriteVarint(is_compressed ? compressed.size() : size);
+    if (is_compressed) {
+      data = compressed.data();
+      size = compressed.size();
+    }
+    return WriteToStream(stream, header.data(), header.size()) &&
+           WriteToStream(stream, data, size);
+  };
+
+  std::vector<uint8_t> buffer;
+  ByteWriter writer(buffer, kMaxCompressionBlockSize, write_block);
+  writer.WriteString(level.name());
+  writer.WriteString(level.category());
+  writer.WriteString(level.file_path().generic_string());
+  writer.WriteVarint(level.seed());
+  level.WriteLayout(writer);
+  level.WriteState(writer);
+  const bool flushed = writer.Flush();
+  header.clear();
+  header_writer.WriteVarint(0);  // End of the blocks
+  return flushed && WriteToStream(stream, header.data(), header.size());
+}
+
+}  // namespace
+
+bool SaveGame(const Level& level, const std::filesystem::path& path,
+              bool compress) {
+  // Written to a temporary file first, so that a crash never leaves a
+  // truncated save behind, nor destroys the previous one
+  std::filesystem::path temporary_path = path;
+  temporary_path += ".tmp";
+  {
+    std::ofstream stream(temporary_path, std::ios::binary | std::ios::trunc);
+    if (!stream.is_open()) {
+      std::cerr << "Failed to open save file: " << temporary_path
+                << std::endl;
+      return false;
+    }
+    if (!WriteGame(level, stream, compress) || !stream.flush()) {
+      std::cerr << "Failed to write save file: " << path << std::endl;
+      stream.close();
+      std::error_code ec;
+      std::filesystem::remove(temporary_path, ec);
+      return false;
+    }
+  }
+
+  std::error_code ec;
+  std::filesystem::rename(temporary_path, path, ec);
+  if (ec) {
+    std::cerr << "Failed to write save file: " << path << " ("
+              << ec.message() << ")" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+std::shared_ptr<Level> LoadGame(const std::filesystem::path& path) {
+  std::ifstream stream(path, std::ios::binary);
+  if (!stream.is_open()) {
+    std::cerr << "Failed to open save file: " << path << std::endl;
+    return nullptr;
+  }
+  const std::vector<uint8_t> file(std::istreambuf_iterator<char>(stream),
+                                  {});
+  ByteReader file_reader(file);
+
+  uint8_t magic[sizeof(kMagic)];
+  uint64_t version;
+  std::vector<uint8_t> data;
+  if (!file_reader.ReadBytes(magic, sizeof(magic)) ||
+      !std::equal(std::begin(kMagic), std::end(kMagic), magic) ||
+      !file_reader.ReadVarint(version)) {
+    std::cerr << "Invalid save file: " << path << std::endl;
+    return nullptr;
+  }
+  if (version == 0 || version > kVersion) {
+    std::cerr << "Unsupported save file version " << version << ": " << path
+              << std::endl;
+    return nullptr;
+  }
+  if (!ReadBlocks(file_reader, file.size(), data)) {
+    std::cerr << "Invalid save file: " << path << std::endl;
+    return nullptr;
+  }
+
+  ByteReader reader(data);
+  std::string name, category, file_path;
+  uint64_t seed;
+  if (!reader.ReadString(name) || !reader.ReadString(category) ||
+      !reader.ReadString(file_path) || !reader.ReadVarint(seed)) {
+    std::cerr << "Invalid save file: " << path << std::endl;
+    return nullptr;
+  }
+  auto level = std::make_shared<Level>(std::move(name), std::move(category),
+                                       std::move(file_path));
+  level->set_seed(seed);
+  const size_t stream_count =
+      version < kBanditStreamVersion ? 1 : kRandomStreamCount;
+  if (!level->ReadLayout(reader) || !level->ReadState(reader, stream_count)) {
+    std::cerr << "Invalid save file: " << path << std::endl;
+    return nullptr;
+  }
+  return level;
+}
+
+}  // namespace konkr
@@ -0,0 +1,36 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+//
+// save_game.h
+//
+// Declares the functions saving a game in progress to a file and loading it
+// back.
+//
+
+#ifndef KONKR_RENDERING_SAVE_GAME_H
+#define KONKR_RENDERING_SAVE_GAME_H
+
+#include <filesystem>
+#include <memory>
+
+#include "rendering/level.h"
+
+namespace konkr {
+
+// Writes the whole game: the level (name, category, map), its seed, and its
+// state (see Level::WriteState). The data is streamed to the file in blocks
+// of kMaxCompressionBlockSize bytes, each compressed if compress is true and
+// the block gets smaller, to path + ".tmp", which then replaces the file at
+// path: a failed save leaves the previous one as it was.
+bool SaveGame(const Level& level, const std::filesystem::path& path,
+              bool compress = true);
+
+// Reads a game written by SaveGame, nullptr if it can't be read. The tiles
+// are created straight from the saved layout and state, the level file isn't
+// needed.
+std::shared_ptr<Level> LoadGame(const std::filesystem::path& path);
+
+}  // namespace konkr
+
+#endif  // KONKR_RENDERING_SAVE_GAME_H
@@ -0,0 +1,136 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+
+#include "rendering/simulation.h"
+
+#include <algorithm>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#include "rendering/save_game.h"
+
+namespace konkr {
+
+Simulation::Simulation(std::shared_ptr<Level> level,
+                       std::filesystem::path replay_path,
+                       std::filesystem::path autosave_path,
+                       std::unique_ptr<ComputerPlayer> computer_player,
+                       std::set<int> computer_player_ids)
+    : level_(std::move(level)),
+      replay_path_(std::move(replay_path)),
+      autosave_path_(std::move(autosave_path)),
+      computer_player_(std::move(computer_player)),
+      computer_player_ids_(std::move(computer_player_ids)) {
+  command_log_.Begin(*level_);
+  // The first snapshot is ready before the thread starts, so there is always
+  // something to draw
+  PublishSnapshot();
+  snapshots_.Update();
+  thread_ = std::thread([this] { Run(); });
+}
+
+Simulation::~Simulation() {
+  stop_ = true;
+  wake_count_.fetch_add(1);
+  wake_count_.notify_one();
+  thread_.join();
+  for (const auto& [snapshot, subscriber] : snapshot_subscribers_) {
+    level_->change_bus().Unsubscribe(subscriber);
+  }
+  if (!replay_path_.empty()) {
+    command_log_.WriteToFile(replay_path_);
+  }
+}
+
+bool Simulation::Post(const GameCommand& command) {
+  if (!commands_.TryPush(command)) {
+    std::cerr << "Simulation command queue full, dropping a command"
+              << std::endl;
+    return false;
+  }
+  wake_count_.fetch_add(1);
+  wake_count_.notify_one();
+  return true;
+}
+
+const RenderSnapshot& Simulation::LatestSnapshot() {
+  snapshots_.Update();
+  return snapshots_.front();
+}
+
+void Simulation::Run() {
+  PlayComputerTurns();
+  uint32_t seen_count = 0;
+  while (true) {
+    wake_count_.wait(seen_count);
+    // Commands posted after this load wake the thread up again
+    seen_count = wake_count_.load();
+    if (stop_) return;
+
+    bool changed = false;
+    while (auto command = commands_.TryPop()) {
+      if (IsComputerTurn()) continue;
+      Apply(*command);
+      changed = true;
+    }
+    if (changed) PublishSnapshot();
+    PlayComputerTurns();
+  }
+}
+
+void Simulation::Apply(const GameCommand& command) {
+  level_->ApplyCommand(command);
+  Record(command);
+}
+
+void Simulation::Record(const GameCommand& command) {
+  command_log_.Record(command, *level_);
+  if (command.type == GameCommand::Type::NextTurn && !autosave_path_.empty()) {
+    SaveGame(*level_, autosave_path_);
+  }
+}
+
+bool Simulation::IsComputerTurn() const {
+  if (!computer_player_ || level_->active_players_count() <= 1) return false;
+  auto player = level_->get_current_player();
+  return player && computer_player_ids_.contains(player->id());
+}
+
+void Simulation::PlayComputerTurns() {
+  while (!stop_ && IsComputerTurn()) {
+    std::vector<GameCommand> commands = computer_player_->ChooseTurn(*level_);
+    if (commands.empty() || !level_->ApplyActions(commands)) {
+      std::cerr << "Computer player chose an invalid command, ending its turn"
+                << std::endl;
+      commands = {{GameCommand::Type::NextTurn}};
+      level_->ApplyCommand(commands.front());
+    }
+    for (const GameCommand& command : commands) {
+      Record(command);
+    }
+    PublishSnapshot();
+  }
+}
+
+void Simulation::PublishSnapshot() {
+  level_->UpdateEconomy();
+  RenderSnapshot& snapshot = snapshots_.back();
+  auto subscriber = std::find_if(
+      snapshot_subscribers_.begin(), snapshot_subscribers_.end(),
+      [&snapshot](const auto& entry) { return entry.first == &snapshot; });
+  if (subscriber == snapshot_subscribers_.end()) {
+    snapshot_subscribers_.emplace_back(&snapshot,
+                                       level_->change_bus().Subscribe());
+    CaptureRenderSnapshot(*level_, snapshot);
+  } else {
+    UpdateRenderSnapshot(
+        *level_, level_->change_bus().Drain(subscriber->second), snapshot);
+  }
+  // The back buffer was last filled two snapshots ago
+  snapshot.version = ++version_;
+  snapshots_.Publish();
+}
+
+}  // namespace konkr
@@ -0,0 +1,107 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+//
+// simulation.h
+//
+// Declares the Simulation class, which runs the game logic of a level on its
+// own thread and publishes snapshots of it for rendering.
+//
+
+#ifndef KONKR_RENDERING_SIMULATION_H
+#define KONKR_RENDERING_SIMULATION_H
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <set>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "core/spsc_queue.h"
+#include "core/triple_buffer.h"
+#include "rendering/command_log.h"
+#include "rendering/computer_player.h"
+#include "rendering/game_command.h"
+#include "rendering/level.h"
+#include "rendering/render_snapshot.h"
+
+namespace konkr {
+
+// Owns the level while the game is played: only the simulation thread
+// touches it. The UI thread posts commands through a lock-free queue, and
+// after applying them the simulation publishes a RenderSnapshot through a
+// triple buffer, so a slow turn never blocks the rendering or the input.
+//
+// Every command applied is recorded in a CommandLog, written to replay_path
+// (if not empty) when the simulation stops, so that a game can be replayed.
+// The game is saved to autosave_path (if not empty) after every turn, on the
+// simulation thread.
+//
+// Each of the three snapshots subscribes to the ChangeBus of the level, so
+// filling one again only captures the tiles changed since it was last filled.
+//
+// During the turns of the players in computer_player_ids, computer_player
+// chooses the commands, on the simulation thread, and the commands posted
+// are ignored.
+class Simulation {
+ public:
+  // Starts the simulation thread. The level must not be used by anyone else
+  // until the simulation is destroyed.
+  explicit Simulation(std::shared_ptr<Level> level,
+                      std::filesystem::path replay_path = {},
+                      std::filesystem::path autosave_path = {},
+                      std::unique_ptr<ComputerPlayer> computer_player = nullptr,
+                      std::set<int> computer_player_ids = {});
+  ~Simulation();
+
+  Simulation(const Simulation&) = delete;
+  Simulation& operator=(const Simulation&) = delete;
+
+  // UI thread: queues a command for the simulation thread. Returns false if
+  // the queue is full, in which case the command is dropped.
+  bool Post(const GameCommand& command);
+
+  // Render thread: returns the latest published snapshot, without waiting.
+  // The reference is valid until the next call.
+  const RenderSnapshot& LatestSnapshot();
+
+ private:
+  static constexpr size_t kCommandQueueSize = 64;
+
+  void Run();
+  void Apply(const GameCommand& command);
+  // Logs a command applied, and saves the game after a NextTurn
+  void Record(const GameCommand& command);
+  bool IsComputerTurn() const;
+  // Plays the turns of the computer until a human player's turn, applying
+  // the commands it chooses at once as a batch (see Level::ApplyActions) and
+  // publishing a snapshot after every batch
+  void PlayComputerTurns();
+  void PublishSnapshot();
+
+  std::shared_ptr<Level> level_;
+  // Only used by the simulation thread, then written by the destructor
+  CommandLog command_log_;
+  std::filesystem::path replay_path_;
+  std::filesystem::path autosave_path_;
+  std::unique_ptr<ComputerPlayer> computer_player_;
+  std::set<int> computer_player_ids_;
+  SpscQueue<GameCommand, kCommandQueueSize> commands_;
+  TripleBuffer<RenderSnapshot> snapshots_;
+  // Incremented for every command posted, the simulation thread sleeps
+  // while it doesn't change
+  std::atomic<uint32_t> wake_count_ = 0;
+  std::atomic<bool> stop_ = false;
+  uint64_t version_ = 0;
+  // The snapshots of snapshots_ filled once, and their subscriptions to the
+  // change bus of the level
+  std::vector<std::pair<const RenderSnapshot*, size_t>> snapshot_subscribers_;
+  std::thread thread_;
+};
+
+}  // namespace konkr
+
+#endif  // KONKR_RENDERING_SIMULATION_H
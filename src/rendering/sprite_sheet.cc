@@ -4,43 +4,91 @@
 
 #include "rendering/sprite_sheet.h"
 
+#include <algorithm>
 #include <filesystem>
-#include <fstream>
 #include <iostream>
-#include <nlohmann/json.hpp>
 #include <optional>
 #include <stdexcept>
 #include <string>
-#include <utility>
+#include <string_view>
 #include <vector>
 
 #include "rendering/graphics.h"
+#include "rendering/packed_image.h"
+#include "rendering/sprite_table.h"
 
 namespace konkr {
 
-bool SpriteSheet::LoadFromFile(const std::filesystem::path& file_path) {
-  auto loaded_texture = Graphics::LoadTexture(file_path.string());
-  if (!loaded_texture) {
-    return false;
+namespace {
+
+SpriteInfo ToSpriteInfo(const sprite_table::Frame& frame, int mip_level = 0) {
+  const sprite_table::Rect& rect = frame.rects[mip_level];
+  return SpriteInfo{IntRect({rect.x, rect.y}, {rect.width, rect.height})};
+}
+
+}  // namespace
+
+SpriteSheet::SpriteSheet() {
+  static_assert(sprite_table::kEntityFrames.size() == Entity::kEntityTypeCount,
+                "The sprite table is out of date with Entity::EntityType");
+  static_assert(sprite_table::kMaxEntityLevels <= EntitySprites::kMaxLevels,
+                "Too many sprites for an entity type");
+  static_assert(sprite_table::kMipLevels <= kMaxMipLevels,
+                "Too many mip levels in the sprite table");
+
+  mip_levels_ = sprite_table::kMipLevels;
+  for (size_t type = 0; type < Entity::kEntityTypeCount; ++type) {
+    const auto& frames = sprite_table::kEntityFrames[type];
+    EntitySprites& sprites = entity_sprites_[type];
+    sprites.count = frames.count;
+    for (int mip = 0; mip < mip_levels_; ++mip) {
+      for (int level = 0; level < frames.count; ++level) {
+        sprites.mips[mip][level] =
+            ToSpriteInfo(sprite_table::kFrames[frames.frames[level]], mip);
+      }
+    }
   }
+}
 
-  texture_ = std::move(*loaded_texture);
-  loaded_ = true;
-  return true;
+void SpriteSheet::Prefetch(const std::filesystem::path& file_path) const {
+  for (int mip = 0; mip < mip_levels_; ++mip) {
+    ResourceCache::GetInstance().Load<Texture>(MipPagePath(file_path, mip));
+  }
 }
 
-void SpriteSheet::AddSpriteInfo(const std::string& name,
-                                const SpriteInfo& sprite_info) {
-  sprites_map_.emplace(name, sprite_info);
+bool SpriteSheet::LoadFromFile(const std::filesystem::path& file_path) {
+  // Requests every page before waiting for any, so they decode in parallel
+  for (int mip = 0; mip < mip_levels_; ++mip) {
+    textures_[mip] =
+        ResourceCache::GetInstance().Load<Texture>(MipPagePath(file_path, mip));
+  }
+  for (int mip = 0; mip < mip_levels_; ++mip) {
+    if (!textures_[mip].is_loaded()) {
+      return false;
+    }
+    const auto size = textures_[mip].get().get_size();
+    const auto& expected = sprite_table::kPageSizes[mip];
+    if (size.x != expected.width || size.y != expected.height) {
+      std::cerr << "The texture " << MipPagePath(file_path, mip)
+                << " doesn't match the sprite table, rebuild the game."
+                << std::endl;
+      return false;
+    }
+  }
+  loaded_ = true;
+  return true;
 }
 
 std::optional<SpriteInfo> SpriteSheet::GetSpriteInfo(
     const std::string& name) const {
-  auto it = sprites_map_.find(name);
-  if (it != sprites_map_.end()) {
-    return it->second;
+  const auto& frames = sprite_table::kFrames;
+  auto it = std::lower_bound(frames.begin(), frames.end(), name,
+                             [](const sprite_table::Frame& frame,
+                                std::string_view n) { return frame.name < n; });
+  if (it != frames.end() && it->name == name) {
+    return ToSpriteInfo(*it);
   }
-  std::cerr << "Sprite '" << name << "' not found in loaded sprite definitions."
+  std::cerr << "Sprite '" << name << "' not found in the sprite table."
             << std::endl;
   return std::nullopt;
 }
@@ -56,161 +104,33 @@ std::unique_ptr<Sprite> SpriteSheet::CreateSprite(
   if (!sprite_info) {
     return nullptr;
   }
-  return Graphics::CreateSprite(texture_, sprite_info->rect);
+  return Graphics::CreateSprite(textures_[0].get(), sprite_info->rect);
 }
 
-const Texture& SpriteSheet::GetTexture() const {
+const Texture& SpriteSheet::GetTexture(int mip_level) const {
   if (!loaded_) {
     throw std::runtime_error(
         "SpriteSheet::getTexture() called before loading the texture.");
   }
-  return texture_;
+  return textures_[mip_level].get();
 }
 
-bool SpriteSheet::LoadSpriteDefinitions(
-    const std::filesystem::path& definition_file_path) {
-  std::ifstream definition_stream(definition_file_path);
-  if (!definition_stream.is_open()) {
-    std::cerr << "Failed to open sprite definition file: "
-              << definition_file_path << std::endl;
-    return false;
-  }
-
-  nlohmann::json json_data;
-  try {
-    json_data = nlohmann::json::parse(definition_stream);
-  } catch (nlohmann::json::parse_error& e) {
-    std::cerr << "Failed to parse JSON: " << e.what() << std::endl;
-    return false;
-  }
-
-  try {
-    if (!json_data.contains("textures") || !json_data["textures"].is_array() ||
-        json_data["textures"].empty()) {
-      std::cerr << "Invalid JSON format: 'textures' array is missing or empty."
-                << std::endl;
-      return false;
-    }
-
-    const nlohmann::json& textures_data = json_data["textures"][0];
-
-    if (!textures_data.contains("frames") ||
-        !textures_data["frames"].is_array()) {
-      std::cerr << "Invalid JSON format: 'frames' array is missing."
-                << std::endl;
-      return false;
-    }
-
-    for (const auto& sprite_data : textures_data["frames"]) {
-      if (!sprite_data.is_object() || !sprite_data.contains("filename") ||
-          !sprite_data["filename"].is_string() ||
-          !sprite_data.contains("frame") || !sprite_data["frame"].is_object() ||
-          !sprite_data["frame"].contains("x") ||
-          !sprite_data["frame"]["x"].is_number_integer() ||
-          !sprite_data["frame"].contains("y") ||
-          !sprite_data["frame"]["y"].is_number_integer() ||
-          !sprite_data["frame"].contains("w") ||
-          !sprite_data["frame"]["w"].is_number_integer() ||
-          !sprite_data["frame"].contains("h") ||
-          !sprite_data["frame"]["h"].is_number_integer()) {
-        std::string filename =
-            (sprite_data.is_object() && sprite_data.contains("filename")) &&
-                    sprite_data["filename"].is_string()
-                ? sprite_data["filename"].get<std::string>()
-                : "unknown";
-
-        std::cerr << "Invalid sprite data format for sprite: " << filename
-                  << std::endl;
-        // if there's a mistake, we continue, let's see if we can load the rest
-        continue;
-      }
-
-      std::string filename = sprite_data["filename"].get<std::string>();
-      int x = sprite_data["frame"]["x"].get<int>();
-      int y = sprite_data["frame"]["y"].get<int>();
-      int width = sprite_data["frame"]["w"].get<int>();
-      int height = sprite_data["frame"]["h"].get<int>();
-
-      AddSpriteInfo(filename, SpriteInfo{IntRect({x, y}, {width, height})});
-    }
-  } catch (nlohmann::json::exception& e) {
-    std::cerr << "Error processing JSON in sprite definition file: "
-              << definition_file_path << std::endl;
-    return false;
+int SpriteSheet::GetMipLevel(float scale) const {
+  int mip_level = 0;
+  while (mip_level + 1 < mip_levels_ && scale <= 0.5f) {
+    scale *= 2;
+    ++mip_level;
   }
-
-  std::cout << "Successfully loaded " << sprites_map_.size() << " sprites from "
-            << definition_file_path << std::endl;
-  return true;
+  return mip_level;
 }
 
 std::vector<std::string> SpriteSheet::GetAllSpriteNames() const {
   std::vector<std::string> sprite_names;
-  sprite_names.reserve(sprites_map_.size());
-  for (const auto& pair : sprites_map_) {
-    sprite_names.push_back(pair.first);
+  sprite_names.reserve(sprite_table::kFrames.size());
+  for (const auto& frame : sprite_table::kFrames) {
+    sprite_names.emplace_back(frame.name);
   }
   return sprite_names;
 }
 
-bool SpriteSheet::LoadEntitySpriteMappings(
-    const std::filesystem::path& mapping_file_path) {
-  std::ifstream mapping_stream(mapping_file_path);
-  if (!mapping_stream.is_open()) {
-    std::cerr << "Failed to open entity sprite mapping file: "
-              << mapping_file_path << std::endl;
-    return false;
-  }
-
-  nlohmann::json json_data;
-
-  try {
-    mapping_stream >> json_data;
-  } catch (nlohmann::json::parse_error& e) {
-    std::cerr << "Failed to parse JSON: " << e.what() << std::endl;
-    return false;
-  }
-
-  entity_sprite_vectors_.clear();
-  for (auto it = json_data.begin(); it != json_data.end(); ++it) {
-    if (it.value().is_array()) {
-      std::vector<std::string> sprite_names;
-      for (const auto& sprite_name : it.value()) {
-        if (sprite_name.is_string()) {
-          sprite_names.push_back(sprite_name.get<std::string>());
-        } else {
-          std::cerr << "Invalid sprite name format in entity mapping: "
-                    << sprite_name.dump() << std::endl;
-        }
-      }
-      entity_sprite_vectors_[it.key()] = std::move(sprite_names);
-    }
-  }
-
-  return true;
-}
-
-std::optional<std::string> SpriteSheet::GetSpriteNameForEntity(
-    const Entity::EntityType& entity_type, int level) const {
-  const std::string entity_type_str =
-      Entity::entity_type_to_string(entity_type);
-  auto it = entity_sprite_vectors_.find(entity_type_str);
-  if (it != entity_sprite_vectors_.end() && level >= 0 &&
-      level < static_cast<int>(it->second.size())) {
-    return it->second[level];
-  }
-  return std::nullopt;
-}
-
-int SpriteSheet::GetEntitySpriteArraySize(
-    const Entity::EntityType& entity_type) const {
-  const std::string entity_type_str =
-      Entity::entity_type_to_string(entity_type);
-  auto it = entity_sprite_vectors_.find(entity_type_str);
-  if (it != entity_sprite_vectors_.end()) {
-    return static_cast<int>(it->second.size());
-  }
-  return 0;
-}
-
-}  // namespace konkr
\ No newline at end of file
+}  // namespace konkr
@@ -4,20 +4,21 @@
 //
 // sprite_sheet.h
 //
-// Declares the SpriteSheet class, which manages loading sprite textures and
-// definitions from files, and provides access to individual sprite rectangles
-// for rendering.
+// Declares the SpriteSheet class, which gives access to the sprite atlas: its
+// texture and the rectangles of the individual sprites, compiled into the game
+// by the atlas compiler (see tools/atlas_compiler.cc).
 
 #ifndef KONKR_RENDERING_SPRITE_SHEET_H
 #define KONKR_RENDERING_SPRITE_SHEET_H
 
+#include <array>
 #include <filesystem>
 #include <optional>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
 #include "rendering/graphics.h"
+#include "rendering/resource_cache.h"
 #include "world/entity.h"
 
 namespace konkr {
@@ -27,56 +28,80 @@ struct SpriteInfo {
   IntRect rect;
 };
 
-// Manages loading and storing the sprite definitions (name and frame) from the
-// JSON file and the texture from the PNG file. It also provides methods to
-// create sprites and retrieve sprite information.
+// Holds the atlas textures and provides methods to create sprites and
+// retrieve sprite information. The sprite definitions are constexpr tables
+// generated at build time from atlas.json and entity_sprites.json, so only the
+// textures are loaded at runtime.
+//
+// Besides the atlas, the atlas compiler writes downscaled pages (mip levels),
+// each half the size of the previous one. Sprites drawn smaller than their
+// native size use the page closest to the size they are drawn at.
 class SpriteSheet {
  public:
+  // Radius of the tiles at which the entity sprites are drawn at the native
+  // resolution of the atlas
+  static constexpr float kNativeHexRadius = 50.0f;
+  static constexpr int kMaxMipLevels = 8;
+
   static SpriteSheet& GetInstance() {
     static SpriteSheet instance;
     return instance;
   }
 
-  inline const std::unordered_map<std::string, std::vector<std::string>>&
-  entity_sprite_vectors() const {
-    return entity_sprite_vectors_;
-  }
+  // Starts decoding the textures of every mip level in the background
+  void Prefetch(const std::filesystem::path& file_path) const;
 
-  // Stores the texture in texture_
+  // Gets the textures from the ResourceCache, which decodes them in the
+  // background if they weren't prefetched. file_path is the packed image
+  // written by the atlas compiler next to the game's assets, the downscaled
+  // pages are next to it.
   bool LoadFromFile(const std::filesystem::path& file_path);
 
-  // Adds a sprite's name and its corresponding rectangle to the sprites_map_
-  void AddSpriteInfo(const std::string& name, const SpriteInfo& sprite_info);
-
   // Retrieves the sprite's rectangle based on its name
   std::optional<SpriteInfo> GetSpriteInfo(const std::string& name) const;
 
-  // Creates a sprite using the texture and the rectangle from the sprites_map_
+  // Creates a sprite using the texture and the rectangle of the named sprite
   std::unique_ptr<Sprite> CreateSprite(const std::string& name) const;
 
-  // Returns the texture used for the sprites.
-  const Texture& GetTexture() const;
-
-  bool LoadSpriteDefinitions(const std::filesystem::path& definition_file_path);
+  // Returns the texture used for the sprites, at the given mip level.
+  const Texture& GetTexture(int mip_level = 0) const;
 
   std::vector<std::string> GetAllSpriteNames() const;
 
-  bool LoadEntitySpriteMappings(const std::filesystem::path& mapping_file_path);
-
-  std::optional<std::string> GetSpriteNameForEntity(
-      const Entity::EntityType& entity_type, int level = 0) const;
+  // Returns the mip level to draw sprites scaled by scale (1 being their
+  // native size) with: the smallest one at least as large as the drawn size.
+  int GetMipLevel(float scale) const;
+
+  // Returns the sprite of the entity type at the given level, in the page of
+  // the given mip level, nullptr if there is none
+  inline const SpriteInfo* GetEntitySpriteInfo(Entity::EntityType entity_type,
+                                               int level = 0,
+                                               int mip_level = 0) const {
+    const EntitySprites& sprites =
+        entity_sprites_[static_cast<size_t>(entity_type)];
+    if (level < 0 || level >= sprites.count) return nullptr;
+    return &sprites.mips[mip_level][level];
+  }
 
-  int GetEntitySpriteArraySize(const Entity::EntityType& entity_type) const;
+  inline int GetEntitySpriteArraySize(Entity::EntityType entity_type) const {
+    return entity_sprites_[static_cast<size_t>(entity_type)].count;
+  }
 
  private:
-  SpriteSheet() = default;
+  SpriteSheet();
   SpriteSheet(const SpriteSheet&) = delete;
   SpriteSheet& operator=(const SpriteSheet&) = delete;
 
-  Texture texture_;
-  std::unordered_map<std::string, SpriteInfo> sprites_map_;
-  std::unordered_map<std::string, std::vector<std::string>>
-      entity_sprite_vectors_;
+  // Indexed by mip level
+  std::array<ResourceHandle<Texture>, kMaxMipLevels> textures_;
+  int mip_levels_ = 1;
+  // Sprites of each entity type, indexed by mip level and level
+  struct EntitySprites {
+    static constexpr int kMaxLevels = 8;
+    std::array<std::array<SpriteInfo, kMaxLevels>, kMaxMipLevels> mips;
+    int count = 0;
+  };
+  std::array<EntitySprites, Entity::kEntityTypeCount> entity_sprites_;
   bool loaded_ = false;
 };
 
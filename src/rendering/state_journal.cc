@@ -0,0 +1,315 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+
+#include "rendering/state_journal.h"
+
+#include <algorithm>
+
+#include "world/townhall.h"
+
+namespace konkr {
+
+namespace {
+
+void CopyEntity(const Entity* entity, TileRecord& record) {
+  record.flags &= ~(TileRecord::kHasEntity | TileRecord::kMoved);
+  if (!entity) {
+    record.entity = Entity::EntityType::Unknown;
+    record.entity_level = 0;
+    record.entity_upkeep = 0;
+    record.money = 0;
+    return;
+  }
+  record.flags |= TileRecord::kHasEntity;
+  if (entity->has_moved()) record.flags |= TileRecord::kMoved;
+  record.entity = entity->type();
+  record.entity_level = static_cast<int8_t>(entity->level());
+  record.entity_upkeep = entity->upkeep_cost();
+  record.money = entity->type() == Entity::EntityType::Townhall
+                     ? static_cast<const Townhall*>(entity)->money()
+                     : 0;
+}
+
+TileRecord ToRecord(const Tile& tile) {
+  TileRecord record;
+  record.owner = static_cast<int8_t>(tile.get_owner().value_or(-1));
+  if (tile.is_orphan()) record.flags |= TileRecord::kOrphan;
+  record.level = static_cast<int8_t>(tile.level());
+  record.walls = static_cast<uint8_t>(tile.walls_mask());
+  CopyEntity(tile.entity().get(), record);
+  return record;
+}
+
+void SetOwner(Tile& tile, int owner) {
+  if (owner < 0) {
+    tile.remove_owner();
+  } else {
+    tile.change_owner(owner);
+  }
+}
+
+void SetOrphan(Tile& tile, bool orphan) {
+  if (orphan) {
+    tile.orphan();
+  } else {
+    tile.claim();
+  }
+}
+
+void SetWalls(Tile& tile, int walls) {
+  for (int wall = 0; wall < 6; ++wall) {
+    if (walls & (1 << wall)) {
+      tile.add_wall(static_cast<WallPosition>(wall));
+    } else {
+      tile.remove_wall(static_cast<WallPosition>(wall));
+    }
+  }
+}
+
+void SetMoney(Entity& entity, int money) {
+  if (entity.is_townhall()) {
+    static_cast<Townhall&>(entity).restore_money(money);
+  }
+}
+
+// Sets tile to its state in record, returns whether a building appeared or
+// disappeared
+bool ApplyRecord(Tile& tile, const TileRecord& record) {
+  SetOwner(tile, record.owner);
+  SetOrphan(tile, record.flags & TileRecord::kOrphan);
+  tile.set_level(record.level);
+  SetWalls(tile, record.walls);
+
+  const auto& entity = tile.entity();
+  const bool has_entity = record.flags & TileRecord::kHasEntity;
+  const bool was_building = entity && entity->is_building();
+  if (!has_entity) {
+    tile.set_entity(nullptr);
+    return was_building;
+  }
+  if (!entity || entity->type() != record.entity) {
+    tile.set_entity(CreateEntity(record.entity));
+  }
+  tile.entity()->setLevel(record.entity_level);
+  tile.entity()->set_upkeep_cost(record.entity_upkeep);
+  SetMoney(*tile.entity(), record.money);
+  tile.entity()->set_moved(record.flags & TileRecord::kMoved);
+  return was_building != tile.entity()->is_building();
+}
+
+}  // namespace
+
+void StateJournal::Reset(const Tiles& tiles) {
+  columns_ = 0;
+  for (const auto& row : tiles) {
+    columns_ = std::max(columns_, row.size());
+  }
+  const size_t size = tiles.size() * columns_;
+  chunks_.clear();
+  for (size_t i = 0; i < size; i += TileChunk::kChunkSize) {
+    chunks_.push_back(std::make_shared<TileChunk>());
+  }
+  for (const auto& row : tiles) {
+    for (const auto& tile : row) {
+      if (!tile) continue;
+      MutableRecord(tile->grid_position()) = ToRecord(*tile);
+    }
+  }
+  ClearHistory();
+}
+
+TileRecord& StateJournal::MutableRecord(Vector2i position) {
+  const size_t index = position.x * columns_ + position.y;
+  auto& chunk = chunks_[index / TileChunk::kChunkSize];
+  if (chunk.use_count() > 1) {
+    chunk = std::make_shared<TileChunk>(*chunk);
+  }
+  return chunk->records[index % TileChunk::kChunkSize];
+}
+
+void StateJournal::OnTileChanged(Vector2i position, TileField field,
+                                 int old_value, int new_value) {
+  if (field == TileField::Reachable) return;
+  if (recording_ && !replaying_) {
+    changes_.push_back({.position = position,
+                        .field = field,
+                        .old_value = old_value,
+                        .new_value = new_value});
+  }
+
+  TileRecord& record = MutableRecord(position);
+  switch (field) {
+    case TileField::Owner:
+      record.owner = static_cast<int8_t>(new_value);
+      break;
+    case TileField::Orphan:
+      record.flags = new_value ? record.flags | TileRecord::kOrphan
+                               : record.flags & ~TileRecord::kOrphan;
+      break;
+    case TileField::Reachable:
+      break;
+    case TileField::Level:
+      record.level = static_cast<int8_t>(new_value);
+      break;
+    case TileField::Walls:
+      record.walls = static_cast<uint8_t>(new_value);
+      break;
+    case TileField::EntityLevel:
+      record.entity_level = static_cast<int8_t>(new_value);
+      break;
+    case TileField::EntityUpkeep:
+      record.entity_upkeep = new_value;
+      break;
+    case TileField::Money:
+      record.money = new_value;
+      break;
+    case TileField::Moved:
+      record.flags = new_value ? record.flags | TileRecord::kMoved
+                               : record.flags & ~TileRecord::kMoved;
+      break;
+  }
+}
+
+void StateJournal::OnEntityChanged(Vector2i position,
+                                   const std::shared_ptr<Entity>& old_entity,
+                                   const std::shared_ptr<Entity>& new_entity) {
+  if (recording_ && !replaying_) {
+    changes_.push_back({.position = position,
+                        .entity_change = true,
+                        .old_entity = old_entity,
+                        .new_entity = new_entity});
+  }
+  CopyEntity(new_entity.get(), MutableRecord(position));
+}
+
+void StateJournal::BeginAction() {
+  // The actions undone can't be redone anymore
+  if (done_actions_ < actions_.size()) {
+    changes_.erase(changes_.begin() + actions_[done_actions_], changes_.end());
+    actions_.resize(done_actions_);
+  }
+  actions_.push_back(changes_.size());
+  recording_ = true;
+}
+
+void StateJournal::EndAction() {
+  recording_ = false;
+  if (changes_.size() == actions_.back()) {
+    actions_.pop_back();  // Nothing to undo
+  } else {
+    done_actions_ = actions_.size();
+  }
+}
+
+void StateJournal::CancelAction(Tiles& tiles) {
+  recording_ = false;
+  const size_t begin = actions_.back();
+  replaying_ = true;
+  for (size_t i = changes_.size(); i > begin; --i) {
+    Apply(tiles, changes_[i - 1], /*undo=*/true);
+  }
+  replaying_ = false;
+  changes_.resize(begin);
+  actions_.pop_back();
+}
+
+void StateJournal::ClearHistory() {
+  changes_.clear();
+  actions_.clear();
+  done_actions_ = 0;
+  recording_ = false;
+}
+
+bool StateJournal::Undo(Tiles& tiles) {
+  if (!can_undo()) return false;
+  --done_actions_;
+  const size_t begin = actions_[done_actions_];
+  const size_t end = done_actions_ + 1 < actions_.size()
+                         ? actions_[done_actions_ + 1]
+                         : changes_.size();
+  replaying_ = true;
+  for (size_t i = end; i > begin; --i) {
+    Apply(tiles, changes_[i - 1], /*undo=*/true);
+  }
+  replaying_ = false;
+  return true;
+}
+
+bool StateJournal::Redo(Tiles& tiles) {
+  if (!can_redo()) return false;
+  const size_t begin = actions_[done_actions_];
+  ++done_actions_;
+  const size_t end = done_actions_ < actions_.size() ? actions_[done_actions_]
+                                                     : changes_.size();
+  replaying_ = true;
+  for (size_t i = begin; i < end; ++i) {
+    Apply(tiles, changes_[i], /*undo=*/false);
+  }
+  replaying_ = false;
+  return true;
+}
+
+void StateJournal::Apply(Tiles& tiles, const Change& change, bool undo) {
+  Tile& tile = *tiles[change.position.x][change.position.y];
+  if (change.entity_change) {
+    tile.set_entity(undo ? change.old_entity : change.new_entity);
+    return;
+  }
+
+  const int value = undo ? change.old_value : change.new_value;
+  switch (change.field) {
+    case TileField::Owner:
+      SetOwner(tile, value);
+      break;
+    case TileField::Orphan:
+      SetOrphan(tile, value);
+      break;
+    case TileField::Reachable:  // Never recorded
+      break;
+    case TileField::Level:
+      tile.set_level(value);
+      break;
+    case TileField::Walls:
+      SetWalls(tile, value);
+      break;
+    case TileField::EntityLevel:
+      tile.entity()->setLevel(value);
+      break;
+    case TileField::EntityUpkeep:
+      tile.entity()->set_upkeep_cost(value);
+      break;
+    case TileField::Money:
+      SetMoney(*tile.entity(), value);
+      break;
+    case TileField::Moved:
+      tile.entity()->set_moved(value);
+      break;
+  }
+}
+
+bool StateJournal::Restore(const LevelSnapshot& snapshot, Tiles& tiles) {
+  bool buildings_changed = false;
+  replaying_ = true;
+  for (size_t c = 0; c < chunks_.size() && c < snapshot.chunks.size(); ++c) {
+    if (chunks_[c] == snapshot.chunks[c]) continue;
+
+    const size_t first = c * TileChunk::kChunkSize;
+    const size_t last =
+        std::min(first + TileChunk::kChunkSize, tiles.size() * columns_);
+    for (size_t index = first; index < last; ++index) {
+      const size_t row = index / columns_;
+      const size_t column = index % columns_;
+      if (column >= tiles[row].size() || !tiles[row][column]) continue;
+      buildings_changed |= ApplyRecord(
+          *tiles[row][column],
+          snapshot.chunks[c]->records[index - first]);
+    }
+    // Shared again rather than kept as the copy the changes above made
+    chunks_[c] = std::const_pointer_cast<TileChunk>(snapshot.chunks[c]);
+  }
+  replaying_ = false;
+  return buildings_changed;
+}
+
+}  // namespace konkr
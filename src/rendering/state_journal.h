@@ -0,0 +1,158 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+//
+// state_journal.h
+//
+// Declares the StateJournal class, which follows the changes of the tiles of
+// a level to undo them and to take cheap snapshots of them, and the
+// LevelSnapshot struct.
+//
+
+#ifndef KONKR_RENDERING_STATE_JOURNAL_H
+#define KONKR_RENDERING_STATE_JOURNAL_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/random.h"
+#include "rendering/graphics.h"
+#include "world/entity.h"
+#include "world/tile.h"
+#include "world/tile_observer.h"
+
+namespace konkr {
+
+// What changes on a tile during a game, in 16 bytes
+struct TileRecord {
+  enum Flags : uint8_t {
+    kOrphan = 1 << 0,
+    kHasEntity = 1 << 1,
+    kMoved = 1 << 2,  // Of the entity
+  };
+
+  int8_t owner = -1;
+  uint8_t flags = 0;
+  int8_t level = -1;
+  uint8_t walls = 0;
+  Entity::EntityType entity = Entity::EntityType::Unknown;
+  int8_t entity_level = 0;
+  int32_t entity_upkeep = 0;
+  int32_t money = 0;  // Of a townhall
+};
+
+// kChunkSize consecutive tiles of the grid, shared between the journal and
+// the snapshots until the journal changes one of them
+struct TileChunk {
+  static constexpr size_t kChunkSize = 64;
+  std::array<TileRecord, kChunkSize> records;
+};
+
+// State of a level at some point of a game, taken by Level::TakeSnapshot.
+// Taking one copies a pointer per chunk, not the tiles.
+struct LevelSnapshot {
+  struct PlayerRecord {
+    int id = 0;
+    std::string name;
+    std::vector<Vector2i> townhalls;  // Grid positions
+  };
+
+  // The tiles row by row, rows padded to columns tiles
+  std::vector<std::shared_ptr<const TileChunk>> chunks;
+  size_t columns = 0;
+  uint32_t turn = 0;
+  size_t current_player = 0;
+  std::array<uint64_t, kRandomStreamCount> random_counters = {};
+  std::vector<PlayerRecord> players;
+
+  inline const TileRecord& tile(int row, int column) const {
+    const size_t index = row * columns + column;
+    return chunks[index / TileChunk::kChunkSize]
+        ->records[index % TileChunk::kChunkSize];
+  }
+};
+
+// Observes the tiles of a level (see Tile::set_observer) to:
+// - keep a copy of their state in reference-counted chunks: a snapshot
+//   shares the chunks, and a chunk is copied the first time it changes while
+//   shared, so snapshots cost O(chunks) and changes O(1);
+// - record the changes made during actions, so that an action can be undone
+//   and redone in O(changes).
+// The reachable marks of the tiles show the selection of the player, not the
+// state of the game: the journal neither keeps nor records them.
+class StateJournal : public TileObserver {
+ public:
+  using Tiles = std::vector<std::vector<std::shared_ptr<Tile>>>;
+
+  // Copies the state of tiles, whose changes must then be passed to the
+  // journal, and forgets the history
+  void Reset(const Tiles& tiles);
+
+  void OnTileChanged(Vector2i position, TileField field, int old_value,
+                     int new_value) override;
+  void OnEntityChanged(Vector2i position,
+                       const std::shared_ptr<Entity>& old_entity,
+                       const std::shared_ptr<Entity>& new_entity) override;
+
+  // The changes between BeginAction and EndAction are undone together. An
+  // action drops the actions undone before it.
+  void BeginAction();
+  void EndAction();
+  // Reverts the changes since BeginAction on tiles and forgets them, as if
+  // the action never began
+  void CancelAction(Tiles& tiles);
+  void ClearHistory();
+
+  inline bool can_undo() const { return done_actions_ > 0; }
+  inline bool can_redo() const { return done_actions_ < actions_.size(); }
+
+  // Reverts the last action done on tiles, returns false if there is none
+  bool Undo(Tiles& tiles);
+  // Applies the last action undone again, returns false if there is none
+  bool Redo(Tiles& tiles);
+
+  inline size_t columns() const { return columns_; }
+  inline const std::vector<std::shared_ptr<TileChunk>>& chunks() const {
+    return chunks_;
+  }
+
+  // Sets the tiles of the chunks that differ from those of snapshot to their
+  // state in the snapshot, then shares its chunks. Returns whether a
+  // building appeared or disappeared.
+  bool Restore(const LevelSnapshot& snapshot, Tiles& tiles);
+
+ private:
+  struct Change {
+    Vector2i position = {0, 0};
+    bool entity_change = false;
+    TileField field = TileField::Owner;  // Unless entity_change
+    int old_value = 0;
+    int new_value = 0;
+    std::shared_ptr<Entity> old_entity = nullptr;
+    std::shared_ptr<Entity> new_entity = nullptr;
+  };
+
+  // Copies the chunk of position first if a snapshot shares it
+  TileRecord& MutableRecord(Vector2i position);
+  void Apply(Tiles& tiles, const Change& change, bool undo);
+
+  size_t columns_ = 0;
+  std::vector<std::shared_ptr<TileChunk>> chunks_;
+
+  std::vector<Change> changes_;
+  // Index in changes_ of the first change of every action
+  std::vector<size_t> actions_;
+  // Actions not undone, the first ones of actions_
+  size_t done_actions_ = 0;
+  bool recording_ = false;
+  // Set while undoing or redoing, whose changes aren't recorded
+  bool replaying_ = false;
+};
+
+}  // namespace konkr
+
+#endif  // KONKR_RENDERING_STATE_JOURNAL_H
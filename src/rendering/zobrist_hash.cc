@@ -0,0 +1,100 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+
+#include "rendering/zobrist_hash.h"
+
+#include "world/townhall.h"
+
+namespace konkr {
+
+namespace {
+
+enum class Feature : uint64_t {
+  Owner,
+  EntityType,
+  EntityLevel,
+  Money,
+  Moved,
+  CurrentPlayer,
+};
+
+// SplitMix64 finalizer: every input bit changes half of the output bits
+uint64_t Mix(uint64_t z) {
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+  return z ^ (z >> 31);
+}
+
+uint64_t Key(Vector2i position, Feature feature, int value) {
+  const uint64_t row = static_cast<uint16_t>(position.x);
+  const uint64_t column = static_cast<uint16_t>(position.y);
+  const uint64_t id = row << 24 | column << 8 | static_cast<uint64_t>(feature);
+  return Mix(Mix(id) ^ static_cast<uint32_t>(value));
+}
+
+int MoneyBucket(int money) {
+  // Rounded towards negative infinity, so -1 and 1 fall in different buckets
+  return money >= 0 ? money / ZobristHash::kMoneyBucket
+                    : (money + 1) / ZobristHash::kMoneyBucket - 1;
+}
+
+}  // namespace
+
+void ZobristHash::Reset(const Tiles& tiles) {
+  value_ = 0;
+  for (const auto& row : tiles) {
+    for (const auto& tile : row) {
+      if (!tile) continue;
+      const Vector2i position = tile->grid_position();
+      value_ ^= Key(position, Feature::Owner, tile->get_owner().value_or(-1));
+      if (tile->entity()) ToggleEntity(position, *tile->entity());
+    }
+  }
+}
+
+void ZobristHash::OnTileChanged(Vector2i position, TileField field,
+                                int old_value, int new_value) {
+  switch (field) {
+    case TileField::Owner:
+      value_ ^= Key(position, Feature::Owner, old_value) ^
+                Key(position, Feature::Owner, new_value);
+      break;
+    case TileField::EntityLevel:
+      value_ ^= Key(position, Feature::EntityLevel, old_value) ^
+                Key(position, Feature::EntityLevel, new_value);
+      break;
+    case TileField::Money:
+      value_ ^= Key(position, Feature::Money, MoneyBucket(old_value)) ^
+                Key(position, Feature::Money, MoneyBucket(new_value));
+      break;
+    case TileField::Moved:
+      value_ ^= Key(position, Feature::Moved, 1);
+      break;
+    default:
+      break;  // Not part of the hash
+  }
+}
+
+void ZobristHash::OnEntityChanged(Vector2i position,
+                                  const std::shared_ptr<Entity>& old_entity,
+                                  const std::shared_ptr<Entity>& new_entity) {
+  if (old_entity) ToggleEntity(position, *old_entity);
+  if (new_entity) ToggleEntity(position, *new_entity);
+}
+
+uint64_t ZobristHash::CurrentPlayerKey(size_t player_index) {
+  return Key({0, 0}, Feature::CurrentPlayer, static_cast<int>(player_index));
+}
+
+void ZobristHash::ToggleEntity(Vector2i position, const Entity& entity) {
+  value_ ^= Key(position, Feature::EntityType, static_cast<int>(entity.type()));
+  value_ ^= Key(position, Feature::EntityLevel, entity.level());
+  if (entity.has_moved()) value_ ^= Key(position, Feature::Moved, 1);
+  if (entity.type() == Entity::EntityType::Townhall) {
+    const int money = static_cast<const Townhall&>(entity).money();
+    value_ ^= Key(position, Feature::Money, MoneyBucket(money));
+  }
+}
+
+}  // namespace konkr
@@ -0,0 +1,65 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+//
+// zobrist_hash.h
+//
+// Declares the ZobristHash class, a 64-bit hash of the state of a level kept
+// up to date as its tiles change.
+//
+
+#ifndef KONKR_RENDERING_ZOBRIST_HASH_H
+#define KONKR_RENDERING_ZOBRIST_HASH_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "rendering/graphics.h"
+#include "world/entity.h"
+#include "world/tile.h"
+#include "world/tile_observer.h"
+
+namespace konkr {
+
+// The hash is the XOR of a key for every feature of every tile: its owner,
+// the type and level of its entity, whether the entity moved, and the money
+// of its townhall rounded down to kMoneyBucket. A change XORs out the key of
+// the old value and XORs in the key of the new one, so it costs O(1) whatever
+// the size of the map.
+//
+// The keys aren't stored in a table but computed by hashing the position,
+// the feature and its value, so any map gets keys without allocating.
+// Equal states have equal hashes. Different states collide with a
+// probability of about 2^-64, which is good enough to compare states or to
+// index a TranspositionTable.
+class ZobristHash : public TileObserver {
+ public:
+  using Tiles = std::vector<std::vector<std::shared_ptr<Tile>>>;
+
+  // Money differences below this don't change the hash
+  static constexpr int kMoneyBucket = 5;
+
+  // Computes the hash of tiles, whose changes must then be passed to it
+  void Reset(const Tiles& tiles);
+
+  void OnTileChanged(Vector2i position, TileField field, int old_value,
+                     int new_value) override;
+  void OnEntityChanged(Vector2i position,
+                       const std::shared_ptr<Entity>& old_entity,
+                       const std::shared_ptr<Entity>& new_entity) override;
+
+  inline uint64_t value() const { return value_; }
+
+  // Key of the player whose turn it is, which Level::hash XORs in
+  static uint64_t CurrentPlayerKey(size_t player_index);
+
+ private:
+  void ToggleEntity(Vector2i position, const Entity& entity);
+
+  uint64_t value_ = 0;
+};
+
+}  // namespace konkr
+
+#endif  // KONKR_RENDERING_ZOBRIST_HASH_H
@@ -0,0 +1,144 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+
+#include "ui/game_hud.h"
+
+#include <limits>
+
+namespace konkr {
+
+namespace {
+
+constexpr float kPlayerPanelHeaderHeight = 40;
+constexpr float kTownhallRowHeight = 26;
+constexpr TownhallEconomy kUnknownEconomy = {
+    .money = std::numeric_limits<int>::min(),
+    .income = std::numeric_limits<int>::min()};
+
+}  // namespace
+
+GameHud::GameHud(tgui::Gui& gui, const RenderSnapshot& snapshot) {
+  info_panel_ = tgui::Panel::create();
+  info_panel_->setPosition(10, 10);
+  info_panel_->setSize(400, 60);
+  info_panel_->getRenderer()->setBackgroundColor(tgui::Color(30, 30, 30, 200));
+  info_panel_->getRenderer()->setBorders(1);
+  info_panel_->getRenderer()->setBorderColor(tgui::Color::White);
+
+  // Level name
+  auto levelLabel =
+      tgui::Label::create("Playing level: " + snapshot.level_name);
+  levelLabel->setTextSize(16);
+  levelLabel->getRenderer()->setTextColor(tgui::Color::White);
+  levelLabel->setPosition("(&.width - width) / 2", 4);
+  info_panel_->add(levelLabel);
+
+  // Category name
+  auto worldLabel = tgui::Label::create("World: " + snapshot.level_category);
+  worldLabel->setTextSize(14);
+  worldLabel->getRenderer()->setTextColor(tgui::Color::Yellow);
+  worldLabel->setPosition("(&.width - width) / 2", 32);
+  info_panel_->add(worldLabel);
+
+  gui.add(info_panel_);
+
+  // Create a panel for the player info
+  player_panel_ = tgui::Panel::create();
+  player_panel_->setSize(400, kPlayerPanelHeaderHeight);
+  player_panel_->setPosition("(&.width) - 420", 10);
+  player_panel_->getRenderer()->setBackgroundColor(
+      tgui::Color(30, 30, 30, 200));
+  player_panel_->getRenderer()->setBorders(1);
+  player_panel_->getRenderer()->setBorderColor(tgui::Color::White);
+
+  // "Current player:" label
+  auto playerTextLabel = tgui::Label::create("Current player:");
+  playerTextLabel->setPosition(10, 8);
+  playerTextLabel->setTextSize(16);
+  playerTextLabel->getRenderer()->setTextColor(tgui::Color::White);
+  player_panel_->add(playerTextLabel);
+
+  player_name_label_ = tgui::Label::create();
+  player_name_label_->setPosition(200, 8);
+  player_name_label_->setTextSize(16);
+  player_name_label_->getRenderer()->setTextColor(tgui::Color::Yellow);
+  player_panel_->add(player_name_label_);
+
+  gui.add(player_panel_);
+
+  Refresh(snapshot);
+}
+
+void GameHud::Refresh(const RenderSnapshot& snapshot) {
+  if (snapshot.version == snapshot_version_) return;
+  snapshot_version_ = snapshot.version;
+
+  const PlayerSnapshot* player = snapshot.get_current_player();
+  if (!player) {
+    SetCurrentPlayer("");
+    SetTownhallCount(0);
+    return;
+  }
+
+  SetCurrentPlayer(player->name);
+  const auto& economy = player->townhall_economy;
+  SetTownhallCount(economy.size());
+  for (size_t i = 0; i < economy.size(); ++i) {
+    SetTownhallEconomy(i, economy[i]);
+  }
+}
+
+void GameHud::SetCurrentPlayer(const std::string& name) {
+  if (name == player_name_) return;
+  player_name_ = name;
+  player_name_label_->setText(name);
+}
+
+void GameHud::SetTownhallCount(size_t count) {
+  if (count == townhall_count_) return;
+
+  // Rows are only ever added, and hidden when a player has fewer townhalls
+  while (townhall_labels_.size() < count) {
+    auto label = tgui::Label::create();
+    label->setPosition(
+        10, kPlayerPanelHeaderHeight + townhall_labels_.size() *
+                                           kTownhallRowHeight);
+    label->setTextSize(14);
+    label->getRenderer()->setTextColor(tgui::Color::White);
+    player_panel_->add(label);
+    townhall_labels_.push_back(std::move(label));
+    townhall_economy_.emplace_back();
+  }
+  for (size_t i = 0; i < townhall_labels_.size(); ++i) {
+    townhall_labels_[i]->setVisible(i < count);
+    // The rows are numbered only when there are several, forces the text to
+    // be set again by SetTownhallEconomy
+    townhall_economy_[i] = kUnknownEconomy;
+  }
+
+  townhall_count_ = count;
+  player_panel_->setSize(400,
+                         kPlayerPanelHeaderHeight + count * kTownhallRowHeight);
+}
+
+void GameHud::SetTownhallEconomy(size_t index,
+                                 const TownhallEconomy& economy) {
+  if (index >= townhall_count_ || townhall_economy_[index] == economy) {
+    return;
+  }
+  townhall_economy_[index] = economy;
+
+  std::string prefix =
+      townhall_count_ > 1 ? "#" + std::to_string(index + 1) + " " : "";
+  std::string text = prefix + "Money: " + std::to_string(economy.money) +
+                     " (after upkeep: " +
+                     std::to_string(economy.money + economy.income);
+  if (economy.bankruptcy_turn > 0) {
+    text += ", bankrupt in " + std::to_string(economy.bankruptcy_turn) +
+            (economy.bankruptcy_turn > 1 ? " turns" : " turn");
+  }
+  townhall_labels_[index]->setText(text + ")");
+}
+
+}  // namespace konkr
@@ -0,0 +1,60 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+//
+// game_hud.h
+//
+// Declares the GameHud class, the panels showing the level and the current
+// player's economy on the game screen.
+//
+
+#ifndef KONKR_UI_GAME_HUD_H
+#define KONKR_UI_GAME_HUD_H
+
+#include <TGUI/Backend/SFML-Graphics.hpp>
+#include <TGUI/Widgets/Label.hpp>
+#include <TGUI/Widgets/Panel.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "rendering/render_snapshot.h"
+
+namespace konkr {
+
+// The HUD widgets are created once per level. Refresh only changes the text
+// of the labels whose value changed, so a turn costs the same whatever its
+// number, and the widget tree doesn't grow during a game.
+class GameHud {
+ public:
+  // Creates the HUD panels and adds them to the gui.
+  GameHud(tgui::Gui& gui, const RenderSnapshot& snapshot);
+
+  // Updates the HUD from a snapshot of the level, does nothing if it is the
+  // snapshot shown already.
+  void Refresh(const RenderSnapshot& snapshot);
+
+  void SetCurrentPlayer(const std::string& name);
+
+  // Shows count townhall rows in the player panel
+  void SetTownhallCount(size_t count);
+
+  void SetTownhallEconomy(size_t index, const TownhallEconomy& economy);
+
+ private:
+  tgui::Panel::Ptr info_panel_;
+  tgui::Panel::Ptr player_panel_;
+  tgui::Label::Ptr player_name_label_;
+  // Rows of the player panel, one per townhall, hidden when unused
+  std::vector<tgui::Label::Ptr> townhall_labels_;
+
+  // Values currently shown
+  uint64_t snapshot_version_ = 0;  // Simulations start at version 1
+  std::string player_name_;
+  size_t townhall_count_ = 0;
+  std::vector<TownhallEconomy> townhall_economy_;
+};
+
+}  // namespace konkr
+
+#endif  // KONKR_UI_GAME_HUD_H
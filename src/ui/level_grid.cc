@@ -0,0 +1,194 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+
+#include "ui/level_grid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+namespace konkr {
+
+namespace {
+
+constexpr float kCardWidth = 220;
+constexpr float kCardHeight = 100;
+constexpr float kPadding = 20;
+constexpr unsigned kRowHeight = static_cast<unsigned>(kCardHeight + kPadding);
+constexpr float kScrollbarWidth = 16;
+
+}  // namespace
+
+LevelGrid::LevelGrid(const std::vector<LevelInfo>& levels, float width,
+                     float height, LevelCallback on_select,
+                     LevelCallback on_hover)
+    : levels_(levels),
+      on_select_(std::move(on_select)),
+      on_hover_(std::move(on_hover)) {
+  panel_ = tgui::Panel::create();
+  panel_->setSize(width, height);
+  panel_->getRenderer()->setBackgroundColor(tgui::Color::Transparent);
+
+  cards_per_row_ = std::max<size_t>(
+      1, static_cast<size_t>((width - kPadding - kScrollbarWidth) /
+                             (kCardWidth + kPadding)));
+  const size_t rows = (levels_.size() + cards_per_row_ - 1) / cards_per_row_;
+
+  scrollbar_ = tgui::Scrollbar::create();
+  scrollbar_->setPosition(width - kScrollbarWidth, 0);
+  scrollbar_->setSize(kScrollbarWidth, height);
+  scrollbar_->setMaximum(static_cast<unsigned>(rows * kRowHeight + kPadding));
+  scrollbar_->setViewportSize(static_cast<unsigned>(height));
+  scrollbar_->setScrollAmount(kRowHeight / 2);
+  scrollbar_->onValueChange([this](unsigned value) { Scroll(value); });
+  panel_->add(scrollbar_);
+
+  // One more row than fits, for the partially visible rows while scrolling
+  const size_t visible_rows =
+      static_cast<size_t>(std::ceil(height / kRowHeight)) + 1;
+  const size_t card_count =
+      std::min(visible_rows * cards_per_row_, levels_.size());
+  cards_.reserve(card_count);
+  for (size_t i = 0; i < card_count; ++i) {
+    CreateCard();
+  }
+
+  Scroll(0);
+}
+
+void LevelGrid::CreateCard() {
+  const size_t slot = cards_.size();
+  LevelCard card;
+  card.index = levels_.size();
+
+  card.panel = tgui::Panel::create();
+  card.panel->setSize(kCardWidth, kCardHeight);
+  card.panel->getRenderer()->setBorders(1);
+  card.panel->getRenderer()->setBorderColor(tgui::Color::Black);
+  card.panel->onMouseEnter([this, slot] {
+    if (cards_[slot].index < levels_.size()) on_hover_(cards_[slot].index);
+  });
+
+  // Level name
+  card.name_label = tgui::Label::create();
+  card.name_label->setPosition(10, 10);
+  card.name_label->setTextSize(16);
+  card.name_label->getRenderer()->setTextColor(tgui::Color::Black);
+  card.panel->add(card.name_label);
+
+  // Category name in blue
+  card.category_label = tgui::Label::create();
+  card.category_label->setPosition(10, 40);
+  card.category_label->setTextSize(12);
+  card.category_label->getRenderer()->setTextColor(tgui::Color::Blue);
+  card.panel->add(card.category_label);
+
+  // Map size and number of players, straight from the catalog
+  card.details_label = tgui::Label::create();
+  card.details_label->setPosition(10, 65);
+  card.details_label->setTextSize(12);
+  card.details_label->getRenderer()->setTextColor(tgui::Color(100, 100, 100));
+  card.panel->add(card.details_label);
+
+  card.select_button = tgui::Button::create("Select");
+  card.select_button->setSize(90, 30);
+  card.select_button->setPosition(kCardWidth - 100, kCardHeight - 40);
+  card.select_button->onClick([this, slot] {
+    if (cards_[slot].index < levels_.size()) on_select_(cards_[slot].index);
+  });
+  card.panel->add(card.select_button);
+
+  panel_->add(card.panel);
+  cards_.push_back(std::move(card));
+}
+
+void LevelGrid::Scroll(unsigned offset) {
+  first_row_ = offset / kRowHeight;
+  const float row_offset = static_cast<float>(offset % kRowHeight);
+
+  for (size_t slot = 0; slot < cards_.size(); ++slot) {
+    LevelCard& card = cards_[slot];
+    const size_t row = slot / cards_per_row_;
+    const size_t col = slot % cards_per_row_;
+    card.panel->setPosition(kPadding + col * (kCardWidth + kPadding),
+                            kPadding + row * kRowHeight - row_offset);
+
+    const size_t index = (first_row_ + row) * cards_per_row_ + col;
+    if (index != card.index) {
+      card.index = index;
+      BindCard(card);
+    }
+  }
+}
+
+void LevelGrid::BindCard(LevelCard& card) {
+  if (card.index >= levels_.size()) {
+    card.panel->setVisible(false);
+    return;
+  }
+  card.panel->setVisible(true);
+
+  const LevelInfo& level = levels_[card.index];
+  const bool is_selected = level.file_path == selected_path_;
+  const bool is_loading = level.file_path == loading_path_;
+
+  card.panel->getRenderer()->setBackgroundColor(
+      is_selected ? tgui::Color(200, 200, 255) : tgui::Color::White);
+  card.name_label->setText(level.name);
+  card.category_label->setText(level.category);
+  card.details_label->setText(std::to_string(level.rows) + "x" +
+                              std::to_string(level.columns) + ", " +
+                              std::to_string(level.player_count) +
+                              " players");
+
+  auto& button = card.select_button;
+  button->setEnabled(!is_loading);
+  if (is_loading) {
+    button->setText("Loading...");
+  } else if (is_selected) {
+    button->setText("Deselect");
+    button->getRenderer()->setBackgroundColor(tgui::Color::Blue);
+    button->getRenderer()->setTextColor(tgui::Color::White);
+    button->getRenderer()->setBorderColor(tgui::Color::White);
+  } else {
+    button->setText("Select");
+    button->getRenderer()->setBackgroundColor(tgui::Color(220, 220, 220));
+    button->getRenderer()->setTextColor(tgui::Color::Black);
+    button->getRenderer()->setBorderColor(tgui::Color::Black);
+  }
+}
+
+void LevelGrid::UpdateCardsOf(const std::filesystem::path& file_path) {
+  if (file_path.empty()) return;
+  for (auto& card : cards_) {
+    if (card.index < levels_.size() &&
+        levels_[card.index].file_path == file_path) {
+      BindCard(card);
+    }
+  }
+}
+
+void LevelGrid::SetSelection(const std::filesystem::path& selected_path,
+                             const std::filesystem::path& loading_path) {
+  std::filesystem::path previous_selected = std::move(selected_path_);
+  std::filesystem::path previous_loading = std::move(loading_path_);
+  selected_path_ = selected_path;
+  loading_path_ = loading_path;
+
+  UpdateCardsOf(previous_selected);
+  UpdateCardsOf(previous_loading);
+  UpdateCardsOf(selected_path_);
+  UpdateCardsOf(loading_path_);
+}
+
+void LevelGrid::ScrollBy(float wheel_delta) {
+  const float step = static_cast<float>(kRowHeight) / 2;
+  const float max_value = static_cast<float>(scrollbar_->getMaximum()) -
+                          scrollbar_->getViewportSize();
+  const float value = std::clamp(scrollbar_->getValue() - wheel_delta * step,
+                                 0.0f, std::max(0.0f, max_value));
+  scrollbar_->setValue(static_cast<unsigned>(value));
+}
+
+}  // namespace konkr
@@ -0,0 +1,89 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+//
+// level_grid.h
+//
+// Declares the LevelGrid class, the scrollable grid of level cards shown on
+// the level selection screen.
+//
+
+#ifndef KONKR_UI_LEVEL_GRID_H
+#define KONKR_UI_LEVEL_GRID_H
+
+#include <TGUI/Backend/SFML-Graphics.hpp>
+#include <TGUI/Widgets/Button.hpp>
+#include <TGUI/Widgets/Label.hpp>
+#include <TGUI/Widgets/Panel.hpp>
+#include <TGUI/Widgets/Scrollbar.hpp>
+#include <filesystem>
+#include <functional>
+#include <vector>
+
+#include "rendering/level_catalog.h"
+
+namespace konkr {
+
+// Grid of level cards, each with a name, category, size and a button to
+// select/de-select the level.
+// Only the cards of the visible rows exist: when scrolling, they are moved
+// and bound to other levels instead of being re-created, so the cost of the
+// grid doesn't depend on the number of levels.
+class LevelGrid {
+ public:
+  // Called with the index of a level in levels
+  using LevelCallback = std::function<void(size_t index)>;
+
+  // levels must outlive the grid.
+  LevelGrid(const std::vector<LevelInfo>& levels, float width, float height,
+            LevelCallback on_select, LevelCallback on_hover);
+
+  inline const tgui::Panel::Ptr& panel() const { return panel_; }
+
+  inline size_t cards_per_row() const { return cards_per_row_; }
+
+  // Updates the cards of the previously and newly selected or loading
+  // levels. An empty path means no level.
+  void SetSelection(const std::filesystem::path& selected_path,
+                    const std::filesystem::path& loading_path);
+
+  // Scrolls by the given number of mouse wheel ticks (positive is up).
+  void ScrollBy(float wheel_delta);
+
+ private:
+  struct LevelCard {
+    tgui::Panel::Ptr panel;
+    tgui::Label::Ptr name_label;
+    tgui::Label::Ptr category_label;
+    tgui::Label::Ptr details_label;
+    tgui::Button::Ptr select_button;
+    size_t index;  // Index of the level shown, levels_.size() if none
+  };
+
+  void CreateCard();
+
+  // Places the cards of the rows visible at the given scroll offset
+  void Scroll(unsigned offset);
+
+  // Refreshes the content of the card from its level
+  void BindCard(LevelCard& card);
+
+  void UpdateCardsOf(const std::filesystem::path& file_path);
+
+  const std::vector<LevelInfo>& levels_;
+  LevelCallback on_select_;
+  LevelCallback on_hover_;
+
+  tgui::Panel::Ptr panel_;
+  tgui::Scrollbar::Ptr scrollbar_;
+  std::vector<LevelCard> cards_;  // Pool of cards, one per visible slot
+
+  size_t cards_per_row_;
+  size_t first_row_ = 0;
+  std::filesystem::path selected_path_;
+  std::filesystem::path loading_path_;
+};
+
+}  // namespace konkr
+
+#endif  // KONKR_UI_LEVEL_GRID_H
@@ -8,83 +8,111 @@
 #include <TGUI/Widgets/Button.hpp>
 #include <TGUI/Widgets/Label.hpp>
 #include <TGUI/Widgets/Panel.hpp>
+#include <string>
 
+#include "ai/mcts_player.h"
 #include "rendering/graphics.h"
 #include "rendering/level.h"
 
 namespace konkr {
 
-void UserInterface::ColorReachableTiles(std::shared_ptr<Tile> tile) {
-  auto reachable = tile->GetNeighboringTilesGridPosition();
-  for (auto t : reachable) {
-    auto rtile = selected_level_->tiles().at(t.x).at(t.y);
-    rtile->set_reachability(true);
-  }
+namespace {
+
+// Where the command log of the last game played is written, to reproduce it
+// with a ReplayPlayer
+constexpr char kReplayPath[] = "last_game.replay";
+// Where the game is saved after every turn, see LoadGame
+constexpr char kAutosavePath[] = "autosave.ksav";
+// Time the computer opponents think about each of their moves, and about all
+// the moves of a turn
+constexpr std::chrono::milliseconds kComputerMoveTime{200};
+constexpr std::chrono::milliseconds kComputerTurnTime{2000};
+
+// Text of the button of a player on the level selection screen
+std::string PlayerButtonText(const std::string& name, bool computer) {
+  return name + (computer ? ": Computer" : ": Human");
 }
 
-bool UserInterface::TileClicked(std::shared_ptr<FloatRect> bounds,
-                                Vector2f mouse_pos) {
-  return bounds->contains(mouse_pos);
+}  // namespace
+
+const RenderSnapshot* UserInterface::latest_snapshot() {
+  return simulation_ ? &simulation_->LatestSnapshot() : nullptr;
 }
 
 void UserInterface::TileMapEvent(const sf::Event& event) {
-  std::shared_ptr<Level::Tiles> tiles =
-      std::make_shared<Level::Tiles>(selected_level_->tiles());
-
-  if (event.is<sf::Event::MouseButtonPressed>() &&
-      event.getIf<sf::Event::MouseButtonPressed>()->button ==
-          sf::Mouse::Button::Left) {
-    if (!tiles->empty()) {
-      for (size_t row = 0; row < tiles->size(); ++row) {
-        const auto& tile_row = tiles->at(row);
-
-        for (size_t col = 0; col < tile_row.size(); ++col) {
-          const auto& tile_opt = tile_row[col];
-          if (!tile_opt) continue;
-          sf::Vector2i mouse_pos =
-              sf::Mouse::getPosition(render_target_.get_window());
-          sf::Vector2f world_pos =
-              render_target_.get_window().mapPixelToCoords(mouse_pos);
-
-          if (TileClicked(tile_opt->get_bounds(),
-                          Vector2f(world_pos.x, world_pos.y))) {
-            if (tile_opt->is_reachable()) {
-              std::cerr << "Atteignable!" << std::endl;
-            } else if (tile_opt->get_owner() ==
-                           selected_level_->get_current_player()->id() &&
-                       tile_opt->entity() != nullptr) {
-              std::cerr << "À moi!" << std::endl;
-              ColorReachableTiles(tile_opt);
-            }
-          }
-        }
-      }
-    }
+  const auto* pressed = event.getIf<sf::Event::MouseButtonPressed>();
+  if (!simulation_ || !pressed ||
+      pressed->button != sf::Mouse::Button::Left) {
+    return;
+  }
+
+  sf::Vector2f world_pos =
+      render_target_.get_window().mapPixelToCoords(pressed->position);
+  auto tile = LevelRenderer::PixelToTile(
+      simulation_->LatestSnapshot(), render_target_.get_size(),
+      LevelRenderer::kHexRadius, Vector2f(world_pos.x, world_pos.y));
+  if (tile) {
+    simulation_->Post({GameCommand::Type::SelectTile, *tile});
   }
 }
 
 void UserInterface::HandleEvent(const sf::Event& event) {
-  gui_.handleEvent(event);
+  const bool handled = gui_.handleEvent(event);
 
   if (current_state_ == UserInterfaceState::Game) {
     TileMapEvent(event);
   }
+
+  // The grid scrolls with the wheel wherever the mouse is on the screen
+  if (!handled && level_grid_) {
+    if (const auto* wheel = event.getIf<sf::Event::MouseWheelScrolled>()) {
+      if (wheel->wheel == sf::Mouse::Wheel::Vertical) {
+        level_grid_->ScrollBy(wheel->delta);
+      }
+    }
+  }
 }
 
 void UserInterface::Draw() { gui_.draw(); }
 
+void UserInterface::Update() {
+  for (auto& loaded : level_loader_.TakeCompleted()) {
+    // The player may have selected another level in the meantime
+    if (loaded.file_path != loading_level_path_) continue;
+
+    loading_level_path_.clear();
+    selected_level_ = std::move(loaded.level);
+    // The player who starts is human, the computer plays the others, until
+    // chosen otherwise
+    computer_player_ids_.clear();
+    const auto& players = selected_level_->active_players();
+    for (const auto& [id, player] : players) {
+      if (id != players.begin()->first) computer_player_ids_.insert(id);
+    }
+    UpdateLevelSelection();
+  }
+
+  if (simulation_ && game_hud_) {
+    game_hud_->Refresh(simulation_->LatestSnapshot());
+  }
+}
+
 void UserInterface::SwitchState(UserInterfaceState new_state) {
   current_state_ = new_state;
   gui_.removeAllWidgets();
+  level_grid_ = nullptr;
+  play_level_button_ = nullptr;
+  player_buttons_.clear();
+  game_hud_ = nullptr;
+  simulation_ = nullptr;  // Stops the simulation thread
   switch (current_state_) {
     case UserInterfaceState::HomePage:
       SetupHomePage();
       break;
     case UserInterfaceState::LevelSelection:
-      if (available_levels_.empty()) {
-        available_levels_ = Level::GetAvailableLevels("assets/levels");
-      }
+      level_catalog_.Refresh();
       selected_level_ = nullptr;
+      loading_level_path_.clear();
       SetupLevelSelection();
       break;
     case UserInterfaceState::Game:
@@ -109,89 +137,25 @@ void UserInterface::SetupHomePage() {
 }
 
 void UserInterface::SetupLevelSelection() {
-  auto grid_panel = tgui::Panel::create();
-  grid_panel->setPosition("(&.width - 800) / 2", "50");
-  grid_panel->setSize(800, "(&.height - 200)");
-  grid_panel->getRenderer()->setBackgroundColor(tgui::Color::Transparent);
-  gui_.add(grid_panel);
-
-  const float card_width = 220;
-  const float card_height = 100;
-  const float padding = 20;
-  float current_x = padding;
-  float current_y = padding;
-
-  for (const auto& level : available_levels_) {
-    auto card = tgui::Panel::create();
-    card->setPosition(current_x, current_y);
-    card->setSize(card_width, card_height);
-    card->getRenderer()->setBorders(1);
-    card->getRenderer()->setBorderColor(tgui::Color::Black);
-    card->getRenderer()->setBackgroundColor(
-        (selected_level_ && selected_level_ == level)
-            ? tgui::Color(200, 200, 255)
-            : tgui::Color::White);
-
-    // Level name
-    auto name_label = tgui::Label::create(level->name());
-    name_label->setPosition(10, 10);
-    name_label->setTextSize(16);
-    name_label->getRenderer()->setTextColor(tgui::Color::Black);
-    card->add(name_label);
-
-    // Category name in blue
-    auto category_label = tgui::Label::create(level->category());
-    category_label->setPosition(10, 40);
-    category_label->setTextSize(12);
-    category_label->getRenderer()->setTextColor(tgui::Color::Blue);
-    card->add(category_label);
-
-    auto selectButton = tgui::Button::create("Select");
-    selectButton->setSize(90, 30);
-    selectButton->setPosition(card_width - 100, card_height - 40);
-
-    if (selected_level_ && selected_level_ == level) {
-      selectButton->setText("Deselect");
-      selectButton->getRenderer()->setBackgroundColor(tgui::Color::Blue);
-      selectButton->getRenderer()->setTextColor(tgui::Color::White);
-      selectButton->getRenderer()->setBorderColor(tgui::Color::White);
-    } else {
-      selectButton->setEnabled(true);
-      selectButton->getRenderer()->setBackgroundColor(
-          tgui::Color(220, 220, 220));
-      selectButton->getRenderer()->setTextColor(tgui::Color::Black);
-      selectButton->getRenderer()->setBorderColor(tgui::Color::Black);
-    }
-
-    selectButton->onClick([this, level] {
-      if (selected_level_ == level) {
-        selected_level_ = nullptr;  // Deselects if already selected
-      } else {
-        selected_level_ = level;
-        if (selected_level_ && !selected_level_->is_loaded())
-          selected_level_->Load();
-      }
-      SetupLevelSelection();
-    });
-    card->add(selectButton);
-
-    grid_panel->add(card);
-
-    current_x += card_width + padding;
-    if (current_x + card_width > 800) {  // Wraps to next row
-      current_x = padding;
-      current_y += card_height + padding;
-    }
-  }
-
-  auto startButton = tgui::Button::create("Play Level");
-  startButton->setSize(200, 60);
-  startButton->setPosition("(&.width - 200) / 2", "(&.height - 60) / 2 + 250");
-  startButton->setEnabled(is_level_selected());
-  startButton->onClick([this] {
+  // The grid stops above the Play Level button
+  const float window_height = static_cast<float>(render_target_.get_size().y);
+  const float grid_height = (window_height - 60) / 2 + 250 - 50 - 20;
+
+  level_grid_ = std::make_unique<LevelGrid>(
+      level_catalog_.levels(), 800, grid_height,
+      [this](size_t index) { OnLevelCardSelected(index); },
+      [this](size_t index) { PreloadLevelsAround(index); });
+  level_grid_->panel()->setPosition("(&.width - 800) / 2", "50");
+  gui_.add(level_grid_->panel());
+
+  play_level_button_ = tgui::Button::create("Play Level");
+  play_level_button_->setSize(200, 60);
+  play_level_button_->setPosition("(&.width - 200) / 2",
+                                  "(&.height - 60) / 2 + 250");
+  play_level_button_->onClick([this] {
     if (is_level_selected()) SwitchState(UserInterfaceState::Game);
   });
-  gui_.add(startButton);
+  gui_.add(play_level_button_);
 
   auto backButton = tgui::Button::create("Back");
   backButton->setSize(200, 60);
@@ -204,6 +168,77 @@ void UserInterface::SetupLevelSelection() {
   exitButton->setPosition("(&.width - 200) / 2", "(&.height - 60) / 2 + 390");
   exitButton->onClick([this] { render_target_.get_window().close(); });
   gui_.add(exitButton);
+
+  UpdateLevelSelection();
+}
+
+void UserInterface::OnLevelCardSelected(size_t index) {
+  const LevelInfo& level = level_catalog_.levels()[index];
+  const bool was_selected =
+      (selected_level_ && selected_level_->file_path() == level.file_path) ||
+      loading_level_path_ == level.file_path;
+
+  selected_level_ = nullptr;  // Deselects if already selected
+  loading_level_path_.clear();
+  if (!was_selected) {
+    // The level is handed over by Update once loaded
+    loading_level_path_ = level.file_path;
+    level_loader_.Request(level);
+  }
+  UpdateLevelSelection();
+}
+
+void UserInterface::UpdateLevelSelection() {
+  if (!level_grid_) return;
+  level_grid_->SetSelection(
+      selected_level_ ? selected_level_->file_path() : std::filesystem::path(),
+      loading_level_path_);
+  play_level_button_->setEnabled(is_level_selected());
+  UpdatePlayerButtons();
+}
+
+void UserInterface::UpdatePlayerButtons() {
+  for (const auto& button : player_buttons_) {
+    gui_.remove(button);
+  }
+  player_buttons_.clear();
+  if (!selected_level_) return;
+
+  // A column right of the Play Level button
+  int y = 250;
+  for (const auto& entry : selected_level_->active_players()) {
+    const int id = entry.first;
+    const std::string name = entry.second.name();
+    auto button = tgui::Button::create(
+        PlayerButtonText(name, computer_player_ids_.contains(id)));
+    button->setSize(200, 30);
+    button->setPosition("(&.width - 200) / 2 + 220",
+                        "(&.height - 60) / 2 + " + std::to_string(y));
+    button->onClick([this, id, name, button = button.get()] {
+      const bool computer = !computer_player_ids_.contains(id);
+      if (computer) {
+        computer_player_ids_.insert(id);
+      } else {
+        computer_player_ids_.erase(id);
+      }
+      button->setText(PlayerButtonText(name, computer));
+    });
+    gui_.add(button);
+    player_buttons_.push_back(std::move(button));
+    y += 40;
+  }
+}
+
+void UserInterface::PreloadLevelsAround(size_t index) {
+  const auto& levels = level_catalog_.levels();
+  const size_t cards_per_row = level_grid_->cards_per_row();
+  level_loader_.Preload(levels[index]);
+  if (index + 1 < levels.size()) level_loader_.Preload(levels[index + 1]);
+  if (index > 0) level_loader_.Preload(levels[index - 1]);
+  if (index + cards_per_row < levels.size())
+    level_loader_.Preload(levels[index + cards_per_row]);
+  if (index >= cards_per_row)
+    level_loader_.Preload(levels[index - cards_per_row]);
 }
 
 void UserInterface::SetupGame() {
@@ -228,30 +263,18 @@ void UserInterface::SetupGame() {
     return;
   }
 
-  auto infoPanel = tgui::Panel::create();
-  infoPanel->setPosition(10, 10);
-  infoPanel->setSize(400, 60);
-  infoPanel->getRenderer()->setBackgroundColor(tgui::Color(30, 30, 30, 200));
-  infoPanel->getRenderer()->setBorders(1);
-  infoPanel->getRenderer()->setBorderColor(tgui::Color::White);
-
-  // Level name
-  auto levelLabel =
-      tgui::Label::create("Playing level: " + selected_level_->name());
-  levelLabel->setTextSize(16);
-  levelLabel->getRenderer()->setTextColor(tgui::Color::White);
-  levelLabel->setPosition("(&.width - width) / 2", 4);
-  infoPanel->add(levelLabel);
-
-  // Category name
-  auto worldLabel =
-      tgui::Label::create("World: " + selected_level_->category());
-  worldLabel->setTextSize(14);
-  worldLabel->getRenderer()->setTextColor(tgui::Color::Yellow);
-  worldLabel->setPosition("(&.width - width) / 2", 32);
-  infoPanel->add(worldLabel);
-
-  gui_.add(infoPanel);
+  // The computer plays the players chosen on the level selection screen, the
+  // others take turns on this computer
+  auto computer_player = std::make_unique<MctsPlayer>(
+      MctsPlayer::Options{.time_budget = kComputerMoveTime,
+                          .turn_time_budget = kComputerTurnTime,
+                          .seed = selected_level_->seed()});
+  simulation_ = std::make_unique<Simulation>(
+      selected_level_, kReplayPath, kAutosavePath, std::move(computer_player),
+      computer_player_ids_);
+  game_hud_ =
+      std::make_unique<GameHud>(gui_, simulation_->LatestSnapshot());
+
   auto backButton = tgui::Button::create("Back");
   backButton->setSize(200, 60);
   backButton->setPosition(20, "(&.height) - 80");  // bottom left corner
@@ -269,54 +292,23 @@ void UserInterface::SetupGame() {
   auto nextTurnButton = tgui::Button::create("Next Turn");
   nextTurnButton->setSize(200, 60);
   nextTurnButton->setPosition("(&.width) - 220", "(&.height) - 160");
+  // The HUD is refreshed by Update once the simulation published the turn
   nextTurnButton->onClick([this] {
-    if (selected_level_) {
-      selected_level_->NextTurn();
-      SetupGame();
-    }
+    simulation_->Post({GameCommand::Type::NextTurn});
   });
   gui_.add(nextTurnButton);
 
-  // display current player
-  auto player = selected_level_->get_current_player();
-
-  // Create a panel for the player info
-  auto playerPanel = tgui::Panel::create();
-  playerPanel->setSize(400, 80);
-  playerPanel->setPosition("(&.width) - 420", 10);
-  playerPanel->getRenderer()->setBackgroundColor(tgui::Color(30, 30, 30, 200));
-  playerPanel->getRenderer()->setBorders(1);
-  playerPanel->getRenderer()->setBorderColor(tgui::Color::White);
-
-  // "Current player:" label
-  auto playerTextLabel = tgui::Label::create("Current player:");
-  playerTextLabel->setPosition(10, 8);
-  playerTextLabel->setTextSize(16);
-  playerTextLabel->getRenderer()->setTextColor(tgui::Color::White);
-  playerPanel->add(playerTextLabel);
-
-  auto playerNameLabel = tgui::Label::create(player->name());
-  playerNameLabel->setPosition(200, 8);
-  playerNameLabel->setTextSize(16);
-  playerNameLabel->getRenderer()->setTextColor(tgui::Color::Yellow);
-  playerPanel->add(playerNameLabel);
-
-  if (!player->townhalls().empty()) {
-    auto thall = player->townhalls().front();
-    int money = thall->money();
-    int upkeep = thall->upkeep_cost();
-    int after_upkeep = money + upkeep;
-    std::string money_text = "Money: " + std::to_string(money) +
-                             " (after upkeep: " + std::to_string(after_upkeep) +
-                             ")";
-    auto moneyLabel = tgui::Label::create(money_text);
-    moneyLabel->setPosition(10, 40);
-    moneyLabel->setTextSize(14);
-    moneyLabel->getRenderer()->setTextColor(tgui::Color::White);
-    playerPanel->add(moneyLabel);
-  }
-
-  gui_.add(playerPanel);
+  // Take back and replay the tiles selected during the turn
+  auto undoButton = tgui::Button::create("Undo");
+  undoButton->setSize(95, 60);
+  undoButton->setPosition("(&.width) - 220", "(&.height) - 240");
+  undoButton->onClick([this] { simulation_->Post({GameCommand::Type::Undo}); });
+  gui_.add(undoButton);
+  auto redoButton = tgui::Button::create("Redo");
+  redoButton->setSize(95, 60);
+  redoButton->setPosition("(&.width) - 115", "(&.height) - 240");
+  redoButton->onClick([this] { simulation_->Post({GameCommand::Type::Redo}); });
+  gui_.add(redoButton);
 }
 
 }  // namespace konkr
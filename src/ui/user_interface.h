@@ -13,10 +13,21 @@
 #define KONKR_RENDERING_USER_INTERFACE_H
 
 #include <TGUI/Backend/SFML-Graphics.hpp>
+#include <TGUI/Widgets/Button.hpp>
 #include <memory>
+#include <set>
+#include <vector>
 
 #include "rendering/graphics.h"
 #include "rendering/level.h"
+#include "rendering/level_catalog.h"
+#include "rendering/level_loader.h"
+#include "rendering/level_renderer.h"
+#include "rendering/render_snapshot.h"
+#include "rendering/resource_cache.h"
+#include "rendering/simulation.h"
+#include "ui/game_hud.h"
+#include "ui/level_grid.h"
 
 namespace konkr {
 
@@ -35,8 +46,15 @@ class UserInterface {
   UserInterface(RenderTarget& render_target)
       : render_target_(render_target),
         gui_(render_target.get_window()),
-        current_state_(UserInterfaceState::HomePage) {
-    gui_.setFont("assets/fonts/OCRA/OCRA.ttf");
+        current_state_(UserInterfaceState::HomePage),
+        level_catalog_("assets/levels", "assets/levels.manifest") {
+    // Same font file as the map, read only once through the ResourceCache
+    const Font& font = ResourceCache::GetInstance()
+                           .Load<Font>(LevelRenderer::kFontPath)
+                           .get();
+    if (font.is_loaded() && font.data()) {
+      gui_.setFont(tgui::Font(font.data()->data(), font.data()->size()));
+    }
     SetupHomePage();
   }
 
@@ -45,27 +63,28 @@ class UserInterface {
   void HandleEvent(const sf::Event& event);
   void Draw();
 
+  // Picks up the work finished in the background (e.g. level loading) since
+  // the last frame. Must be called once per frame, before Draw.
+  void Update();
+
   // Switches the current state of the UI
   void SwitchState(UserInterfaceState new_state);
 
   inline bool is_level_selected() const { return selected_level_ != nullptr; }
 
+  inline bool is_level_loading() const { return !loading_level_path_.empty(); }
+
   inline std::shared_ptr<Level> selected_level() const {
     return selected_level_;
   }
 
-  void ColorReachableTiles(std::shared_ptr<Tile> tile);
-
-  /**
-    @brief Checks if the given tile is clicked.
-    @param points Points of the tile to check.
-    @param mousePos Position of the mouse when clicked.
-    @returns true if tile clicked, false otherwise.
-  */
-  bool TileClicked(std::shared_ptr<FloatRect> bounds, Vector2f mouse_pos);
+  // Latest snapshot of the level being played, nullptr outside of the game
+  // screen. Valid until the next call.
+  const RenderSnapshot* latest_snapshot();
 
   /**
-    @brief Handles event occuring on the tile map.
+    @brief Handles event occuring on the tile map: clicks are sent to the
+    simulation as commands.
     @param event The event.
   */
   void TileMapEvent(const sf::Event& event);
@@ -83,6 +102,20 @@ class UserInterface {
   // The play level button switches to the game screen
   void SetupLevelSelection();
 
+  // Selects (and starts loading) or de-selects the level at index
+  void OnLevelCardSelected(size_t index);
+
+  // Updates the level selection widgets after a selection change, in place
+  void UpdateLevelSelection();
+
+  // Shows a button per player of the selected level, which toggles whether
+  // the computer plays it
+  void UpdatePlayerButtons();
+
+  // Preloads the level of the card at index and the levels of the cards
+  // around it, so that selecting one of them doesn't have to wait
+  void PreloadLevelsAround(size_t index);
+
   // Sets up the GUI for the game screen
   void SetupGame();
 
@@ -90,7 +123,21 @@ class UserInterface {
   tgui::Gui gui_;
   UserInterfaceState current_state_;
   std::shared_ptr<Level> selected_level_ = nullptr;
-  std::vector<std::shared_ptr<Level>> available_levels_;
+  LevelCatalog level_catalog_;
+  LevelLoader level_loader_;
+  // Level requested from the level loader, empty if none
+  std::filesystem::path loading_level_path_;
+  // Level selection widgets, only set on the level selection screen
+  std::unique_ptr<LevelGrid> level_grid_;
+  tgui::Button::Ptr play_level_button_;
+  std::vector<tgui::Button::Ptr> player_buttons_;
+  // Players of the selected level the computer plays, chosen on the level
+  // selection screen
+  std::set<int> computer_player_ids_;
+  // Only set on the game screen. The simulation owns the selected level
+  // while it runs.
+  std::unique_ptr<Simulation> simulation_;
+  std::unique_ptr<GameHud> game_hud_;
 };
 
 }  // namespace konkr
@@ -0,0 +1,111 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+
+#include "world/bandit_system.h"
+
+#include <array>
+
+#include "world/entity.h"
+#include "world/rules.h"
+
+namespace konkr {
+
+void BanditSystem::Reset(const HexGrid& grid, const Tiles& tiles) {
+  Reset(grid);
+  for (const auto& row : tiles) {
+    for (const auto& tile : row) {
+      if (!tile || !Tile::is_sand(tile->type())) continue;
+      const auto& entity = tile->entity();
+      SetTile(grid.bit(tile->grid_position()), tile->get_owner().value_or(-1),
+              entity ? entity->type() : Entity::EntityType::Unknown);
+    }
+  }
+}
+
+void BanditSystem::Reset(const HexGrid& grid) {
+  grid_ = &grid;
+  land_.Assign(grid.bit_count());
+  occupied_.Assign(grid.bit_count());
+  bandits_.Assign(grid.bit_count());
+  owners_.assign(grid.bit_count(), -1);
+  bandit_count_ = 0;
+}
+
+void BanditSystem::SetTile(size_t bit, int owner, Entity::EntityType entity) {
+  land_.Set(bit);
+  owners_[bit] = static_cast<int8_t>(owner);
+  SetEntity(bit, entity);
+}
+
+std::span<const BanditSystem::Move> BanditSystem::MoveBandits(
+    RandomStream& random) {
+  moves_.clear();
+  positions_.clear();
+  bandits_.ForEach([this](size_t bit) { positions_.push_back(bit); });
+
+  const auto bit_count = static_cast<ptrdiff_t>(grid_->bit_count());
+  const size_t stride = grid_->stride();
+  for (const size_t from : positions_) {
+    const auto& offsets = grid_->neighbor_offsets(from / stride);
+    std::array<size_t, 6> candidates;
+    uint32_t candidate_count = 0;
+    for (const ptrdiff_t offset : offsets) {
+      const ptrdiff_t neighbor = static_cast<ptrdiff_t>(from) + offset;
+      if (neighbor < 0 || neighbor >= bit_count) continue;
+      const auto bit = static_cast<size_t>(neighbor);
+      if (land_.Test(bit) && !occupied_.Test(bit) &&
+          owners_[bit] == owners_[from]) {
+        candidates[candidate_count++] = bit;
+      }
+    }
+    if (candidate_count == 0) continue;
+
+    const size_t to = candidates[candidate_count == 1
+                                     ? 0
+                                     : random.NextBelow(candidate_count)];
+    // Seen by the next bandits now, the tiles being changed after the pass
+    occupied_.Reset(from);
+    bandits_.Reset(from);
+    occupied_.Set(to);
+    bandits_.Set(to);
+    moves_.push_back({from, to});
+  }
+  return moves_;
+}
+
+void BanditSystem::OnTileChanged(Vector2i position, TileField field,
+                                 int /*old_value*/, int new_value) {
+  if (field == TileField::Owner && grid_ && grid_->contains(position)) {
+    owners_[grid_->bit(position)] = static_cast<int8_t>(new_value);
+  }
+}
+
+void BanditSystem::OnEntityChanged(
+    Vector2i position, const std::shared_ptr<Entity>& /*old_entity*/,
+    const std::shared_ptr<Entity>& new_entity) {
+  if (grid_ && grid_->contains(position)) {
+    SetEntity(grid_->bit(position),
+              new_entity ? new_entity->type() : Entity::EntityType::Unknown);
+  }
+}
+
+void BanditSystem::SetEntity(size_t bit, Entity::EntityType entity) {
+  const bool bandit = entity == Entity::EntityType::Bandit;
+  if (bandit != bandits_.Test(bit)) {
+    if (bandit) {
+      bandits_.Set(bit);
+      ++bandit_count_;
+    } else {
+      bandits_.Reset(bit);
+      --bandit_count_;
+    }
+  }
+  if (!IsFreeEntity(entity)) {
+    occupied_.Set(bit);
+  } else {
+    occupied_.Reset(bit);
+  }
+}
+
+}  // namespace konkr
@@ -0,0 +1,94 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+//
+// bandit_system.h
+//
+// Declares the BanditSystem class, which moves every bandit of a map in one
+// pass at the end of a turn.
+//
+
+#ifndef KONKR_WORLD_BANDIT_SYSTEM_H
+#define KONKR_WORLD_BANDIT_SYSTEM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "core/bitset.h"
+#include "core/random.h"
+#include "rendering/graphics.h"
+#include "world/entity.h"
+#include "world/move_generator.h"
+#include "world/tile.h"
+#include "world/tile_observer.h"
+
+namespace konkr {
+
+// Follows the bandits of a map (the units of bankrupt regions, see
+// Level::UpdateMoney) and moves each of them to a random free tile next to
+// it, of the same owner, so they roam their region without leaving it.
+//
+// What a move depends on is kept as sets of the bits of a HexGrid, up to date
+// as the tiles change (the system observes them, see Reset): the land tiles,
+// the tiles holding an entity and those holding a bandit, and the owner of
+// every tile. A pass gathers the bandits into an array, row by row, and looks
+// their neighbours up at the offsets of HexGrid::neighbor_offsets, without
+// reading the tiles. The bandits move in that order, each seeing the tiles
+// the ones before it took or left, so two bandits never pick the same tile
+// and the same state and random stream always give the same moves.
+class BanditSystem : public TileObserver {
+ public:
+  using Tiles = std::vector<std::vector<std::shared_ptr<Tile>>>;
+
+  struct Move {
+    size_t from;  // Bits of grid
+    size_t to;
+  };
+
+  // Reads the bandits of tiles, laid out as grid, whose changes must then be
+  // passed to it. grid must outlive the system, or the next Reset.
+  void Reset(const HexGrid& grid, const Tiles& tiles);
+
+  // Starts from a map laid out as grid without land, whose tiles are then
+  // described by SetTile, for the copies of a map that don't observe tiles
+  // (see CompactState)
+  void Reset(const HexGrid& grid);
+  // Describes the land tile at bit: its owner, -1 for none, and the type of
+  // its entity, Unknown for none
+  void SetTile(size_t bit, int owner, Entity::EntityType entity);
+
+  // Moves every bandit that has a free tile next to it, drawing the tiles
+  // from random. The system then expects the tiles to change accordingly:
+  // the moves are returned for the caller to apply them, in order. Valid
+  // until the next call.
+  std::span<const Move> MoveBandits(RandomStream& random);
+
+  inline size_t bandit_count() const { return bandit_count_; }
+
+  void OnTileChanged(Vector2i position, TileField field, int old_value,
+                     int new_value) override;
+  void OnEntityChanged(Vector2i position,
+                       const std::shared_ptr<Entity>& old_entity,
+                       const std::shared_ptr<Entity>& new_entity) override;
+
+ private:
+  // Records the type of the entity at bit, Unknown for none
+  void SetEntity(size_t bit, Entity::EntityType entity);
+
+  const HexGrid* grid_ = nullptr;
+  Bitset land_;
+  Bitset occupied_;  // Tiles whose entity isn't free (see IsFreeEntity)
+  Bitset bandits_;
+  std::vector<int8_t> owners_;  // -1 for none
+  size_t bandit_count_ = 0;
+  // Buffers of MoveBandits
+  std::vector<size_t> positions_;
+  std::vector<Move> moves_;
+};
+
+}  // namespace konkr
+
+#endif  // KONKR_WORLD_BANDIT_SYSTEM_H
@@ -0,0 +1,111 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+
+#include "world/change_bus.h"
+
+#include <algorithm>
+
+#include "world/entity.h"
+
+namespace konkr {
+
+namespace {
+
+int EntityValue(const std::shared_ptr<Entity>& entity) {
+  return entity ? static_cast<int>(entity->type()) : -1;
+}
+
+}  // namespace
+
+size_t ChangeBus::Subscribe() {
+  const uint64_t next_event = first_event_ + events_.size();
+  ++subscriber_count_;
+  for (size_t i = 0; i < cursors_.size(); ++i) {
+    if (!cursors_[i]) {
+      cursors_[i] = next_event;
+      return i;
+    }
+  }
+  cursors_.push_back(next_event);
+  return cursors_.size() - 1;
+}
+
+void ChangeBus::Unsubscribe(size_t subscriber) {
+  if (subscriber >= cursors_.size() || !cursors_[subscriber]) return;
+  cursors_[subscriber].reset();
+  if (--subscriber_count_ == 0) {
+    first_event_ += events_.size();
+    events_.clear();
+  }
+}
+
+std::span<const ChangeEvent> ChangeBus::Drain(size_t subscriber) {
+  if (subscriber >= cursors_.size() || !cursors_[subscriber]) return {};
+  uint64_t& cursor = *cursors_[subscriber];
+
+  // Drops the events every subscriber read, this one's included
+  uint64_t oldest = cursor;
+  for (const auto& other : cursors_) {
+    if (other) oldest = std::min(oldest, *other);
+  }
+  if (oldest > first_event_) {
+    const auto read = static_cast<ptrdiff_t>(oldest - first_event_);
+    events_.erase(events_.begin(), events_.begin() + read);
+    first_event_ = oldest;
+  }
+
+  // A cursor before the first event missed the events dropped on overflow,
+  // and gets the Reset that replaced them
+  const uint64_t begin = std::max(cursor, first_event_);
+  cursor = first_event_ + events_.size();
+  return std::span<const ChangeEvent>(events_).subspan(begin - first_event_);
+}
+
+void ChangeBus::OnTileChanged(Vector2i position, TileField field,
+                              int old_value, int new_value) {
+  Append({.kind = ChangeEvent::Kind::Tile,
+          .field = field,
+          .position = position,
+          .old_value = old_value,
+          .new_value = new_value});
+}
+
+void ChangeBus::OnEntityChanged(Vector2i position,
+                                const std::shared_ptr<Entity>& old_entity,
+                                const std::shared_ptr<Entity>& new_entity) {
+  Append({.kind = ChangeEvent::Kind::Entity,
+          .position = position,
+          .old_value = EntityValue(old_entity),
+          .new_value = EntityValue(new_entity)});
+}
+
+void ChangeBus::OnPlayerRemoved(int id) {
+  Append({.kind = ChangeEvent::Kind::PlayerRemoved, .old_value = id});
+}
+
+void ChangeBus::OnCurrentPlayerChanged(size_t old_index, size_t new_index) {
+  Append({.kind = ChangeEvent::Kind::CurrentPlayer,
+          .old_value = static_cast<int>(old_index),
+          .new_value = static_cast<int>(new_index)});
+}
+
+void ChangeBus::OnTurnChanged(uint32_t old_turn, uint32_t new_turn) {
+  Append({.kind = ChangeEvent::Kind::Turn,
+          .old_value = static_cast<int>(old_turn),
+          .new_value = static_cast<int>(new_turn)});
+}
+
+void ChangeBus::OnReset() { Append({.kind = ChangeEvent::Kind::Reset}); }
+
+void ChangeBus::Append(const ChangeEvent& event) {
+  if (subscriber_count_ == 0) return;
+  if (events_.size() >= kMaxEvents) {
+    first_event_ += events_.size();
+    events_.clear();
+    events_.push_back({.kind = ChangeEvent::Kind::Reset});
+  }
+  events_.push_back(event);
+}
+
+}  // namespace konkr
@@ -0,0 +1,95 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+//
+// change_bus.h
+//
+// Declares the ChangeBus class, which records the changes of a game as a
+// buffer of events read in bulk by its subscribers, and the ChangeEvent
+// struct.
+//
+
+#ifndef KONKR_WORLD_CHANGE_BUS_H
+#define KONKR_WORLD_CHANGE_BUS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "rendering/graphics.h"
+#include "world/tile_observer.h"
+
+namespace konkr {
+
+// A change of a game, in 20 bytes
+struct ChangeEvent {
+  enum class Kind : uint8_t {
+    Tile,    // field of the tile at position, or of its entity, changed
+    Entity,  // The entity of the tile at position was replaced, the values
+             // are entity types, -1 for none
+    PlayerRemoved,  // Player old_value was eliminated
+    CurrentPlayer,  // Index of the current player in the active players
+    Turn,
+    // Anything may have changed (the tiles were created or restored, or
+    // events were dropped): the subscribers read the whole game again
+    Reset,
+  };
+
+  Kind kind = Kind::Reset;
+  TileField field = TileField::Owner;  // For Tile
+  Vector2i position = {0, 0};          // For Tile and Entity
+  int old_value = 0;
+  int new_value = 0;
+};
+
+// Observes the tiles of a level and is told of the changes of its players
+// (see Level::change_bus), and appends each change as an event to a buffer.
+// Rather than being called back at every change, a subscriber drains the
+// events since its last Drain at once, when it needs to be up to date (once
+// a frame for the renderer), so it only redoes the work of what changed.
+//
+// The events are kept until every subscriber drained them, and nothing is
+// recorded while there is no subscriber. A subscriber that never drains
+// doesn't hold more than kMaxEvents events: past that the buffer is cleared
+// and starts with a Reset.
+class ChangeBus : public TileObserver {
+ public:
+  static constexpr size_t kMaxEvents = 1 << 16;
+
+  // Returns the id of a new subscriber, which gets the events from now on
+  size_t Subscribe();
+  void Unsubscribe(size_t subscriber);
+
+  // Returns the events since the last Drain of subscriber, in the order they
+  // happened. Valid until the next event or Drain.
+  std::span<const ChangeEvent> Drain(size_t subscriber);
+
+  void OnTileChanged(Vector2i position, TileField field, int old_value,
+                     int new_value) override;
+  void OnEntityChanged(Vector2i position,
+                       const std::shared_ptr<Entity>& old_entity,
+                       const std::shared_ptr<Entity>& new_entity) override;
+
+  void OnPlayerRemoved(int id);
+  void OnCurrentPlayerChanged(size_t old_index, size_t new_index);
+  void OnTurnChanged(uint32_t old_turn, uint32_t new_turn);
+  void OnReset();
+
+ private:
+  void Append(const ChangeEvent& event);
+
+  std::vector<ChangeEvent> events_;
+  // Number of the first event of events_, counting every event recorded
+  uint64_t first_event_ = 0;
+  // Number of the next event each subscriber reads, none for the ids free
+  // for new subscribers
+  std::vector<std::optional<uint64_t>> cursors_;
+  size_t subscriber_count_ = 0;
+};
+
+}  // namespace konkr
+
+#endif  // KONKR_WORLD_CHANGE_BUS_H
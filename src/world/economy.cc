@@ -0,0 +1,196 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+
+#include "world/economy.h"
+
+#include <algorithm>
+
+#include "world/entity.h"
+#include "world/townhall.h"
+
+namespace konkr {
+
+void Economy::Reset(const HexGrid& grid, const Tiles& tiles) {
+  grid_ = &grid;
+  const size_t bit_count = grid.bit_count();
+  land_.Assign(bit_count);
+  owners_.assign(bit_count, -1);
+  townhall_tiles_.Assign(bit_count);
+  upkeeps_.assign(bit_count, 0);
+  tile_money_.assign(bit_count, 0);
+  regions_.assign(bit_count, kNoRegion);
+  for (const auto& row : tiles) {
+    for (const auto& tile : row) {
+      if (!tile || !Tile::is_sand(tile->type())) continue;
+      const size_t bit = grid.bit(tile->grid_position());
+      land_.Set(bit);
+      SetOwner(bit, tile->get_owner().value_or(-1));
+      SetEntity(bit, tile->entity().get());
+    }
+  }
+  regions_changed_ = true;
+  Update();
+}
+
+void Economy::Update() {
+  if (regions_changed_) FindRegions();
+  if (forecast_changed_) Forecast();
+}
+
+void Economy::OnTileChanged(Vector2i position, TileField field,
+                            int /*old_value*/, int new_value) {
+  if (!grid_ || !grid_->contains(position)) return;
+  const size_t bit = grid_->bit(position);
+  if (!land_.Test(bit)) return;
+  switch (field) {
+    case TileField::Owner:
+      SetOwner(bit, new_value);
+      break;
+    case TileField::EntityUpkeep:
+      // The upkeep of a townhall is the income of its region
+      if (!townhall_tiles_.Test(bit)) SetUpkeep(bit, new_value);
+      break;
+    case TileField::Money:
+      tile_money_[bit] = new_value;
+      forecast_changed_ = true;
+      break;
+    default:
+      break;
+  }
+}
+
+void Economy::OnEntityChanged(Vector2i position,
+                              const std::shared_ptr<Entity>& /*old_entity*/,
+                              const std::shared_ptr<Entity>& new_entity) {
+  if (!grid_ || !grid_->contains(position)) return;
+  const size_t bit = grid_->bit(position);
+  if (land_.Test(bit)) SetEntity(bit, new_entity.get());
+}
+
+void Economy::SetOwner(size_t bit, int owner) {
+  if (owner == owners_[bit]) return;
+  owners_[bit] = static_cast<int8_t>(owner);
+  regions_changed_ = true;
+}
+
+void Economy::SetEntity(size_t bit, const Entity* entity) {
+  const bool townhall =
+      entity && entity->type() == Entity::EntityType::Townhall;
+  if (townhall != townhall_tiles_.Test(bit)) {
+    if (townhall) {
+      townhall_tiles_.Set(bit);
+    } else {
+      townhall_tiles_.Reset(bit);
+    }
+    regions_changed_ = true;
+  }
+  if (townhall) {
+    tile_money_[bit] = static_cast<const Townhall*>(entity)->money();
+    forecast_changed_ = true;
+  }
+  SetUpkeep(bit, entity && !townhall ? entity->upkeep_cost() : 0);
+}
+
+void Economy::SetUpkeep(size_t bit, int32_t upkeep) {
+  const int32_t difference = upkeep - upkeeps_[bit];
+  if (difference == 0) return;
+  upkeeps_[bit] = upkeep;
+  // Once the regions are to be found again, their incomes are summed again
+  if (!regions_changed_ && regions_[bit] != kNoRegion) {
+    region_incomes_[regions_[bit]] += difference;
+    forecast_changed_ = true;
+  }
+}
+
+void Economy::FindRegions() {
+  // The townhalls of players, by owner then position
+  positions_.clear();
+  townhall_tiles_.ForEach([this](size_t bit) {
+    const int owner = owners_[bit];
+    if (owner >= 0 && static_cast<size_t>(owner) < kMaxPlayers) {
+      positions_.push_back(bit);
+    }
+  });
+  std::stable_sort(positions_.begin(), positions_.end(),
+                   [this](size_t a, size_t b) {
+                     return owners_[a] < owners_[b];
+                   });
+  size_t index = 0;
+  for (size_t player = 0; player <= kMaxPlayers; ++player) {
+    while (index < positions_.size() &&
+           static_cast<size_t>(owners_[positions_[index]]) < player) {
+      ++index;
+    }
+    player_townhalls_[player] = index;
+  }
+
+  // Townhalls of the same region share it, and its whole income, as in
+  // Level::UpdateTilesLevel
+  std::fill(regions_.begin(), regions_.end(), kNoRegion);
+  region_incomes_.clear();
+  const auto bit_count = static_cast<ptrdiff_t>(grid_->bit_count());
+  townhall_regions_.resize(positions_.size());
+  for (size_t i = 0; i < positions_.size(); ++i) {
+    const size_t bit = positions_[i];
+    if (regions_[bit] != kNoRegion) {
+      townhall_regions_[i] = regions_[bit];
+      continue;
+    }
+    // Flood fill over the neighbour offsets, the tiles of other regions being
+    // of other owners
+    const auto region = static_cast<int32_t>(region_incomes_.size());
+    const int owner = owners_[bit];
+    int32_t income = 0;
+    regions_[bit] = region;
+    stack_.assign(1, bit);
+    while (!stack_.empty()) {
+      const size_t tile = stack_.back();
+      stack_.pop_back();
+      income += upkeeps_[tile];
+      for (const ptrdiff_t offset :
+           grid_->neighbor_offsets(tile / grid_->stride())) {
+        const ptrdiff_t neighbor = static_cast<ptrdiff_t>(tile) + offset;
+        if (neighbor < 0 || neighbor >= bit_count ||
+            owners_[neighbor] != owner || regions_[neighbor] != kNoRegion) {
+          continue;
+        }
+        regions_[neighbor] = region;
+        stack_.push_back(neighbor);
+      }
+    }
+    region_incomes_.push_back(income);
+    townhall_regions_[i] = region;
+  }
+  regions_changed_ = false;
+  forecast_changed_ = true;
+}
+
+void Economy::Forecast() {
+  const size_t count = positions_.size();
+  money_.resize(count);
+  income_.resize(count);
+  for (size_t i = 0; i < count; ++i) {
+    money_[i] = tile_money_[positions_[i]];
+    income_[i] = region_incomes_[townhall_regions_[i]];
+  }
+
+  // Turn by turn, over all the townhalls at once
+  bankruptcy_turns_.assign(count, 0);
+  forecasts_.resize(kForecastTurns * count);
+  const int32_t* income = income_.data();
+  int32_t* bankruptcy = bankruptcy_turns_.data();
+  const int32_t* previous = money_.data();
+  for (int turn = 1; turn <= kForecastTurns; ++turn) {
+    int32_t* money = forecasts_.data() + (turn - 1) * count;
+    for (size_t i = 0; i < count; ++i) {
+      money[i] = previous[i] + income[i];
+      const bool bankrupt = bankruptcy[i] == 0 && money[i] < 0;
+      bankruptcy[i] = bankrupt ? turn : bankruptcy[i];
+    }
+    previous = money;
+  }
+  forecast_changed_ = false;
+}
+
+}  // namespace konkr
@@ -0,0 +1,134 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+//
+// economy.h
+//
+// Declares the Economy class, which keeps the income of the region of every
+// townhall of a map and forecasts their money over the next turns.
+//
+
+#ifndef KONKR_WORLD_ECONOMY_H
+#define KONKR_WORLD_ECONOMY_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "core/bitset.h"
+#include "rendering/graphics.h"
+#include "world/move_generator.h"
+#include "world/rules.h"
+#include "world/tile.h"
+#include "world/tile_observer.h"
+
+namespace konkr {
+
+// The economy of Level::UpdateTilesLevel and UpdateMoney, for every townhall
+// at once: the income of a townhall is the sum of the upkeep of the entities
+// of its region (the tiles of its owner connected to it), other townhalls
+// excepted, and is added to its money at the end of every turn of its owner.
+// A townhall whose money goes below 0 goes bankrupt: its units become
+// bandits.
+//
+// The economy observes the tiles (see Reset). The regions are found again,
+// by flood fills over HexGrid::neighbor_offsets, only after an owner changed
+// or a townhall was placed or destroyed; a change of upkeep within a region
+// only adds the difference to its income. The townhalls are kept as arrays
+// of their money and income, sorted by owner, from which Update forecasts
+// the money of all of them for kForecastTurns turns in one pass over the
+// arrays (which compilers vectorize), assuming the regions don't change.
+class Economy : public TileObserver {
+ public:
+  using Tiles = std::vector<std::vector<std::shared_ptr<Tile>>>;
+
+  static constexpr int kForecastTurns = 8;
+
+  // Reads the townhalls and regions of tiles, laid out as grid, whose changes
+  // must then be passed to it. grid must outlive the economy, or the next
+  // Reset.
+  void Reset(const HexGrid& grid, const Tiles& tiles);
+
+  // Brings the arrays below up to date with the changes of the tiles, does
+  // nothing if none changed them
+  void Update();
+
+  // Indices of the townhalls of player in the arrays below, from first to
+  // last exclusive, in the order of their positions
+  inline std::pair<size_t, size_t> townhalls(int player) const {
+    if (player < 0 || static_cast<size_t>(player) >= kMaxPlayers) return {};
+    return {player_townhalls_[player], player_townhalls_[player + 1]};
+  }
+
+  inline size_t townhall_count() const { return positions_.size(); }
+  // Bits of grid
+  inline std::span<const size_t> positions() const { return positions_; }
+  inline std::span<const int32_t> money() const { return money_; }
+  // Added to the money at the end of every turn of the owner, negative when
+  // the region costs more than it earns
+  inline std::span<const int32_t> income() const { return income_; }
+  // Number of turns of the owner until the townhall goes bankrupt, 0 if it
+  // doesn't within kForecastTurns
+  inline std::span<const int32_t> bankruptcy_turns() const {
+    return bankruptcy_turns_;
+  }
+  // Money of the townhall at index after turns turns of its owner, 1 <=
+  // turns <= kForecastTurns
+  inline int32_t forecast(size_t index, int turns) const {
+    return forecasts_[(turns - 1) * positions_.size() + index];
+  }
+
+  void OnTileChanged(Vector2i position, TileField field, int old_value,
+                     int new_value) override;
+  void OnEntityChanged(Vector2i position,
+                       const std::shared_ptr<Entity>& old_entity,
+                       const std::shared_ptr<Entity>& new_entity) override;
+
+ private:
+  static constexpr int32_t kNoRegion = -1;
+
+  // Records the owner of the tile at bit
+  void SetOwner(size_t bit, int owner);
+  // Records the entity at bit, nullptr for none
+  void SetEntity(size_t bit, const Entity* entity);
+  // Records the upkeep counted for the entity at bit
+  void SetUpkeep(size_t bit, int32_t upkeep);
+
+  // Lists the townhalls and finds their regions and incomes again
+  void FindRegions();
+  void Forecast();
+
+  const HexGrid* grid_ = nullptr;
+  Bitset land_;
+  std::vector<int8_t> owners_;  // -1 for none, on land only
+  Bitset townhall_tiles_;
+  // Upkeep of the entity of every tile, 0 for townhalls and for none
+  std::vector<int32_t> upkeeps_;
+  // Money of the townhall of every tile
+  std::vector<int32_t> tile_money_;
+  // Region of every tile, kNoRegion outside the regions of townhalls
+  std::vector<int32_t> regions_;
+  std::vector<int32_t> region_incomes_;
+  bool regions_changed_ = true;
+  bool forecast_changed_ = true;
+
+  // The townhalls, by owner then position
+  std::vector<size_t> positions_;
+  std::vector<int32_t> townhall_regions_;
+  std::vector<int32_t> money_;
+  std::vector<int32_t> income_;
+  std::vector<int32_t> bankruptcy_turns_;
+  // Money after turn t + 1 of every townhall at t * townhall_count() + index
+  std::vector<int32_t> forecasts_;
+  std::array<size_t, kMaxPlayers + 1> player_townhalls_ = {};
+
+  std::vector<size_t> stack_;  // Of FindRegions
+};
+
+}  // namespace konkr
+
+#endif  // KONKR_WORLD_ECONOMY_H
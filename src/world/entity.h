@@ -9,11 +9,13 @@
 #ifndef KONKR_WORLD_ENTITY_H
 #define KONKR_WORLD_ENTITY_H
 
+#include <cstdint>
 #include <iostream>
 #include <memory>
 #include <string>
 
 #include "rendering/graphics.h"
+#include "world/tile_observer.h"
 
 namespace konkr {
 
@@ -24,7 +26,7 @@ std::string entity_format_display_name(const std::string& sprite_name);
   by the game itself, in the case of bandits). */
 class Entity {
  public:
-  enum class EntityType {
+  enum class EntityType : uint8_t {
     Forest,
     Townhall,
     Castle,
@@ -33,6 +35,10 @@ class Entity {
     Unknown
   };
 
+  // Number of values of EntityType, for tables indexed by entity type
+  static constexpr size_t kEntityTypeCount =
+      static_cast<size_t>(EntityType::Unknown) + 1;
+
   static inline bool is_building(char c) { return is_townhall(c) || c == 'C'; }
 
   static inline bool is_townhall(char c) { return c == 'T'; }
@@ -56,9 +62,16 @@ class Entity {
     }
   }
 
-  static const EntityType char_to_entity_type(char type) {
-    std::cout << "char_to_entity_type: " << type << std::endl;
+  // Inverse of entity_type_to_string, Unknown if the name matches no type
+  static EntityType string_to_entity_type(const std::string& name) {
+    for (size_t i = 0; i < kEntityTypeCount; ++i) {
+      auto type = static_cast<EntityType>(i);
+      if (entity_type_to_string(type) == name) return type;
+    }
+    return EntityType::Unknown;
+  }
 
+  static const EntityType char_to_entity_type(char type) {
     switch (type) {
       case 'F':
         return EntityType::Forest;
@@ -93,7 +106,10 @@ class Entity {
   inline bool is_bandit() { return type() == EntityType::Bandit; }
 
   inline int level() const { return level_; }
-  inline void setLevel(int level) { level_ = level; }
+  inline void setLevel(int level) {
+    Notify(TileField::EntityLevel, level_, level);
+    level_ = level;
+  }
 
   virtual void IncreaseLevel() {}
   virtual void DecreaseLevel() {}
@@ -105,20 +121,43 @@ class Entity {
   inline bool is_human_unit() { return type_ == EntityType::HumanUnit; }
 
   virtual int upkeep_cost() const { return upkeep_cost_; }
-  inline void set_upkeep_cost(int upkeep_cost) { upkeep_cost_ = upkeep_cost; }
+  inline void set_upkeep_cost(int upkeep_cost) {
+    Notify(TileField::EntityUpkeep, upkeep_cost_, upkeep_cost);
+    upkeep_cost_ = upkeep_cost;
+  }
+
+  // Units move once per turn
+  inline bool has_moved() const { return moved_; }
+  inline void set_moved(bool moved) {
+    Notify(TileField::Moved, moved_, moved);
+    moved_ = moved;
+  }
 
   inline Vector2i grid_position() const { return grid_position_; }
   inline void set_grid_position(Vector2i grid_position) {
     grid_position_ = grid_position;
   }
 
+  // Set by the tile holding the entity (see Tile::set_observer)
+  inline void set_observer(TileObserver* observer) { observer_ = observer; }
+
+ protected:
+  // Notifies the observer of the tile holding the entity
+  inline void Notify(TileField field, int old_value, int new_value) {
+    if (observer_ && old_value != new_value) {
+      observer_->OnTileChanged(grid_position_, field, old_value, new_value);
+    }
+  }
+
  private:
   EntityType type_;
   int level_ = 0;
   int upkeep_cost_ = 1;
+  bool moved_ = false;
   std::string sprite_name_;
   std::string name_;
   Vector2i grid_position_ = {0, 0};
+  TileObserver* observer_ = nullptr;
 };
 
 std::unique_ptr<Entity> CreateEntity(Entity::EntityType type, int level = 0);
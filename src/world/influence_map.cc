@@ -0,0 +1,224 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+
+#include "world/influence_map.h"
+
+#include <algorithm>
+
+namespace konkr {
+
+void InfluenceMap::Reset(const HexGrid& grid, const Tiles& tiles) {
+  grid_ = &grid;
+  const size_t bit_count = grid.bit_count();
+  owners_.assign(bit_count, -1);
+  types_.assign(bit_count, Entity::EntityType::Unknown);
+  levels_.assign(bit_count, 0);
+  unit_owners_.assign(bit_count, -1);
+  unit_attacks_.assign(bit_count, 0);
+  for (auto& counts : counts_) counts.clear();
+  for (auto& attacks : attacks_) attacks.clear();
+  first_threats_.assign(bit_count, 0);
+  first_owners_.assign(bit_count, -1);
+  second_threats_.assign(bit_count, 0);
+  defenses_.assign(bit_count, 0);
+  if (bit_count == 0) return;
+
+  for (const auto& row : tiles) {
+    for (const auto& tile : row) {
+      if (!tile) continue;
+      const size_t bit = grid.bit(tile->grid_position());
+      owners_[bit] = static_cast<int8_t>(tile->get_owner().value_or(-1));
+      if (const auto& entity = tile->entity()) {
+        types_[bit] = entity->type();
+        levels_[bit] = static_cast<int8_t>(entity->level());
+      }
+    }
+  }
+
+  // Counts every unit, then derives the threats of the whole grid once
+  const Area grid_area = {0, static_cast<int>(grid.rows()) - 1, 0,
+                          static_cast<int>(grid.columns()) - 1};
+  for (size_t bit = 0; bit < bit_count; ++bit) {
+    const int owner = owners_[bit];
+    const int attack = AttackOf(types_[bit], levels_[bit]);
+    if (owner < 0 || static_cast<size_t>(owner) >= kMaxPlayers ||
+        attack <= 0) {
+      continue;
+    }
+    unit_owners_[bit] = static_cast<int8_t>(owner);
+    unit_attacks_[bit] = static_cast<uint8_t>(attack);
+    auto& counts = counts_[owner];
+    if (counts.empty()) {
+      counts.assign(kMaxStrength * bit_count, 0);
+      attacks_[owner].assign(bit_count, 0);
+    }
+    const Vector2i position = grid.position(bit);
+    const Area area = AreaAround(position);
+    for (int row = area.first_row; row <= area.last_row; ++row) {
+      for (int column = area.first_column; column <= area.last_column;
+           ++column) {
+        if (HexGrid::Distance(position, {row, column}) > kReach) continue;
+        ++counts[(attack - 1) * bit_count + grid.bit({row, column})];
+      }
+    }
+  }
+  for (size_t player = 0; player < kMaxPlayers; ++player) {
+    if (!counts_[player].empty()) {
+      UpdateAttacks(static_cast<int>(player), grid_area);
+    }
+  }
+  UpdateThreats(grid_area);
+
+  for (size_t bit = 0; bit < bit_count; ++bit) {
+    defenses_[bit] = static_cast<uint8_t>(ComputeDefense(bit));
+  }
+}
+
+void InfluenceMap::OnTileChanged(Vector2i position, TileField field,
+                                 int /*old_value*/, int new_value) {
+  if (!grid_ || !grid_->contains(position)) return;
+  const size_t bit = grid_->bit(position);
+  switch (field) {
+    case TileField::Owner:
+      owners_[bit] = static_cast<int8_t>(new_value);
+      break;
+    case TileField::EntityLevel:
+      levels_[bit] = static_cast<int8_t>(new_value);
+      break;
+    default:
+      return;
+  }
+  UpdateUnit(bit);
+  UpdateDefenses(bit);
+}
+
+void InfluenceMap::OnEntityChanged(
+    Vector2i position, const std::shared_ptr<Entity>& /*old_entity*/,
+    const std::shared_ptr<Entity>& new_entity) {
+  if (!grid_ || !grid_->contains(position)) return;
+  const size_t bit = grid_->bit(position);
+  types_[bit] = new_entity ? new_entity->type() : Entity::EntityType::Unknown;
+  levels_[bit] = static_cast<int8_t>(new_entity ? new_entity->level() : 0);
+  UpdateUnit(bit);
+  UpdateDefenses(bit);
+}
+
+InfluenceMap::Area InfluenceMap::AreaAround(Vector2i position) const {
+  // The tiles within kReach of a tile are at most kReach columns away from it
+  return {std::max(position.x - kReach, 0),
+          std::min(position.x + kReach, static_cast<int>(grid_->rows()) - 1),
+          std::max(position.y - kReach, 0),
+          std::min(position.y + kReach,
+                   static_cast<int>(grid_->columns()) - 1)};
+}
+
+void InfluenceMap::UpdateUnit(size_t bit) {
+  const int owner = owners_[bit];
+  int attack = AttackOf(types_[bit], levels_[bit]);
+  if (owner < 0 || static_cast<size_t>(owner) >= kMaxPlayers) attack = 0;
+  const int unit_owner = attack > 0 ? owner : -1;
+  if (unit_owner == unit_owners_[bit] && attack == unit_attacks_[bit]) return;
+
+  if (unit_owners_[bit] >= 0) {
+    CountUnit(bit, unit_owners_[bit], unit_attacks_[bit], -1);
+  }
+  unit_owners_[bit] = static_cast<int8_t>(unit_owner);
+  unit_attacks_[bit] = static_cast<uint8_t>(attack);
+  if (unit_owner >= 0) CountUnit(bit, unit_owner, attack, 1);
+}
+
+void InfluenceMap::CountUnit(size_t bit, int player, int attack, int delta) {
+  const size_t bit_count = grid_->bit_count();
+  auto& counts = counts_[player];
+  if (counts.empty()) {
+    counts.assign(kMaxStrength * bit_count, 0);
+    attacks_[player].assign(bit_count, 0);
+  }
+
+  const Vector2i position = grid_->position(bit);
+  const Area area = AreaAround(position);
+  uint8_t* level_counts = counts.data() + (attack - 1) * bit_count;
+  for (int row = area.first_row; row <= area.last_row; ++row) {
+    for (int column = area.first_column; column <= area.last_column;
+         ++column) {
+      if (HexGrid::Distance(position, {row, column}) > kReach) continue;
+      level_counts[grid_->bit({row, column})] += delta;
+    }
+  }
+  UpdateAttacks(player, area);
+  UpdateThreats(area);
+}
+
+void InfluenceMap::UpdateAttacks(int player, const Area& area) {
+  const size_t bit_count = grid_->bit_count();
+  const uint8_t* counts = counts_[player].data();
+  uint8_t* attacks = attacks_[player].data();
+  const size_t length = area.last_column - area.first_column + 1;
+  for (int row = area.first_row; row <= area.last_row; ++row) {
+    const size_t begin = grid_->bit({row, area.first_column});
+    uint8_t* out = attacks + begin;
+    std::fill(out, out + length, 0);
+    for (int attack = 1; attack <= kMaxStrength; ++attack) {
+      const uint8_t* in = counts + (attack - 1) * bit_count + begin;
+      for (size_t i = 0; i < length; ++i) {
+        out[i] = in[i] ? static_cast<uint8_t>(attack) : out[i];
+      }
+    }
+  }
+}
+
+void InfluenceMap::UpdateThreats(const Area& area) {
+  const size_t length = area.last_column - area.first_column + 1;
+  for (int row = area.first_row; row <= area.last_row; ++row) {
+    const size_t begin = grid_->bit({row, area.first_column});
+    uint8_t* first = first_threats_.data() + begin;
+    int8_t* first_owner = first_owners_.data() + begin;
+    uint8_t* second = second_threats_.data() + begin;
+    std::fill(first, first + length, 0);
+    std::fill(first_owner, first_owner + length, -1);
+    std::fill(second, second + length, 0);
+    for (size_t player = 0; player < kMaxPlayers; ++player) {
+      if (attacks_[player].empty()) continue;
+      const uint8_t* attacks = attacks_[player].data() + begin;
+      const auto id = static_cast<int8_t>(player);
+      // Every player has a single attack per tile, so the second strongest
+      // is the strongest of those not first
+      for (size_t i = 0; i < length; ++i) {
+        const uint8_t attack = attacks[i];
+        second[i] = std::max(second[i], std::min(first[i], attack));
+        first_owner[i] = attack > first[i] ? id : first_owner[i];
+        first[i] = std::max(first[i], attack);
+      }
+    }
+  }
+}
+
+void InfluenceMap::UpdateDefenses(size_t bit) {
+  defenses_[bit] = static_cast<uint8_t>(ComputeDefense(bit));
+  const auto bit_count = static_cast<ptrdiff_t>(grid_->bit_count());
+  for (const ptrdiff_t offset :
+       grid_->neighbor_offsets(bit / grid_->stride())) {
+    const ptrdiff_t neighbor = static_cast<ptrdiff_t>(bit) + offset;
+    if (neighbor < 0 || neighbor >= bit_count) continue;
+    defenses_[neighbor] = static_cast<uint8_t>(ComputeDefense(neighbor));
+  }
+}
+
+int InfluenceMap::ComputeDefense(size_t bit) const {
+  const int owner = owners_[bit];
+  if (owner < 0) return 0;
+  int defense = DefenseAt(bit);
+  const auto bit_count = static_cast<ptrdiff_t>(grid_->bit_count());
+  for (const ptrdiff_t offset :
+       grid_->neighbor_offsets(bit / grid_->stride())) {
+    const ptrdiff_t neighbor = static_cast<ptrdiff_t>(bit) + offset;
+    if (neighbor < 0 || neighbor >= bit_count || owners_[neighbor] != owner) {
+      continue;
+    }
+    defense = std::max(defense, DefenseAt(neighbor));
+  }
+  return defense;
+}
+
+}  // namespace konkr
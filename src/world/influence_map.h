@@ -0,0 +1,145 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+//
+// influence_map.h
+//
+// Declares the InfluenceMap class, which keeps for every tile of a map the
+// strongest enemy unit that threatens it and the defense of its owner.
+//
+
+#ifndef KONKR_WORLD_INFLUENCE_MAP_H
+#define KONKR_WORLD_INFLUENCE_MAP_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "rendering/graphics.h"
+#include "world/entity.h"
+#include "world/move_generator.h"
+#include "world/rules.h"
+#include "world/tile.h"
+#include "world/tile_observer.h"
+
+namespace konkr {
+
+// For every tile, as flat arrays of bytes indexed by the bits of a HexGrid:
+// - the threat to a player: the strongest attack (see AttackOf) of a unit of
+//   another player within kReach tiles;
+// - the defense of the tile (see DefenseOf), for its owner: the strongest
+//   defense of the entities on it and on its neighbours of the same owner,
+//   the defense MoveGenerator checks captures against. This isn't the level
+//   Level::UpdateTilesLevel marks around the buildings, which only tells
+//   which tiles a building protects, whatever its strength, and ignores the
+//   units.
+// A tile whose threat is above its defense is in danger of being captured
+// (see is_threatened).
+//
+// The map observes the tiles (see Reset) and is kept up to date as units
+// move, are placed, merge or are destroyed, and as tiles change owner. For
+// every player it counts the units of each attack within kReach of every
+// tile, so a unit appearing or leaving only adds or removes itself around
+// its tile. The threats of the rows of that area are then derived again from
+// the counts, row by row over bytes (which compilers vectorize), keeping the
+// two strongest players of every tile so that the threat to any player is
+// read in O(1). A change of owner or of entity only updates the defenses of
+// the tile and of its neighbours (see HexGrid::neighbor_offsets).
+class InfluenceMap : public TileObserver {
+ public:
+  using Tiles = std::vector<std::vector<std::shared_ptr<Tile>>>;
+
+  // Distance up to which a unit threatens the tiles around it. A unit moves
+  // anywhere in its region, so this only estimates its reach from one turn
+  // to the next, but keeps what a unit changes within a few rows.
+  static constexpr int kReach = 2;
+
+  // Reads the units and owners of tiles, laid out as grid, whose changes
+  // must then be passed to it. grid must outlive the map, or the next Reset.
+  void Reset(const HexGrid& grid, const Tiles& tiles);
+
+  // Strongest attack of a unit of another player than player near bit, 0 for
+  // none
+  inline int threat(int player, size_t bit) const {
+    return first_owners_[bit] == player ? second_threats_[bit]
+                                        : first_threats_[bit];
+  }
+
+  // Defense of the tile at bit if player owns it, 0 otherwise
+  inline int defense(int player, size_t bit) const {
+    return owners_[bit] == player ? defenses_[bit] : 0;
+  }
+
+  // Whether a unit of another player near the tile at bit, owned by player,
+  // is strong enough to capture it
+  inline bool is_threatened(int player, size_t bit) const {
+    return owners_[bit] == player && threat(player, bit) > defenses_[bit];
+  }
+
+  // Defense of every tile for its owner, indexed by bit
+  inline std::span<const uint8_t> defenses() const { return defenses_; }
+
+  void OnTileChanged(Vector2i position, TileField field, int old_value,
+                     int new_value) override;
+  void OnEntityChanged(Vector2i position,
+                       const std::shared_ptr<Entity>& old_entity,
+                       const std::shared_ptr<Entity>& new_entity) override;
+
+ private:
+  // Rows and columns of the tiles within kReach of a position, clipped to
+  // the grid
+  struct Area {
+    int first_row;
+    int last_row;
+    int first_column;
+    int last_column;
+  };
+
+  Area AreaAround(Vector2i position) const;
+
+  // Records the unit at bit as it is now, replacing the one recorded
+  void UpdateUnit(size_t bit);
+  // Adds delta units of player with attack to the counts of the tiles within
+  // kReach of bit, then derives the threats of the area again
+  void CountUnit(size_t bit, int player, int attack, int delta);
+  // Derives the strongest attack of player, then the two strongest players,
+  // on the tiles of area
+  void UpdateAttacks(int player, const Area& area);
+  void UpdateThreats(const Area& area);
+
+  // Sets the defenses of the tile at bit and of its neighbours
+  void UpdateDefenses(size_t bit);
+  int ComputeDefense(size_t bit) const;
+  inline int DefenseAt(size_t bit) const {
+    return DefenseOf(types_[bit], levels_[bit]);
+  }
+
+  const HexGrid* grid_ = nullptr;
+  std::vector<int8_t> owners_;  // -1 for none
+  std::vector<Entity::EntityType> types_;  // Unknown for none
+  std::vector<int8_t> levels_;
+  // Unit counted at every bit, by CountUnit: its player (-1 for none) and
+  // attack, which stay as they were until the tile tells otherwise
+  std::vector<int8_t> unit_owners_;
+  std::vector<uint8_t> unit_attacks_;
+
+  // For each player, empty until one of its units is counted: the number
+  // of its units of attack a + 1 within kReach of every bit, at
+  // a * bit_count + bit, and the strongest of them
+  std::array<std::vector<uint8_t>, kMaxPlayers> counts_;
+  std::array<std::vector<uint8_t>, kMaxPlayers> attacks_;
+  // Strongest attack near every bit, the player it's of (-1 for none), and
+  // the strongest attack of the other players
+  std::vector<uint8_t> first_threats_;
+  std::vector<int8_t> first_owners_;
+  std::vector<uint8_t> second_threats_;
+
+  std::vector<uint8_t> defenses_;
+};
+
+}  // namespace konkr
+
+#endif  // KONKR_WORLD_INFLUENCE_MAP_H
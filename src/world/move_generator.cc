@@ -0,0 +1,215 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+
+#include "world/move_generator.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <span>
+#include <utility>
+
+namespace konkr {
+
+namespace {
+
+constexpr ptrdiff_t kWordBits = Bitset::kWordBits;
+
+inline uint64_t WordAt(std::span<const uint64_t> words, ptrdiff_t i) {
+  return i >= 0 && i < static_cast<ptrdiff_t>(words.size()) ? words[i] : 0;
+}
+
+// Word i of words moved by shift bits towards the higher indices (towards
+// the lower ones if shift is negative)
+inline uint64_t ShiftedWord(std::span<const uint64_t> words, ptrdiff_t i,
+                            ptrdiff_t shift) {
+  const ptrdiff_t word_shift =
+      shift >= 0 ? shift / kWordBits : -((kWordBits - 1 - shift) / kWordBits);
+  const auto bit_shift = static_cast<int>(shift - word_shift * kWordBits);
+  const ptrdiff_t source = i - word_shift;
+  uint64_t shifted = WordAt(words, source) << bit_shift;
+  if (bit_shift != 0) {
+    shifted |= WordAt(words, source - 1) >> (kWordBits - bit_shift);
+  }
+  return shifted;
+}
+
+}  // namespace
+
+HexGrid::HexGrid(size_t rows, size_t columns)
+    : rows_(rows),
+      columns_(columns),
+      stride_(columns + 1),
+      positions_(rows * stride_),
+      even_rows_(rows * stride_) {
+  // The columns of the rows above and below are those of an even row, an odd
+  // row is shifted by one (see Tile::GetNeighboringTilesGridPosition)
+  const auto stride = static_cast<ptrdiff_t>(stride_);
+  neighbor_offsets_[0] = {-1, 1, -stride - 1, -stride, stride - 1, stride};
+  neighbor_offsets_[1] = {-1, 1, -stride, -stride + 1, stride, stride + 1};
+  for (size_t row = 0; row < rows; ++row) {
+    for (size_t column = 0; column < columns; ++column) {
+      positions_.Set(row * stride_ + column);
+      if (row % 2 == 0) even_rows_.Set(row * stride_ + column);
+    }
+  }
+}
+
+int HexGrid::Distance(Vector2i from, Vector2i to) {
+  // On axial coordinates, where the neighbours of every tile are at the same
+  // offsets: odd rows are shifted half a tile to the right
+  const int from_column = from.y - (from.x - (from.x & 1)) / 2;
+  const int to_column = to.y - (to.x - (to.x & 1)) / 2;
+  const int columns = to_column - from_column;
+  const int rows = to.x - from.x;
+  return (std::abs(columns) + std::abs(rows) + std::abs(columns + rows)) / 2;
+}
+
+void HexGrid::Dilate(const Bitset& tiles, Bitset& out) const {
+  const auto in = tiles.words();
+  const auto even = even_rows_.words();
+  const auto positions = positions_.words();
+  const auto count = static_cast<ptrdiff_t>(in.size());
+  const auto row = static_cast<ptrdiff_t>(stride_);
+
+  // The tiles of the rows above and below, in the same columns
+  out.Assign(bit_count());
+  const auto vertical = out.words();
+  for (ptrdiff_t i = 0; i < count; ++i) {
+    vertical[i] = ShiftedWord(in, i, row) | ShiftedWord(in, i, -row);
+  }
+  // Then the tiles on both sides in the same row, and the other neighbour in
+  // the rows above and below: an even row gets the previous column of its
+  // neighbouring rows, an odd row the next one (see
+  // Tile::GetNeighboringTilesGridPosition)
+  uint64_t previous = 0;  // Vertical word i - 1, before it was replaced
+  for (ptrdiff_t i = 0; i < count; ++i) {
+    const uint64_t current = vertical[i];
+    const uint64_t next = WordAt(vertical, i + 1);
+    const uint64_t from_previous_column = (current << 1) | (previous >> 63);
+    const uint64_t from_next_column = (current >> 1) | (next << 63);
+    const uint64_t sides = in[i] | (in[i] << 1) | (WordAt(in, i - 1) >> 63) |
+                           (in[i] >> 1) | (WordAt(in, i + 1) << 63);
+    vertical[i] = (sides | current | (from_previous_column & even[i]) |
+                   (from_next_column & ~even[i])) &
+                  positions[i];
+    previous = current;
+  }
+}
+
+void HexGrid::Flood(const Bitset& area, size_t start, Bitset& region,
+                    Bitset& scratch) const {
+  region.Assign(bit_count());
+  if (start >= bit_count() || !area.Test(start)) return;
+  region.Set(start);
+  while (true) {
+    Dilate(region, scratch);
+    scratch &= area;
+    if (scratch == region) return;
+    std::swap(region, scratch);
+  }
+}
+
+void MoveGenerator::Reset(const HexGrid& grid, int player) {
+  grid_ = &grid;
+  player_ = player;
+  land_.Assign(grid.bit_count());
+  free_.Assign(grid.bit_count());
+  owner_count_ = 0;
+  owner_indices_.clear();
+  defended_ready_.fill(false);
+}
+
+MoveGenerator::Owner& MoveGenerator::AddOwner(int id) {
+  const auto index = static_cast<size_t>(id);
+  if (owner_indices_.size() <= index) {
+    owner_indices_.resize(index + 1, kNoOwner);
+  }
+  owner_indices_[index] = owner_count_;
+  if (owner_count_ == owners_.size()) owners_.emplace_back();
+  Owner& owner = owners_[owner_count_++];
+  owner.id = id;
+  owner.tiles.Assign(grid_->bit_count());
+  for (Bitset& defenders : owner.defenders) {
+    defenders.Assign(grid_->bit_count());
+  }
+  return owner;
+}
+
+const MoveGenerator::Owner* MoveGenerator::FindOwner(int id) const {
+  const auto index = static_cast<size_t>(id);
+  if (id < 0 || index >= owner_indices_.size() ||
+      owner_indices_[index] == kNoOwner) {
+    return nullptr;
+  }
+  return &owners_[owner_indices_[index]];
+}
+
+void MoveGenerator::ReplaceTile(size_t bit, int owner, bool free,
+                                int defense) {
+  land_.Reset(bit);
+  free_.Reset(bit);
+  for (size_t i = 0; i < owner_count_; ++i) {
+    owners_[i].tiles.Reset(bit);
+    for (Bitset& defenders : owners_[i].defenders) defenders.Reset(bit);
+  }
+  defended_ready_.fill(false);
+  AddTile(bit, owner, free, defense);
+}
+
+void MoveGenerator::FindRegion(size_t start, Bitset& region) {
+  const Owner* player = FindOwner(player_);
+  if (!player) {
+    region.Assign(grid_->bit_count());
+    return;
+  }
+  grid_->Flood(player->tiles, start, region, scratch_);
+}
+
+void MoveGenerator::FindReachable(const Bitset& region, int attack,
+                                  Bitset& reachable) {
+  reachable = region;
+  reachable &= free_;
+
+  // The border: land around the region, not the player's, not defended
+  // enough to stop the unit
+  if (attack <= 0) return;
+  grid_->Dilate(region, border_);
+  border_ &= land_;
+  if (const Owner* player = FindOwner(player_)) border_.Subtract(player->tiles);
+  if (attack <= kMaxStrength) border_.Subtract(Defended(attack));
+  reachable |= border_;
+}
+
+Bitset MoveGenerator::Reachable(size_t start, int attack) {
+  Bitset region;
+  Bitset reachable;
+  FindRegion(start, region);
+  FindReachable(region, attack, reachable);
+  return reachable;
+}
+
+const Bitset& MoveGenerator::Defended(int strength) {
+  const size_t index = strength - 1;
+  Bitset& defended = defended_[index];
+  if (defended_ready_[index]) return defended;
+  defended.Assign(grid_->bit_count());
+  // An entity defends its tile and the neighbouring tiles of its owner
+  for (size_t i = 0; i < owner_count_; ++i) {
+    const Owner& owner = owners_[i];
+    if (owner.id == player_) continue;
+    defenders_ = owner.defenders[index];
+    for (size_t stronger = index + 1; stronger < kMaxStrength; ++stronger) {
+      defenders_ |= owner.defenders[stronger];
+    }
+    if (!defenders_.Any()) continue;
+    grid_->Dilate(defenders_, scratch_);
+    scratch_ &= owner.tiles;
+    defended |= scratch_;
+  }
+  defended_ready_[index] = true;
+  return defended;
+}
+
+}  // namespace konkr
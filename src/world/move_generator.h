@@ -0,0 +1,176 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+//
+// move_generator.h
+//
+// Declares the HexGrid class, which lays the tiles of a map out as bits, and
+// the MoveGenerator class, which finds every tile a unit can move to with
+// operations on whole sets of tiles.
+//
+
+#ifndef KONKR_WORLD_MOVE_GENERATOR_H
+#define KONKR_WORLD_MOVE_GENERATOR_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include "core/bitset.h"
+#include "rendering/graphics.h"
+#include "world/rules.h"
+
+namespace konkr {
+
+// Gives every position of a map of rows x columns tiles a bit, row by row,
+// with an unused bit after every row. The neighbours of a set of tiles (see
+// Tile::GetNeighboringTilesGridPosition) are then the set shifted by one bit
+// and by a row, plus or minus one bit depending on the parity of the row:
+// the unused bits catch what a shift pushes past the end of a row.
+class HexGrid {
+ public:
+  HexGrid() = default;
+  HexGrid(size_t rows, size_t columns);
+
+  inline size_t rows() const { return rows_; }
+  inline size_t columns() const { return columns_; }
+  // Size of the bitsets of the grid
+  inline size_t bit_count() const { return rows_ * stride_; }
+  // Bits of a row, the unused one included
+  inline size_t stride() const { return stride_; }
+
+  inline size_t bit(Vector2i position) const {
+    return static_cast<size_t>(position.x) * stride_ +
+           static_cast<size_t>(position.y);
+  }
+  inline Vector2i position(size_t bit) const {
+    return Vector2i(static_cast<int>(bit / stride_),
+                    static_cast<int>(bit % stride_));
+  }
+  // Offsets of the bits of the neighbours of a position of row, which depend
+  // on the parity of the row. At the ends of a row they fall on the unused
+  // bits or past the ends of the grid.
+  inline const std::array<ptrdiff_t, 6>& neighbor_offsets(size_t row) const {
+    return neighbor_offsets_[row % 2];
+  }
+  inline bool contains(Vector2i position) const {
+    return position.x >= 0 && position.y >= 0 &&
+           static_cast<size_t>(position.x) < rows_ &&
+           static_cast<size_t>(position.y) < columns_;
+  }
+
+  // Number of steps to a neighbour between two positions, on a map without
+  // obstacles
+  static int Distance(Vector2i from, Vector2i to);
+
+  // Sets out to tiles and their neighbours
+  void Dilate(const Bitset& tiles, Bitset& out) const;
+
+  // Sets region to the tiles of area connected to start through area, by
+  // growing it by its neighbours until it doesn't change. scratch is only
+  // used as a buffer.
+  void Flood(const Bitset& area, size_t start, Bitset& region,
+             Bitset& scratch) const;
+
+ private:
+  size_t rows_ = 0;
+  size_t columns_ = 0;
+  size_t stride_ = 1;  // Bits of a row, one more than the columns
+  std::array<std::array<ptrdiff_t, 6>, 2> neighbor_offsets_ = {};
+  Bitset positions_;   // Every bit of a position of the grid
+  Bitset even_rows_;   // Positions of the even rows
+};
+
+// Finds the tiles a unit can move to in a state of the game, described tile
+// by tile to the generator (see AddTile). The rules are those of
+// Level::CanMoveUnit: a unit moves to a free tile of its region, or to a land
+// tile bordering its region that isn't its player's and whose defense is
+// below its attack.
+//
+// The region is found by flooding the tiles of the player from the unit, a
+// whole frontier at a time. The defense of the tiles isn't computed tile by
+// tile either: for every other player and strength, the tiles defended at
+// least that much are its tiles holding an entity that strong, dilated by one
+// tile within its tiles. So a query takes a few dozen operations on sets of
+// a few words for usual maps, whatever the number of tiles reached.
+//
+// A generator is reused from state to state (see Reset) without allocating
+// once its sets have grown, and follows a state changing a few tiles at a
+// time (see ReplaceTile). Not thread safe.
+class MoveGenerator {
+ public:
+  // Starts describing a state of a map laid out as grid, in which player
+  // moves. grid must outlive the queries.
+  void Reset(const HexGrid& grid, int player);
+
+  // Describes a land tile: its owner (-1 for none), whether a unit of its
+  // owner can stop on it, and the defense of its entity (see DefenseOf).
+  // Tiles not described are water.
+  inline void AddTile(size_t bit, int owner, bool free, int defense) {
+    land_.Set(bit);
+    if (owner < 0) return;
+    if (free) free_.Set(bit);
+
+    const auto id = static_cast<size_t>(owner);
+    Owner& tile_owner =
+        id < owner_indices_.size() && owner_indices_[id] != kNoOwner
+            ? owners_[owner_indices_[id]]
+            : AddOwner(owner);
+    tile_owner.tiles.Set(bit);
+    if (defense > 0) {
+      tile_owner.defenders[std::min(defense, kMaxStrength) - 1].Set(bit);
+    }
+  }
+
+  // Describes a tile already described again, after it changed: as if it
+  // was only described now, without describing the other tiles again
+  void ReplaceTile(size_t bit, int owner, bool free, int defense);
+
+  // Sets region to the tiles of the player connected to start, empty if
+  // start isn't one of them
+  void FindRegion(size_t start, Bitset& region);
+
+  // Sets reachable to the tiles a unit with attack in region can move to
+  void FindReachable(const Bitset& region, int attack, Bitset& reachable);
+
+  // FindRegion then FindReachable for the unit at start
+  Bitset Reachable(size_t start, int attack);
+
+ private:
+  static constexpr size_t kNoOwner = static_cast<size_t>(-1);
+
+  struct Owner {
+    int id = -1;
+    Bitset tiles;
+    // Tiles holding entities with a defense of i + 1
+    std::array<Bitset, kMaxStrength> defenders;
+  };
+
+  Owner& AddOwner(int id);
+  const Owner* FindOwner(int id) const;
+  // Tiles of other players with a defense of at least strength
+  const Bitset& Defended(int strength);
+
+  const HexGrid* grid_ = nullptr;
+  int player_ = -1;
+  Bitset land_;
+  Bitset free_;  // Land a unit of its owner can stop on
+  // The owners described since the last Reset come first, the others are
+  // kept for their memory
+  std::vector<Owner> owners_;
+  size_t owner_count_ = 0;
+  // Index in owners_ of the owner of every id, kNoOwner if not described
+  // since the last Reset
+  std::vector<size_t> owner_indices_;
+  // Defended(i + 1), once computed since the last Reset
+  std::array<Bitset, kMaxStrength> defended_;
+  std::array<bool, kMaxStrength> defended_ready_ = {};
+  Bitset border_;
+  Bitset defenders_;
+  Bitset scratch_;
+};
+
+}  // namespace konkr
+
+#endif  // KONKR_WORLD_MOVE_GENERATOR_H
@@ -0,0 +1,455 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+
+#include "world/path_finder.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace konkr {
+
+template <typename Visit>
+void PathFinder::ForEachNeighbor(size_t bit, const Bitset& tiles,
+                                 Visit&& visit) const {
+  struct Step {
+    int rows;
+    int columns;
+  };
+  // The columns of the rows above and below are those of an even row, an odd
+  // row is shifted by one (see Tile::GetNeighboringTilesGridPosition)
+  static constexpr Step kSteps[] = {{0, -1}, {0, 1},  {-1, -1},
+                                    {-1, 0}, {1, -1}, {1, 0}};
+  const auto row = static_cast<int>(bit / stride_);
+  const auto column = static_cast<int>(bit % stride_);
+  const int shift = row % 2;
+  const auto rows = static_cast<int>(grid_->rows());
+  const auto columns = static_cast<int>(grid_->columns());
+  for (const Step& step : kSteps) {
+    const int neighbor_row = row + step.rows;
+    const int neighbor_column =
+        column + step.columns + (step.rows != 0 ? shift : 0);
+    if (neighbor_row < 0 || neighbor_row >= rows || neighbor_column < 0 ||
+        neighbor_column >= columns) {
+      continue;
+    }
+    const size_t neighbor = neighbor_row * stride_ + neighbor_column;
+    if (tiles.Test(neighbor)) {
+      visit(neighbor, Vector2i(neighbor_row, neighbor_column));
+    }
+  }
+}
+
+void PathFinder::Reset(const HexGrid& grid) {
+  grid_ = &grid;
+  stride_ = grid.stride();
+  const size_t bit_count = grid.bit_count();
+  passable_.Assign(bit_count);
+
+  tile_states_.assign(bit_count, SearchState{});
+  search_ = 0;
+
+  cluster_rows_ = (grid.rows() + kClusterSize - 1) / kClusterSize;
+  cluster_columns_ = (grid.columns() + kClusterSize - 1) / kClusterSize;
+  clusters_.assign(cluster_rows_ * cluster_columns_, Cluster{});
+  components_.assign(bit_count, kNoComponent);
+  clusters_dirty_ = true;
+  corridor_.Assign(bit_count);
+
+  fields_.clear();
+}
+
+void PathFinder::SetPassable(Vector2i position, bool passable) {
+  if (!grid_ || !grid_->contains(position)) return;
+  const size_t bit = grid_->bit(position);
+  if (passable_.Test(bit) == passable) return;
+  if (passable) {
+    passable_.Set(bit);
+  } else {
+    passable_.Reset(bit);
+  }
+  clusters_[ClusterOf(bit)].dirty = true;
+  clusters_dirty_ = true;
+
+  // Only the fields that reached the tile, or a neighbour it now connects to,
+  // may change, or whose target it is
+  std::erase_if(fields_, [&](const Field& field) {
+    bool reached = field.target == bit || field.distances[bit] != kUnreachable;
+    ForEachNeighbor(bit, passable_, [&](size_t neighbor, Vector2i) {
+      reached |= field.distances[neighbor] != kUnreachable;
+    });
+    return reached;
+  });
+}
+
+bool PathFinder::FindPath(Vector2i start, Vector2i goal,
+                          std::vector<Vector2i>& path) {
+  path.clear();
+  if (!passable(start) || !passable(goal)) return false;
+  const size_t start_bit = grid_->bit(start);
+  const size_t goal_bit = grid_->bit(goal);
+  if (start_bit == goal_bit) {
+    path.push_back(start);
+    return true;
+  }
+
+  UpdateClusters();
+  const uint32_t start_part = PartOf(start_bit);
+  const uint32_t goal_part = PartOf(goal_bit);
+  if (areas_[start_part] != areas_[goal_part]) return false;
+  // The shortest path to a goal a few clusters away, which may leave the
+  // corridor, is found quickly anyway
+  if (start_part == goal_part ||
+      HexGrid::Distance(start, goal) <= 2 * kClusterSize) {
+    return Search(start_bit, goal_bit, nullptr, path);
+  }
+  SearchClusters(start_bit, goal_bit);
+  return Search(start_bit, goal_bit, &corridor_, path);
+}
+
+std::span<const int> PathFinder::DistancesTo(Vector2i target) {
+  if (!grid_ || !grid_->contains(target)) return {};
+  const size_t target_bit = grid_->bit(target);
+  ++field_uses_;
+  for (Field& field : fields_) {
+    if (field.target == target_bit) {
+      field.last_use = field_uses_;
+      return field.distances;
+    }
+  }
+
+  Field& field =
+      fields_.size() < kMaxFields
+          ? fields_.emplace_back()
+          : *std::min_element(fields_.begin(), fields_.end(),
+                              [](const Field& a, const Field& b) {
+                                return a.last_use < b.last_use;
+                              });
+  field.target = target_bit;
+  field.last_use = field_uses_;
+  field.distances.assign(grid_->bit_count(), kUnreachable);
+  if (!passable_.Test(target_bit)) return field.distances;
+
+  // Breadth first from the target, every step costing as much
+  field.distances[target_bit] = 0;
+  queue_.assign(1, target_bit);
+  for (size_t next = 0; next < queue_.size(); ++next) {
+    const size_t bit = queue_[next];
+    const int distance = field.distances[bit] + 1;
+    ForEachNeighbor(bit, passable_, [&](size_t neighbor, Vector2i) {
+      if (field.distances[neighbor] != kUnreachable) return;
+      field.distances[neighbor] = distance;
+      queue_.push_back(neighbor);
+    });
+  }
+  return field.distances;
+}
+
+std::optional<Vector2i> PathFinder::NextStep(Vector2i position,
+                                             Vector2i target) {
+  if (!passable(position)) return std::nullopt;
+  const std::span<const int> distances = DistancesTo(target);
+  if (distances.empty()) return std::nullopt;
+  const size_t bit = grid_->bit(position);
+  if (distances[bit] <= 0) return std::nullopt;
+
+  std::optional<Vector2i> step;
+  ForEachNeighbor(bit, passable_, [&](size_t neighbor, Vector2i) {
+    if (!step && distances[neighbor] == distances[bit] - 1) {
+      step = grid_->position(neighbor);
+    }
+  });
+  return step;
+}
+
+size_t PathFinder::ClusterOf(size_t bit) const {
+  const size_t row = bit / stride_;
+  const size_t column = bit % stride_;
+  return (row / kClusterSize) * cluster_columns_ + column / kClusterSize;
+}
+
+PathFinder::Bounds PathFinder::BoundsOf(size_t cluster) const {
+  const size_t first_row = (cluster / cluster_columns_) * kClusterSize;
+  const size_t first_column = (cluster % cluster_columns_) * kClusterSize;
+  return {first_row, std::min(first_row + kClusterSize, grid_->rows()),
+          first_column,
+          std::min(first_column + kClusterSize, grid_->columns())};
+}
+
+uint32_t PathFinder::PartOf(size_t bit) const {
+  return first_parts_[ClusterOf(bit)] + components_[bit];
+}
+
+bool PathFinder::Search(size_t start, size_t goal, const Bitset* area,
+                        std::vector<Vector2i>& path) {
+  if (++search_ > UINT32_MAX / 2 - 1) {
+    for (SearchState& state : tile_states_) state.stamp = 0;
+    search_ = 1;
+  }
+  const uint32_t reached = 2 * search_;
+  const uint32_t done = reached + 1;
+  const Vector2i goal_position = grid_->position(goal);
+  // The area is made of passable tiles
+  const Bitset& tiles = area ? *area : passable_;
+
+  // The estimates only grow along the search, from that of the start
+  const int first_estimate =
+      HexGrid::Distance(grid_->position(start), goal_position);
+  size_t bucket_count = 0;
+  auto open = [&](size_t bit, int estimate) {
+    const auto index = static_cast<size_t>(estimate - first_estimate);
+    if (index >= buckets_.size()) buckets_.resize(index + 1);
+    buckets_[index].push_back(static_cast<uint32_t>(bit));
+    bucket_count = std::max(bucket_count, index + 1);
+  };
+  tile_states_[start] = {reached, 0, static_cast<uint32_t>(start)};
+  open(start, first_estimate);
+
+  bool found = false;
+  for (size_t index = 0; index < bucket_count && !found; ++index) {
+    // Last in first out: the tiles opened last are the furthest from the
+    // start, so the search goes straight on among equally good paths
+    while (!buckets_[index].empty()) {
+      const uint32_t bit = buckets_[index].back();
+      buckets_[index].pop_back();
+      // The distance on an empty map never decreases by more than a step,
+      // so the first time a tile is taken it is by a shortest path
+      SearchState& state = tile_states_[bit];
+      if (state.stamp == done) continue;
+      state.stamp = done;
+      if (bit == goal) {
+        found = true;
+        break;
+      }
+
+      const int cost = state.cost + 1;
+      ForEachNeighbor(bit, tiles, [&](size_t neighbor, Vector2i position) {
+        SearchState& next = tile_states_[neighbor];
+        if (next.stamp == done ||
+            (next.stamp == reached && next.cost <= cost)) {
+          return;
+        }
+        next = {reached, cost, bit};
+        open(neighbor, cost + HexGrid::Distance(position, goal_position));
+      });
+    }
+  }
+  for (size_t index = 0; index < bucket_count; ++index) {
+    buckets_[index].clear();
+  }
+  if (!found) return false;
+
+  for (size_t bit = goal; bit != start; bit = tile_states_[bit].parent) {
+    path.push_back(grid_->position(bit));
+  }
+  path.push_back(grid_->position(start));
+  std::reverse(path.begin(), path.end());
+  return true;
+}
+
+void PathFinder::SearchClusters(size_t start, size_t goal) {
+  if (++part_search_ > UINT32_MAX / 2 - 1) {
+    for (SearchState& state : part_states_) state.stamp = 0;
+    part_search_ = 1;
+  }
+  const uint32_t reached = 2 * part_search_;
+  const uint32_t done = reached + 1;
+  const uint32_t start_part = PartOf(start);
+  const uint32_t goal_part = PartOf(goal);
+  const Vector2i goal_position = grid_->position(goal);
+  part_states_[start_part] = {reached, 0, start_part};
+  open_parts_.clear();
+  open_parts_.push_back({0, 0, start_part});
+  while (!open_parts_.empty()) {
+    std::pop_heap(open_parts_.begin(), open_parts_.end());
+    const OpenPart open = open_parts_.back();
+    open_parts_.pop_back();
+    SearchState& state = part_states_[open.part];
+    if (state.stamp == done || open.cost > state.cost) continue;
+    state.stamp = done;
+    if (open.part == goal_part) break;
+
+    const size_t cluster = part_clusters_[open.part];
+    const uint32_t component = open.part - first_parts_[cluster];
+    const Vector2i position = part_positions_[open.part];
+    for (const Link& link : clusters_[cluster].links) {
+      if (link.component != component) continue;
+      const uint32_t part =
+          first_parts_[link.neighbor_cluster] + link.neighbor_component;
+      const Vector2i neighbor_position = part_positions_[part];
+      const int cost =
+          open.cost +
+          std::max(1, HexGrid::Distance(position, neighbor_position));
+      SearchState& next = part_states_[part];
+      if (next.stamp == done || (next.stamp == reached && next.cost <= cost)) {
+        continue;
+      }
+      next = {reached, cost, open.part};
+      open_parts_.push_back(
+          {cost + HexGrid::Distance(neighbor_position, goal_position), cost,
+           part});
+      std::push_heap(open_parts_.begin(), open_parts_.end());
+    }
+  }
+
+  // Both parts are in the same area, so the goal was reached
+  corridor_.Clear();
+  for (uint32_t part = goal_part;; part = part_states_[part].parent) {
+    const size_t cluster = part_clusters_[part];
+    const auto component =
+        static_cast<uint16_t>(part - first_parts_[cluster]);
+    const auto [first_row, last_row, first_column, last_column] =
+        BoundsOf(cluster);
+    for (size_t row = first_row; row < last_row; ++row) {
+      for (size_t column = first_column; column < last_column; ++column) {
+        const size_t bit = row * stride_ + column;
+        if (components_[bit] == component) corridor_.Set(bit);
+      }
+    }
+    if (part == start_part) break;
+  }
+}
+
+void PathFinder::UpdateClusters() {
+  if (!clusters_dirty_) return;
+  for (size_t cluster = 0; cluster < clusters_.size(); ++cluster) {
+    if (!clusters_[cluster].dirty) continue;
+    FindComponents(cluster);
+    // The parts of the clusters around may touch other parts now
+    const size_t row = cluster / cluster_columns_;
+    const size_t column = cluster % cluster_columns_;
+    for (size_t r = row > 0 ? row - 1 : 0;
+         r <= std::min(row + 1, cluster_rows_ - 1); ++r) {
+      for (size_t c = column > 0 ? column - 1 : 0;
+           c <= std::min(column + 1, cluster_columns_ - 1); ++c) {
+        clusters_[r * cluster_columns_ + c].links_dirty = true;
+      }
+    }
+  }
+  for (size_t cluster = 0; cluster < clusters_.size(); ++cluster) {
+    if (clusters_[cluster].links_dirty) FindLinks(cluster);
+  }
+  FindAreas();
+  clusters_dirty_ = false;
+}
+
+void PathFinder::FindAreas() {
+  first_parts_.resize(clusters_.size());
+  part_clusters_.clear();
+  part_positions_.clear();
+  for (size_t cluster = 0; cluster < clusters_.size(); ++cluster) {
+    first_parts_[cluster] = static_cast<uint32_t>(part_clusters_.size());
+    for (const size_t representative : clusters_[cluster].representatives) {
+      part_clusters_.push_back(static_cast<uint32_t>(cluster));
+      part_positions_.push_back(grid_->position(representative));
+    }
+  }
+  const size_t part_count = part_clusters_.size();
+  part_states_.assign(part_count, SearchState{});
+  part_search_ = 0;
+
+  // Union-find over the links, each area ending up as its smallest part
+  areas_.resize(part_count);
+  std::iota(areas_.begin(), areas_.end(), 0);
+  auto find = [&](uint32_t part) {
+    while (areas_[part] != part) {
+      areas_[part] = areas_[areas_[part]];
+      part = areas_[part];
+    }
+    return part;
+  };
+  for (size_t cluster = 0; cluster < clusters_.size(); ++cluster) {
+    for (const Link& link : clusters_[cluster].links) {
+      const uint32_t a = find(first_parts_[cluster] + link.component);
+      const uint32_t b =
+          find(first_parts_[link.neighbor_cluster] + link.neighbor_component);
+      if (a != b) areas_[std::max(a, b)] = std::min(a, b);
+    }
+  }
+  for (uint32_t part = 0; part < part_count; ++part) {
+    areas_[part] = find(part);
+  }
+}
+
+void PathFinder::FindComponents(size_t cluster) {
+  Cluster& parts = clusters_[cluster];
+  parts.dirty = false;
+  parts.representatives.clear();
+  const auto [first_row, last_row, first_column, last_column] =
+      BoundsOf(cluster);
+  for (size_t row = first_row; row < last_row; ++row) {
+    for (size_t column = first_column; column < last_column; ++column) {
+      components_[row * stride_ + column] = kNoComponent;
+    }
+  }
+  const Vector2i center(static_cast<int>(first_row + last_row) / 2,
+                        static_cast<int>(first_column + last_column) / 2);
+
+  for (size_t row = first_row; row < last_row; ++row) {
+    for (size_t column = first_column; column < last_column; ++column) {
+      const size_t start = row * stride_ + column;
+      if (!passable_.Test(start) || components_[start] != kNoComponent) {
+        continue;
+      }
+      const auto component =
+          static_cast<uint16_t>(parts.representatives.size());
+      // The part is represented by its tile the closest to the center, for
+      // the distances between parts to be close to those between tiles
+      size_t representative = start;
+      int representative_distance =
+          HexGrid::Distance(grid_->position(start), center);
+      components_[start] = component;
+      queue_.assign(1, start);
+      while (!queue_.empty()) {
+        const size_t bit = queue_.back();
+        queue_.pop_back();
+        ForEachNeighbor(bit, passable_, [&](size_t neighbor,
+                                            Vector2i position) {
+          if (components_[neighbor] != kNoComponent ||
+              ClusterOf(neighbor) != cluster) {
+            return;
+          }
+          components_[neighbor] = component;
+          queue_.push_back(neighbor);
+          const int distance = HexGrid::Distance(position, center);
+          if (distance < representative_distance) {
+            representative = neighbor;
+            representative_distance = distance;
+          }
+        });
+      }
+      parts.representatives.push_back(representative);
+    }
+  }
+}
+
+void PathFinder::FindLinks(size_t cluster) {
+  Cluster& parts = clusters_[cluster];
+  parts.links_dirty = false;
+  parts.links.clear();
+  const auto [first_row, last_row, first_column, last_column] =
+      BoundsOf(cluster);
+  for (size_t row = first_row; row < last_row; ++row) {
+    const bool edge_row = row == first_row || row + 1 == last_row;
+    for (size_t column = first_column; column < last_column; ++column) {
+      // Only the tiles on the edges of the cluster touch other clusters
+      if (!edge_row && column != first_column && column + 1 != last_column) {
+        continue;
+      }
+      const size_t bit = row * stride_ + column;
+      if (!passable_.Test(bit)) continue;
+      ForEachNeighbor(bit, passable_, [&](size_t neighbor, Vector2i) {
+        const size_t neighbor_cluster = ClusterOf(neighbor);
+        if (neighbor_cluster == cluster) return;
+        parts.links.push_back({components_[bit],
+                               static_cast<uint32_t>(neighbor_cluster),
+                               components_[neighbor]});
+      });
+    }
+  }
+  std::sort(parts.links.begin(), parts.links.end());
+  parts.links.erase(std::unique(parts.links.begin(), parts.links.end()),
+                    parts.links.end());
+}
+
+}  // namespace konkr
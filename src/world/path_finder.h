@@ -0,0 +1,198 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+//
+// path_finder.h
+//
+// Declares the PathFinder class, which finds shortest paths between the
+// tiles of a map, and distance fields towards a tile.
+//
+
+#ifndef KONKR_WORLD_PATH_FINDER_H
+#define KONKR_WORLD_PATH_FINDER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "core/bitset.h"
+#include "rendering/graphics.h"
+#include "world/move_generator.h"
+
+namespace konkr {
+
+// Finds paths through the tiles of a map laid out as a HexGrid, a step being
+// a move to a neighbouring tile (see Tile::GetNeighboringTilesGridPosition).
+// Which tiles can be walked through is up to the caller (see SetPassable):
+// the land, the tiles of a player, the tiles without a building...
+//
+// Short paths are searched with A*, guided by the distance on an empty map
+// (see HexGrid::Distance).
+// Long paths are first searched between blocks of kClusterSize x
+// kClusterSize tiles: the tiles of a block are split into the parts connected
+// within it, and two parts are linked when they touch. A* then only searches
+// the tiles of the parts on that path, so a query on a large map doesn't
+// search most of it. Such paths are close to the shortest, not always the
+// shortest. The linked parts also tell at once that a goal can't be reached,
+// which A* would only find out after searching every tile it can.
+//
+// For the many paths to one tile, such as every unit walking to the same
+// goal, DistancesTo finds the distance of every tile to it once, and keeps it
+// until a tile it reached, or next to one, changes.
+//
+// The blocks are only split again where tiles changed, when a long path is
+// searched after the changes. Not thread safe.
+class PathFinder {
+ public:
+  // Side of the blocks of tiles searched for long paths
+  static constexpr int kClusterSize = 16;
+  // Distance fields kept at once, the least recently used one is dropped
+  static constexpr size_t kMaxFields = 4;
+  // Distance of the tiles a distance field doesn't reach
+  static constexpr int kUnreachable = -1;
+
+  // Starts over on grid, no tile being passable. grid must outlive the
+  // queries.
+  void Reset(const HexGrid& grid);
+
+  // Sets whether paths can go through the tile at position
+  void SetPassable(Vector2i position, bool passable);
+  inline bool passable(Vector2i position) const {
+    return grid_ && grid_->contains(position) &&
+           passable_.Test(grid_->bit(position));
+  }
+
+  // Sets path to the steps from start to goal through passable tiles, both
+  // included. Returns false, and clears path, if there is none.
+  bool FindPath(Vector2i start, Vector2i goal, std::vector<Vector2i>& path);
+
+  // Number of steps from every tile of the grid to target, indexed by the
+  // bits of the grid, kUnreachable for the tiles without a path to it. Valid
+  // until the next call changing the tiles or the fields.
+  std::span<const int> DistancesTo(Vector2i target);
+
+  // Neighbour of position on a shortest path to target, none if target
+  // can't be reached from position or is position
+  std::optional<Vector2i> NextStep(Vector2i position, Vector2i target);
+
+ private:
+  static constexpr uint16_t kNoComponent = UINT16_MAX;
+
+  // A part of a cluster touching a part of another cluster
+  struct Link {
+    uint16_t component;
+    uint32_t neighbor_cluster;
+    uint16_t neighbor_component;
+
+    auto operator<=>(const Link& other) const = default;
+  };
+
+  // Rows and columns of the tiles of a cluster, the last ones excluded
+  struct Bounds {
+    size_t first_row;
+    size_t last_row;
+    size_t first_column;
+    size_t last_column;
+  };
+
+  struct Cluster {
+    bool dirty = true;  // Its parts must be found again
+    bool links_dirty = true;
+    // The tile of each part of the cluster the closest to its center
+    std::vector<size_t> representatives;
+    std::vector<Link> links;
+  };
+
+  // A tile or a part reached by the search numbered n if its stamp is 2 * n,
+  // and done if it is one more, so nothing is cleared between searches
+  struct SearchState {
+    uint32_t stamp = 0;
+    int cost = 0;
+    uint32_t parent = 0;
+  };
+
+  // A part of a cluster to search from, in the order of estimate, then of
+  // cost from the start the largest first
+  struct OpenPart {
+    int estimate;
+    int cost;
+    uint32_t part;
+
+    bool operator<(const OpenPart& other) const {
+      return estimate > other.estimate ||
+             (estimate == other.estimate && cost < other.cost);
+    }
+  };
+
+  struct Field {
+    size_t target = 0;
+    std::vector<int> distances;
+    uint64_t last_use = 0;
+  };
+
+  // Calls visit with the bit and the position of each neighbour of bit in
+  // tiles
+  template <typename Visit>
+  void ForEachNeighbor(size_t bit, const Bitset& tiles, Visit&& visit) const;
+  size_t ClusterOf(size_t bit) const;
+  Bounds BoundsOf(size_t cluster) const;
+  // Number of the part of a passable tile, once the clusters are up to date
+  uint32_t PartOf(size_t bit) const;
+
+  // A* from start to goal, through the tiles of area if any
+  bool Search(size_t start, size_t goal, const Bitset* area,
+              std::vector<Vector2i>& path);
+  // Sets corridor_ to the tiles of the parts on a path between the clusters
+  // of start and goal, which must be in the same area
+  void SearchClusters(size_t start, size_t goal);
+
+  // Splits the clusters that changed into parts, then links them again and
+  // finds the areas
+  void UpdateClusters();
+  void FindAreas();
+  void FindComponents(size_t cluster);
+  void FindLinks(size_t cluster);
+
+  const HexGrid* grid_ = nullptr;
+  size_t stride_ = 1;
+  Bitset passable_;
+
+  // Scratch of Search, indexed by bits
+  std::vector<SearchState> tile_states_;
+  uint32_t search_ = 0;
+  // Tiles opened by Search, by estimate above the first one: every step
+  // costs as much, so they are taken from buckets rather than a heap
+  std::vector<std::vector<uint32_t>> buckets_;
+
+  size_t cluster_rows_ = 0;
+  size_t cluster_columns_ = 0;
+  std::vector<Cluster> clusters_;
+  // Part of its cluster of every tile, kNoComponent if it isn't passable
+  std::vector<uint16_t> components_;
+  bool clusters_dirty_ = true;
+  Bitset corridor_;
+
+  // The parts of every cluster are numbered one cluster after the other,
+  // from the first part of each cluster
+  std::vector<uint32_t> first_parts_;
+  std::vector<uint32_t> part_clusters_;
+  // Position of the representative of every part
+  std::vector<Vector2i> part_positions_;
+  // Parts linked through other parts share an area, so two tiles are
+  // connected if and only if their parts are in the same area
+  std::vector<uint32_t> areas_;
+  // Scratch of SearchClusters, indexed by parts
+  std::vector<SearchState> part_states_;
+  uint32_t part_search_ = 0;
+  std::vector<OpenPart> open_parts_;
+
+  std::vector<Field> fields_;
+  uint64_t field_uses_ = 0;
+  std::vector<size_t> queue_;
+};
+
+}  // namespace konkr
+
+#endif  // KONKR_WORLD_PATH_FINDER_H
@@ -10,25 +10,27 @@
 #define KONKR_GAME_LOGIC_PLAYER_H
 
 #include <string>
+#include <utility>
 
+#include "core/random.h"
 #include "world/townhall.h"
 
 namespace konkr {
 
 // Generates a random warrior name using a combination of prefixes, stems, and
 // suffixes. The idea is to have a funny name (with some easter eggs).
-std::string GenerateWarriorName();
+std::string GenerateWarriorName(RandomStream& random);
 
 /**
   @class Represents a player of the game.
 */
 class Player {
  public:
-  Player(int id) : id_(id) { name_ = GenerateWarriorName(); }
+  Player(int id, std::string name) : id_(id), name_(std::move(name)) {}
 
   inline std::string name() const { return name_; }
   inline int id() const { return id_; }
-  inline const std::vector<std::shared_ptr<Townhall>>& townhalls() {
+  inline const std::vector<std::shared_ptr<Townhall>>& townhalls() const {
     return townhalls_;
   }
 
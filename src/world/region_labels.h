@@ -0,0 +1,95 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+//
+// region_labels.h
+//
+// Declares the RegionLabels class, which finds the regions of a map: the
+// connected land tiles of the same owner.
+//
+
+#ifndef KONKR_WORLD_REGION_LABELS_H
+#define KONKR_WORLD_REGION_LABELS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "world/move_generator.h"
+
+namespace konkr {
+
+// Labels the regions of a map in a single pass: each start tile (e.g. the
+// buildings) not labelled yet starts a flood fill over
+// HexGrid::neighbor_offsets, which labels its whole region, so every tile is
+// visited at most once whatever the number of start tiles in a region. The
+// tiles of each region are kept together, so the tiles of a region are read
+// without searching it again.
+//
+// The map is read from a board, indexed by the bits of its grid:
+//   const HexGrid& grid() const;
+//   bool is_land(size_t bit) const;
+//   int owner(size_t bit) const;  // -1 for none
+// The buffers are kept from one labelling to the next.
+class RegionLabels {
+ public:
+  static constexpr int32_t kNoRegion = -1;
+
+  // Labels the regions of the tiles at the bits starts
+  template <typename Board>
+  void Label(const Board& board, std::span<const size_t> starts);
+
+  // Region of the tile at bit, kNoRegion for the tiles of no region labelled
+  inline int32_t region(size_t bit) const { return regions_[bit]; }
+  inline size_t region_count() const { return begins_.size() - 1; }
+  // Bits of the tiles of region, the first one starting the fill
+  inline std::span<const size_t> tiles(int32_t region) const {
+    return std::span<const size_t>(tiles_).subspan(
+        begins_[region], begins_[region + 1] - begins_[region]);
+  }
+
+ private:
+  std::vector<int32_t> regions_;
+  // The tiles of region r are at [begins_[r], begins_[r + 1])
+  std::vector<size_t> tiles_;
+  std::vector<size_t> begins_ = {0};
+};
+
+template <typename Board>
+void RegionLabels::Label(const Board& board, std::span<const size_t> starts) {
+  const HexGrid& grid = board.grid();
+  const auto bit_count = static_cast<ptrdiff_t>(grid.bit_count());
+  regions_.assign(grid.bit_count(), kNoRegion);
+  tiles_.clear();
+  begins_.assign(1, 0);
+  for (const size_t start : starts) {
+    if (regions_[start] != kNoRegion || !board.is_land(start)) continue;
+    const int owner = board.owner(start);
+    if (owner < 0) continue;
+
+    // The tiles of the region double as the queue of the fill
+    const auto region = static_cast<int32_t>(region_count());
+    regions_[start] = region;
+    tiles_.push_back(start);
+    for (size_t i = begins_.back(); i < tiles_.size(); ++i) {
+      const size_t tile = tiles_[i];
+      for (const ptrdiff_t offset :
+           grid.neighbor_offsets(tile / grid.stride())) {
+        const ptrdiff_t neighbor = static_cast<ptrdiff_t>(tile) + offset;
+        if (neighbor < 0 || neighbor >= bit_count ||
+            regions_[neighbor] != kNoRegion || !board.is_land(neighbor) ||
+            board.owner(neighbor) != owner) {
+          continue;
+        }
+        regions_[neighbor] = region;
+        tiles_.push_back(neighbor);
+      }
+    }
+    begins_.push_back(tiles_.size());
+  }
+}
+
+}  // namespace konkr
+
+#endif  // KONKR_WORLD_REGION_LABELS_H
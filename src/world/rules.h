@@ -0,0 +1,70 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+//
+// rules.h
+//
+// Declares the number of players, the strength of the entities in combat and
+// the prices of what a player buys, shared by the Level and by the compact
+// copies of the game searched by the computer opponents.
+//
+
+#ifndef KONKR_WORLD_RULES_H
+#define KONKR_WORLD_RULES_H
+
+#include <cstddef>
+
+#include "world/entity.h"
+
+namespace konkr {
+
+// Players have ids below it, a digit in the level files. The arrays of the
+// players, such as the incomes of Economy, are indexed by their ids.
+constexpr size_t kMaxPlayers = 10;
+
+// A unit captures a tile not owned by its player if its attack is greater
+// than the defense of the tile: the strongest defense given to it by the
+// entities on it and on its neighbours of the same owner.
+
+// Defense an entity gives to its tile and to the neighbouring tiles of the
+// same owner
+constexpr int DefenseOf(Entity::EntityType type, int level) {
+  switch (type) {
+    case Entity::EntityType::HumanUnit:
+      return level + 1;
+    case Entity::EntityType::Townhall:
+      return 1;
+    case Entity::EntityType::Castle:
+      return 2;
+    default:
+      return 0;
+  }
+}
+
+// Attack of a unit: a villager (level 0) only captures undefended tiles, a
+// hero (level 3) captures anything but another hero's surroundings
+constexpr int AttackOf(Entity::EntityType type, int level) {
+  return type == Entity::EntityType::HumanUnit ? level + 1 : 0;
+}
+
+// Level of a hero, the strongest unit: two units of the same level below it
+// merge into a unit of the next level
+constexpr int kMaxUnitLevel = 3;
+
+// Strongest attack and defense, those of a hero
+constexpr int kMaxStrength =
+    AttackOf(Entity::EntityType::HumanUnit, kMaxUnitLevel);
+
+// Paid by a townhall of the region where a villager or a castle is placed
+constexpr int kUnitPrice = 10;
+constexpr int kCastlePrice = 20;
+
+// Whether a unit can move to a tile of its player holding an entity of type:
+// only empty sand, whose entity is a placeholder, is free
+constexpr bool IsFreeEntity(Entity::EntityType type) {
+  return type == Entity::EntityType::Unknown;
+}
+
+}  // namespace konkr
+
+#endif  // KONKR_WORLD_RULES_H
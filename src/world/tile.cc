@@ -4,17 +4,11 @@
 
 #include "world/tile.h"
 
-#include <SFML/Graphics/Font.hpp>
-#include <SFML/Graphics/Text.hpp>
-#include <iostream>
 #include <memory>
 #include <optional>
 #include <string>
 
-#include "rendering/color_palette.h"
 #include "rendering/graphics.h"
-#include "rendering/level_renderer.h"
-#include "rendering/sprite_sheet.h"
 
 namespace konkr {
 
@@ -64,86 +58,27 @@ std::vector<Vector2i> Tile::GetNeighboringTilesGridPosition() const {
   return neighbors;
 }
 
-void Tile::Render(RenderTarget& target, Vector2f position, float radius,
-                  const SpriteSheet& sprite_sheet) {
-  CircleShape tile(radius, 6);
-  tile.set_origin({radius, radius});
-  tile.set_position(position);
-
-  if (type_ == TileType::Sand) {
-    Color base = ColorPalette::SandColorForPlayer(player_id_);
-    if (is_orphan_) {
-      base = Color(std::max(0, base.r() - 60), std::max(0, base.g() - 60),
-                   std::max(0, base.b() - 60));
-    }
-    tile.set_fill_color(base);
-  } else if (type_ == TileType::Water) {
-    tile.set_fill_color(ColorPalette::OceanBlue);
-  } else if (type_ == TileType::Forest) {
-    tile.set_fill_color(Color(60, 120, 60));
-  }
-  target.draw(tile);
-
-  if (entity_) {
-    if (entity_->type() != Entity::EntityType::Unknown) {
-      std::optional<std::string> sprite_name =
-          sprite_sheet.GetSpriteNameForEntity(entity_->type(),
-                                              entity_->level());
-      if (sprite_name) {
-        auto info = sprite_sheet.GetSpriteInfo(*sprite_name);
-        if (info) {
-          auto sprite =
-              Graphics::CreateSprite(sprite_sheet.GetTexture(), info->rect);
-          // Sets origin to center of the sprite
-          if (sprite) {
-            sprite->set_origin(
-                {info->rect.size.x / 2.f, info->rect.size.y / 2.f});
-            sprite->set_position(position);
-            target.draw(*sprite);
-          }
-        } else {
-          std::cerr << "Failed to get sprite info for entity: " << *sprite_name
-                    << std::endl;
-        }
-      } else {
-        std::cerr << "Failed to get sprite name for entity: "
-                  << Entity::entity_type_to_string(entity_->type())
-                  << std::endl;
-      }
-    }
-  }
-
-  // --- Draw "D" if level_ == 1 ---
-  if (level() == 1) {
-    const Font& font = LevelRenderer::get_font();
-    Text text(font, "D", 16);
-    text.set_fill_color(Color::Yellow);
-    text.set_outline_color(Color::Black);
-    text.set_outline_thickness(2);
-
-    FloatRect bounds = text.get_local_bounds();
-    text.set_origin({bounds.size.x / 2, bounds.size.y / 2});
-    text.set_position({position.x, position.y - radius / 2});
-    target.draw(text);
-  }
-
-  // --- Draw "R" if is_reachable_ ---
-  if (is_reachable()) {
-    const Font& font = LevelRenderer::get_font();
-    Text text(font, "R", 16);
-    text.set_fill_color(Color::Yellow);
-    text.set_outline_color(Color::Black);
-    text.set_outline_thickness(2);
-
-    FloatRect bounds = text.get_local_bounds();
-    text.set_origin({bounds.size.x / 2, bounds.size.y / 2});
-    text.set_position({position.x, position.y - radius / 2});
-    target.draw(text);
+Vector2i Tile::GetNeighborGridPosition(Vector2i grid_position,
+                                       WallPosition wall_position) {
+  const int x = grid_position.x;
+  const int y = grid_position.y;
+  // The rows above and below an odd row start half a tile to its left
+  const int shift = x % 2 != 0 ? 1 : 0;
+  switch (wall_position) {
+    case WallPosition::TopRight:
+      return {x - 1, y + shift};
+    case WallPosition::Right:
+      return {x, y + 1};
+    case WallPosition::BottomRight:
+      return {x + 1, y + shift};
+    case WallPosition::BottomLeft:
+      return {x + 1, y - 1 + shift};
+    case WallPosition::Left:
+      return {x, y - 1};
+    case WallPosition::TopLeft:
+      return {x - 1, y - 1 + shift};
   }
-
-  bounds_ = std::make_unique<FloatRect>(
-      Position(tile.get_global_bounds().pos.x, tile.get_global_bounds().pos.y),
-      Size(tile.get_global_bounds().size.x, tile.get_global_bounds().size.y));
+  return grid_position;
 }
 
 }  // namespace konkr
\ No newline at end of file
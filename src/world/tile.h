@@ -10,12 +10,14 @@
 #define KONKR_WORLD_TILE_H
 
 #include <array>
+#include <cstdint>
 #include <memory>
 #include <optional>
+#include <vector>
 
 #include "rendering/graphics.h"
-#include "rendering/sprite_sheet.h"
 #include "world/entity.h"
+#include "world/tile_observer.h"
 
 namespace konkr {
 
@@ -32,7 +34,7 @@ enum class WallPosition {
 
 // Sand tile is the tile the game is played on.
 // The other tiles are just for decoration.
-enum class TileType { Water, Forest, Sand };
+enum class TileType : uint8_t { Water, Forest, Sand };
 
 /**
   @class A tile is an hexagon representing a location that can contain an entity
@@ -59,32 +61,67 @@ class Tile {
   Tile(TileType type, std::optional<int> player_id)
       : type_(type), player_id_(player_id) {}
 
-  inline void change_owner(int player_id) { player_id_ = player_id; }
-
-  inline std::optional<int> get_owner() { return player_id_; }
+  inline void change_owner(int player_id) {
+    Notify(TileField::Owner, player_id_.value_or(-1), player_id);
+    player_id_ = player_id;
+  }
 
-  inline std::shared_ptr<FloatRect> get_bounds() {
-    return std::make_shared<FloatRect>(bounds_->pos, bounds_->size);
+  inline void remove_owner() {
+    Notify(TileField::Owner, player_id_.value_or(-1), -1);
+    player_id_ = std::nullopt;
   }
 
+  inline std::optional<int> get_owner() const { return player_id_; }
+
   inline int level() const { return level_; }
 
-  inline void set_level(int level) { level_ = level; }
+  inline void set_level(int level) {
+    Notify(TileField::Level, level_, level);
+    level_ = level;
+  }
 
-  inline void orphan() { is_orphan_ = true; }
+  inline void orphan() {
+    Notify(TileField::Orphan, is_orphan_, true);
+    is_orphan_ = true;
+  }
 
   inline bool is_orphan() const { return is_orphan_; }
 
-  inline bool is_reachable() { return is_reachable_; }
+  inline bool is_reachable() const { return is_reachable_; }
 
-  inline void claim() { is_orphan_ = false; }
+  inline void claim() {
+    Notify(TileField::Orphan, is_orphan_, false);
+    is_orphan_ = false;
+  }
 
   inline void add_wall(WallPosition wall_position) {
+    const int walls = walls_mask();
     walls_[static_cast<int>(wall_position)] = true;
+    Notify(TileField::Walls, walls, walls_mask());
   }
 
   inline void remove_wall(WallPosition wall_position) {
+    const int walls = walls_mask();
     walls_[static_cast<int>(wall_position)] = false;
+    Notify(TileField::Walls, walls, walls_mask());
+  }
+
+  // Sets every wall at once, one bit per WallPosition
+  inline void set_walls_mask(int mask) {
+    const int walls = walls_mask();
+    for (int i = 0; i < 6; ++i) {
+      walls_[i] = mask & (1 << i);
+    }
+    Notify(TileField::Walls, walls, walls_mask());
+  }
+
+  // One bit per WallPosition
+  inline int walls_mask() const {
+    int mask = 0;
+    for (int i = 0; i < 6; ++i) {
+      if (walls_[i]) mask |= 1 << i;
+    }
+    return mask;
   }
 
   inline bool has_wall(WallPosition wall_position) const {
@@ -106,24 +143,52 @@ class Tile {
     grid_position_ = grid_position;
   };
 
-  inline void set_reachability(bool reachable) { is_reachable_ = reachable; }
+  inline void set_reachability(bool reachable) {
+    Notify(TileField::Reachable, is_reachable_, reachable);
+    is_reachable_ = reachable;
+  }
 
   inline const Vector2i& grid_position() const { return grid_position_; }
 
-  inline void set_entity(std::unique_ptr<Entity> entity) {
+  inline void set_entity(std::shared_ptr<Entity> entity) {
+    std::shared_ptr<Entity> old_entity = std::move(entity_);
     entity_ = std::move(entity);
+    if (old_entity == entity_) return;
+    if (old_entity) old_entity->set_observer(nullptr);
+    if (entity_) {
+      entity_->set_grid_position(grid_position_);
+      entity_->set_observer(observer_);
+    }
+    if (observer_) {
+      observer_->OnEntityChanged(grid_position_, old_entity, entity_);
+    }
   }
   inline const std::shared_ptr<Entity>& entity() const { return entity_; }
 
+  // Notifies observer of the changes of the tile and of its entities, nullptr
+  // to stop
+  inline void set_observer(TileObserver* observer) {
+    observer_ = observer;
+    if (entity_) entity_->set_observer(observer);
+  }
+
   std::vector<Vector2i> GetNeighboringTilesGridPosition() const;
 
-  void Render(RenderTarget& target, Vector2f position, float radius,
-              const SpriteSheet& sprite_sheet);
+  // Grid position of the tile on the other side of a wall of the tile at
+  // grid_position, which may be out of the grid. Odd rows are drawn half a
+  // tile to the right.
+  static Vector2i GetNeighborGridPosition(Vector2i grid_position,
+                                          WallPosition wall_position);
 
  private:
+  inline void Notify(TileField field, int old_value, int new_value) {
+    if (observer_ && old_value != new_value) {
+      observer_->OnTileChanged(grid_position_, field, old_value, new_value);
+    }
+  }
+
   std::shared_ptr<Entity> entity_ = nullptr;
-  std::unique_ptr<FloatRect> bounds_ =
-      nullptr;  // Bounds of the object being rendered on the window
+  TileObserver* observer_ = nullptr;
   TileType type_;
   std::array<bool, 6> walls_ = {false};
   std::optional<int> player_id_;
@@ -0,0 +1,79 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+//
+// tile_observer.h
+//
+// Declares the TileObserver interface, notified of every change made to a
+// tile or to the entity on it, and the TileObserverList class.
+//
+
+#ifndef KONKR_WORLD_TILE_OBSERVER_H
+#define KONKR_WORLD_TILE_OBSERVER_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "rendering/graphics.h"
+
+namespace konkr {
+
+class Entity;
+
+// The fields of a tile, and of its entity, that change during a game
+enum class TileField : uint8_t {
+  Owner,      // Player id, -1 for none
+  Orphan,     // 0 or 1
+  Reachable,  // 0 or 1
+  Level,
+  Walls,  // One bit per WallPosition
+  EntityLevel,
+  EntityUpkeep,
+  Money,  // Of a townhall
+  Moved,  // 0 or 1, whether the unit moved during the turn
+};
+
+// Receives the changes of the tiles it observes (see Tile::set_observer),
+// made through their setters or the setters of their entities. Changes that
+// leave a value as it was aren't notified.
+class TileObserver {
+ public:
+  virtual ~TileObserver() = default;
+
+  virtual void OnTileChanged(Vector2i position, TileField field,
+                             int old_value, int new_value) = 0;
+
+  // The entity of the tile at position was replaced
+  virtual void OnEntityChanged(Vector2i position,
+                               const std::shared_ptr<Entity>& old_entity,
+                               const std::shared_ptr<Entity>& new_entity) = 0;
+};
+
+// Forwards the changes to several observers, in the order they were added
+class TileObserverList : public TileObserver {
+ public:
+  inline void Add(TileObserver* observer) { observers_.push_back(observer); }
+
+  void OnTileChanged(Vector2i position, TileField field, int old_value,
+                     int new_value) override {
+    for (TileObserver* observer : observers_) {
+      observer->OnTileChanged(position, field, old_value, new_value);
+    }
+  }
+
+  void OnEntityChanged(Vector2i position,
+                       const std::shared_ptr<Entity>& old_entity,
+                       const std::shared_ptr<Entity>& new_entity) override {
+    for (TileObserver* observer : observers_) {
+      observer->OnEntityChanged(position, old_entity, new_entity);
+    }
+  }
+
+ private:
+  std::vector<TileObserver*> observers_;
+};
+
+}  // namespace konkr
+
+#endif  // KONKR_WORLD_TILE_OBSERVER_H
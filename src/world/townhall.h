@@ -28,6 +28,7 @@ class Townhall : public Building {
 
   inline int money() const { return money_; }
   inline void set_money(int money) {
+    Notify(TileField::Money, money_, money);
     money_ = money;
     if (money >= 10 * level()) {
       IncreaseLevel();
@@ -36,6 +37,12 @@ class Townhall : public Building {
     }
   }
 
+  // Sets the money without changing the level, to restore a saved state
+  inline void restore_money(int money) {
+    Notify(TileField::Money, money_, money);
+    money_ = money;
+  }
+
  private:
   int money_ = 10;
 };
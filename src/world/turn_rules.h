@@ -0,0 +1,120 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+//
+// turn_rules.h
+//
+// Declares the TurnRules class, the rules of the end of a turn, shared by the
+// Level and by the compact copies of the game searched by the computer
+// opponents.
+//
+
+#ifndef KONKR_WORLD_TURN_RULES_H
+#define KONKR_WORLD_TURN_RULES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "core/random.h"
+#include "world/bandit_system.h"
+#include "world/entity.h"
+#include "world/region_labels.h"
+
+namespace konkr {
+
+// A turn ends with, in this order:
+//  1. UpdateUpkeeps: the upkeep of every townhall becomes the income of its
+//     region, the sum of the upkeep of the entities of the region, other
+//     townhalls excepted, whose upkeep is their own income;
+//  2. CollectIncome: the townhalls of the player whose turn ends add their
+//     upkeep to their money, and the units of the region of a townhall whose
+//     money goes below 0 turn into bandits;
+//  3. the players owning no tile leave the game;
+//  4. MoveBandits: every bandit moves to a random free tile next to it, of
+//     the same owner (see BanditSystem).
+// Level::NextTurn and CompactState::NextTurn run them on their own tiles,
+// through a board indexed by the bits of a HexGrid, which extends the one of
+// RegionLabels with:
+//   Entity::EntityType entity(size_t bit) const;  // Unknown for none
+//   int upkeep(size_t bit) const;  // Of the entity, 0 for none
+//   int money(size_t bit) const;   // Of a townhall
+//   void set_upkeep(size_t bit, int upkeep);
+//   void set_money(size_t bit, int money);  // See Townhall::set_money
+//   void MakeBandit(size_t bit);  // Replaces the unit at bit
+//   // The moves of BanditSystem::MoveBandits, for the tiles as they are
+//   std::span<const BanditSystem::Move> MoveBandits(RandomStream& random);
+//   // Leaves the placeholder entity of an empty tile at from
+//   void MoveEntity(size_t from, size_t to);
+// The buffers are kept from one turn to the next.
+class TurnRules {
+ public:
+  // Labels the regions of the buildings at the bits buildings, then sets the
+  // upkeep of the townhalls among them
+  template <typename Board>
+  void UpdateUpkeeps(Board& board, std::span<const size_t> buildings);
+
+  // Pays the townhalls of player, in the regions labelled by the last
+  // UpdateUpkeeps
+  template <typename Board>
+  void CollectIncome(Board& board, int player);
+
+  template <typename Board>
+  void MoveBandits(Board& board, RandomStream& random);
+
+  // Regions of the buildings, as of the last UpdateUpkeeps
+  inline const RegionLabels& labels() const { return labels_; }
+
+ private:
+  RegionLabels labels_;
+  std::vector<size_t> townhalls_;
+  std::vector<int> incomes_;  // By region
+};
+
+template <typename Board>
+void TurnRules::UpdateUpkeeps(Board& board, std::span<const size_t> buildings) {
+  labels_.Label(board, buildings);
+  townhalls_.clear();
+  incomes_.assign(labels_.region_count(), 0);
+  for (size_t region = 0; region < labels_.region_count(); ++region) {
+    for (const size_t bit : labels_.tiles(static_cast<int32_t>(region))) {
+      if (board.entity(bit) != Entity::EntityType::Townhall) {
+        incomes_[region] += board.upkeep(bit);
+      }
+    }
+  }
+  for (const size_t bit : buildings) {
+    if (board.entity(bit) != Entity::EntityType::Townhall) continue;
+    townhalls_.push_back(bit);
+    const int32_t region = labels_.region(bit);
+    board.set_upkeep(bit,
+                     region != RegionLabels::kNoRegion ? incomes_[region] : 0);
+  }
+}
+
+template <typename Board>
+void TurnRules::CollectIncome(Board& board, int player) {
+  for (const size_t bit : townhalls_) {
+    if (board.owner(bit) != player) continue;
+    board.set_money(bit, board.money(bit) + board.upkeep(bit));
+    const int32_t region = labels_.region(bit);
+    if (board.money(bit) >= 0 || region == RegionLabels::kNoRegion) continue;
+    for (const size_t tile : labels_.tiles(region)) {
+      if (board.entity(tile) == Entity::EntityType::HumanUnit) {
+        board.MakeBandit(tile);
+      }
+    }
+  }
+}
+
+template <typename Board>
+void TurnRules::MoveBandits(Board& board, RandomStream& random) {
+  for (const BanditSystem::Move& move : board.MoveBandits(random)) {
+    board.MoveEntity(move.from, move.to);
+  }
+}
+
+}  // namespace konkr
+
+#endif  // KONKR_WORLD_TURN_RULES_H
@@ -0,0 +1,480 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+//
+// atlas_compiler.cc
+//
+// Build step converting the sprite atlas for the game: reads atlas.json,
+// entity_sprites.json and atlas.png, and writes
+//  - a header with the frames and the entity sprites as constexpr tables,
+//  - the atlas texture as a packed image (see rendering/packed_image.h),
+//  - one packed image per mip level, where every sprite is downscaled by two
+//    from the previous level and packed with a transparent gutter, so that
+//    zoomed out maps don't sample the full resolution texture.
+// Any error in the definitions (unknown sprite or entity type, frame outside
+// of the texture) fails the build.
+//
+// Usage: atlas_compiler <atlas.json> <entity_sprites.json> <atlas.png>
+//                       <output header> <output packed image> <mip levels>
+
+#include <SFML/Graphics/Image.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "rendering/packed_image.h"
+#include "world/entity.h"
+
+namespace {
+
+// Space around the sprites of the downscaled pages, so that linear filtering
+// doesn't sample the neighboring sprites
+constexpr int kPagePadding = 2;
+
+struct Rect {
+  int x;
+  int y;
+  int width;
+  int height;
+};
+
+struct Frame {
+  std::string name;
+  std::vector<Rect> rects;  // By mip level
+};
+
+struct Bitmap {
+  int width = 0;
+  int height = 0;
+  std::vector<uint8_t> pixels;  // RGBA, row by row
+
+  uint8_t* at(int x, int y) { return &pixels[(y * width + x) * 4]; }
+  const uint8_t* at(int x, int y) const {
+    return &pixels[(y * width + x) * 4];
+  }
+};
+
+struct Page {
+  Bitmap bitmap;
+  std::vector<Rect> rects;  // Of the sprites, in the order they were given
+};
+
+struct EntityFrames {
+  std::string type_name;
+  std::vector<size_t> frames;  // Indices in the sorted frames
+};
+
+std::optional<nlohmann::json> ReadJson(const std::filesystem::path& path) {
+  std::ifstream stream(path);
+  if (!stream.is_open()) {
+    std::cerr << "Failed to open " << path << std::endl;
+    return std::nullopt;
+  }
+  try {
+    return nlohmann::json::parse(stream);
+  } catch (nlohmann::json::parse_error& e) {
+    std::cerr << "Failed to parse " << path << ": " << e.what() << std::endl;
+    return std::nullopt;
+  }
+}
+
+// Returns the frames sorted by name, so they can be searched at compile time
+std::optional<std::vector<Frame>> ReadFrames(const nlohmann::json& atlas,
+                                             sf::Vector2u texture_size) {
+  const auto& textures = atlas.value("textures", nlohmann::json::array());
+  if (!textures.is_array() || textures.empty() ||
+      !textures[0].contains("frames") || !textures[0]["frames"].is_array()) {
+    std::cerr << "Invalid atlas: 'textures[0].frames' array is missing"
+              << std::endl;
+    return std::nullopt;
+  }
+
+  std::vector<Frame> frames;
+  for (const auto& sprite_data : textures[0]["frames"]) {
+    Frame frame;
+    Rect rect;
+    try {
+      const auto& rect_data = sprite_data.at("frame");
+      frame.name = sprite_data.at("filename").get<std::string>();
+      rect = {rect_data.at("x").get<int>(), rect_data.at("y").get<int>(),
+              rect_data.at("w").get<int>(), rect_data.at("h").get<int>()};
+    } catch (nlohmann::json::exception& e) {
+      std::cerr << "Invalid frame " << sprite_data.dump() << ": " << e.what()
+                << std::endl;
+      return std::nullopt;
+    }
+    if (rect.x < 0 || rect.y < 0 || rect.width <= 0 || rect.height <= 0 ||
+        static_cast<unsigned>(rect.x + rect.width) > texture_size.x ||
+        static_cast<unsigned>(rect.y + rect.height) > texture_size.y) {
+      std::cerr << "Frame '" << frame.name << "' is outside of the texture"
+                << std::endl;
+      return std::nullopt;
+    }
+    frame.rects.push_back(rect);
+    frames.push_back(std::move(frame));
+  }
+
+  std::sort(frames.begin(), frames.end(),
+            [](const Frame& a, const Frame& b) { return a.name < b.name; });
+  auto duplicate = std::adjacent_find(
+      frames.begin(), frames.end(),
+      [](const Frame& a, const Frame& b) { return a.name == b.name; });
+  if (duplicate != frames.end()) {
+    std::cerr << "Duplicate frame '" << duplicate->name << "'" << std::endl;
+    return std::nullopt;
+  }
+  return frames;
+}
+
+// Returns the frames of every entity type, indexed by Entity::EntityType
+std::optional<std::vector<EntityFrames>> ReadEntityFrames(
+    const nlohmann::json& mappings, const std::vector<Frame>& frames) {
+  using konkr::Entity;
+  std::vector<EntityFrames> entities(Entity::kEntityTypeCount);
+  for (size_t i = 0; i < entities.size(); ++i) {
+    entities[i].type_name =
+        Entity::entity_type_to_string(static_cast<Entity::EntityType>(i));
+  }
+
+  for (const auto& [type_name, sprite_names] : mappings.items()) {
+    auto type = Entity::string_to_entity_type(type_name);
+    if (type == Entity::EntityType::Unknown) {
+      std::cerr << "Unknown entity type '" << type_name << "'" << std::endl;
+      return std::nullopt;
+    }
+    if (!sprite_names.is_array()) {
+      std::cerr << "The sprites of '" << type_name << "' aren't an array"
+                << std::endl;
+      return std::nullopt;
+    }
+
+    auto& entity = entities[static_cast<size_t>(type)];
+    for (const auto& sprite_name : sprite_names) {
+      const std::string name =
+          sprite_name.is_string() ? sprite_name.get<std::string>() : "";
+      auto it = std::lower_bound(
+          frames.begin(), frames.end(), name,
+          [](const Frame& frame, const std::string& n) {
+            return frame.name < n;
+          });
+      if (it == frames.end() || it->name != name) {
+        std::cerr << "Sprite " << sprite_name.dump() << " of '" << type_name
+                  << "' isn't in the atlas" << std::endl;
+        return std::nullopt;
+      }
+      entity.frames.push_back(std::distance(frames.begin(), it));
+    }
+  }
+  return entities;
+}
+
+Bitmap Crop(const Bitmap& image, const Rect& rect) {
+  Bitmap bitmap{rect.width, rect.height, {}};
+  bitmap.pixels.reserve(rect.width * rect.height * 4);
+  for (int y = rect.y; y < rect.y + rect.height; ++y) {
+    const uint8_t* row = image.at(rect.x, y);
+    bitmap.pixels.insert(bitmap.pixels.end(), row, row + rect.width * 4);
+  }
+  return bitmap;
+}
+
+// Halves the size of the bitmap, rounding up. The colors are averaged
+// weighted by their alpha, so that the transparent pixels around a sprite
+// don't darken its edges.
+Bitmap Downscale(const Bitmap& bitmap) {
+  Bitmap result{(bitmap.width + 1) / 2, (bitmap.height + 1) / 2, {}};
+  result.pixels.resize(result.width * result.height * 4);
+  for (int y = 0; y < result.height; ++y) {
+    for (int x = 0; x < result.width; ++x) {
+      int color[3] = {0, 0, 0};
+      int alpha = 0;
+      for (int sy = 2 * y; sy < std::min(2 * y + 2, bitmap.height); ++sy) {
+        for (int sx = 2 * x; sx < std::min(2 * x + 2, bitmap.width); ++sx) {
+          const uint8_t* pixel = bitmap.at(sx, sy);
+          for (int c = 0; c < 3; ++c) color[c] += pixel[c] * pixel[3];
+          alpha += pixel[3];
+        }
+      }
+      // Pixels out of the bitmap count as transparent
+      uint8_t* pixel = result.at(x, y);
+      for (int c = 0; c < 3; ++c) {
+        pixel[c] = alpha ? static_cast<uint8_t>(color[c] / alpha) : 0;
+      }
+      pixel[3] = static_cast<uint8_t>((alpha + 2) / 4);
+    }
+  }
+  return result;
+}
+
+// Copies the sprite at (x, y) and extends its edge colors, fully
+// transparent, into the padding, so that filtering at the edges of the
+// sprite blends with its own colors.
+void Blit(const Bitmap& sprite, Bitmap& page, int x, int y) {
+  for (int py = y - kPagePadding; py < y + sprite.height + kPagePadding;
+       ++py) {
+    for (int px = x - kPagePadding; px < x + sprite.width + kPagePadding;
+         ++px) {
+      const int sx = std::clamp(px - x, 0, sprite.width - 1);
+      const int sy = std::clamp(py - y, 0, sprite.height - 1);
+      const bool inside = sx == px - x && sy == py - y;
+      const uint8_t* source = sprite.at(sx, sy);
+      uint8_t* pixel = page.at(px, py);
+      std::copy(source, source + 3, pixel);
+      pixel[3] = inside ? source[3] : 0;
+    }
+  }
+}
+
+// Packs the sprites in rows, the tallest first, in a roughly square page
+Page PackPage(const std::vector<Bitmap>& sprites) {
+  std::vector<size_t> order(sprites.size());
+  for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+  std::stable_sort(order.begin(), order.end(), [&sprites](size_t a, size_t b) {
+    return sprites[a].height > sprites[b].height;
+  });
+
+  double area = 0;
+  int width = 0;
+  for (const auto& sprite : sprites) {
+    area += static_cast<double>(sprite.width + 2 * kPagePadding) *
+            (sprite.height + 2 * kPagePadding);
+    width = std::max(width, sprite.width + 2 * kPagePadding);
+  }
+  // Leaves some room for the space lost at the end of the rows
+  width = std::max(width, static_cast<int>(std::ceil(std::sqrt(area * 1.1))));
+
+  Page page;
+  page.rects.resize(sprites.size());
+  int x = 0;
+  int y = 0;
+  int row_height = 0;
+  for (size_t i : order) {
+    const int cell_width = sprites[i].width + 2 * kPagePadding;
+    if (x + cell_width > width) {
+      x = 0;
+      y += row_height;
+      row_height = 0;
+    }
+    page.rects[i] = {x + kPagePadding, y + kPagePadding, sprites[i].width,
+                     sprites[i].height};
+    x += cell_width;
+    row_height = std::max(row_height, sprites[i].height + 2 * kPagePadding);
+  }
+
+  page.bitmap = {width, y + row_height, {}};
+  page.bitmap.pixels.resize(page.bitmap.width * page.bitmap.height * 4);
+  for (size_t i = 0; i < sprites.size(); ++i) {
+    Blit(sprites[i], page.bitmap, page.rects[i].x, page.rects[i].y);
+  }
+  return page;
+}
+
+// Builds the pages of the mip levels after the first, which is the atlas
+// itself, and adds the rectangles of the frames in them
+std::vector<Bitmap> BuildMipPages(const Bitmap& atlas,
+                                  std::vector<Frame>& frames, int mip_levels) {
+  std::vector<Bitmap> pages;
+  std::vector<Bitmap> sprites;
+  sprites.reserve(frames.size());
+  for (const auto& frame : frames) {
+    sprites.push_back(Crop(atlas, frame.rects[0]));
+  }
+
+  for (int level = 1; level < mip_levels; ++level) {
+    for (auto& sprite : sprites) {
+      sprite = Downscale(sprite);
+    }
+    Page page = PackPage(sprites);
+    for (size_t i = 0; i < frames.size(); ++i) {
+      frames[i].rects.push_back(page.rects[i]);
+    }
+    pages.push_back(std::move(page.bitmap));
+  }
+  return pages;
+}
+
+std::string GenerateHeader(const std::vector<Frame>& frames,
+                           const std::vector<EntityFrames>& entities,
+                           const std::vector<const Bitmap*>& pages) {
+  size_t max_levels = 1;
+  for (const auto& entity : entities) {
+    max_levels = std::max(max_levels, entity.frames.size());
+  }
+
+  std::ostringstream out;
+  out << "// Generated by tools/atlas_compiler from atlas.json and\n"
+         "// entity_sprites.json, do not edit.\n"
+         "\n"
+         "#ifndef KONKR_RENDERING_SPRITE_TABLE_H\n"
+         "#define KONKR_RENDERING_SPRITE_TABLE_H\n"
+         "\n"
+         "#include <array>\n"
+         "#include <cstddef>\n"
+         "#include <cstdint>\n"
+         "#include <string_view>\n"
+         "\n"
+         "namespace konkr::sprite_table {\n"
+         "\n"
+         "// Level 0 is the atlas, every level is half the size of the\n"
+         "// previous one\n"
+         "inline constexpr int kMipLevels = "
+      << pages.size()
+      << ";\n"
+         "\n"
+         "struct PageSize {\n"
+         "  unsigned width;\n"
+         "  unsigned height;\n"
+         "};\n"
+         "\n"
+         "inline constexpr std::array<PageSize, kMipLevels> kPageSizes = {{\n";
+  for (const Bitmap* page : pages) {
+    out << "    {" << page->width << ", " << page->height << "},\n";
+  }
+  out << "}};\n"
+         "\n"
+         "struct Rect {\n"
+         "  int x;\n"
+         "  int y;\n"
+         "  int width;\n"
+         "  int height;\n"
+         "};\n"
+         "\n"
+         "struct Frame {\n"
+         "  std::string_view name;\n"
+         "  // In the page of each mip level\n"
+         "  std::array<Rect, kMipLevels> rects;\n"
+         "};\n"
+         "\n"
+         "// Sorted by name\n"
+         "inline constexpr std::array<Frame, "
+      << frames.size() << "> kFrames = {{\n";
+  for (const auto& frame : frames) {
+    // JSON string escaping is valid in C++ string literals
+    out << "    {" << nlohmann::json(frame.name).dump() << ", {{";
+    for (size_t i = 0; i < frame.rects.size(); ++i) {
+      const Rect& rect = frame.rects[i];
+      out << (i ? ", " : "") << "{" << rect.x << ", " << rect.y << ", "
+          << rect.width << ", " << rect.height << "}";
+    }
+    out << "}}},\n";
+  }
+  out << "}};\n"
+         "\n"
+         "inline constexpr int kMaxEntityLevels = "
+      << max_levels
+      << ";\n"
+         "\n"
+         "struct EntityFrames {\n"
+         "  // Indices in kFrames, by level\n"
+         "  std::array<std::uint16_t, kMaxEntityLevels> frames;\n"
+         "  int count;\n"
+         "};\n"
+         "\n"
+         "// Indexed by Entity::EntityType\n"
+         "inline constexpr std::array<EntityFrames, "
+      << entities.size() << "> kEntityFrames = {{\n";
+  for (const auto& entity : entities) {
+    out << "    {{";
+    for (size_t i = 0; i < entity.frames.size(); ++i) {
+      out << (i ? ", " : "") << entity.frames[i];
+    }
+    out << "}, " << entity.frames.size() << "},  // " << entity.type_name
+        << "\n";
+  }
+  out << "}};\n"
+         "\n"
+         "}  // namespace konkr::sprite_table\n"
+         "\n"
+         "#endif  // KONKR_RENDERING_SPRITE_TABLE_H\n";
+  return out.str();
+}
+
+bool WriteFile(const std::filesystem::path& path, const std::string& content) {
+  std::filesystem::create_directories(path.parent_path());
+  std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+  stream << content;
+  return static_cast<bool>(stream);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  if (argc != 7) {
+    std::cerr << "Usage: " << argv[0]
+              << " <atlas.json> <entity_sprites.json> <atlas.png>"
+                 " <output header> <output packed image> <mip levels>"
+              << std::endl;
+    return 1;
+  }
+  const std::filesystem::path atlas_path = argv[1];
+  const std::filesystem::path mappings_path = argv[2];
+  const std::filesystem::path texture_path = argv[3];
+  const std::filesystem::path header_path = argv[4];
+  const std::filesystem::path packed_image_path = argv[5];
+  const int mip_levels = std::atoi(argv[6]);
+  if (mip_levels < 1) {
+    std::cerr << "Invalid number of mip levels: " << argv[6] << std::endl;
+    return 1;
+  }
+
+  sf::Image texture;
+  if (!texture.loadFromFile(texture_path)) {
+    std::cerr << "Failed to load " << texture_path << std::endl;
+    return 1;
+  }
+  const Bitmap atlas_bitmap{
+      static_cast<int>(texture.getSize().x),
+      static_cast<int>(texture.getSize().y),
+      std::vector<uint8_t>(texture.getPixelsPtr(),
+                           texture.getPixelsPtr() + texture.getSize().x *
+                                                        texture.getSize().y *
+                                                        4)};
+
+  auto atlas = ReadJson(atlas_path);
+  auto mappings = ReadJson(mappings_path);
+  if (!atlas || !mappings) return 1;
+
+  auto frames = ReadFrames(*atlas, texture.getSize());
+  if (!frames) return 1;
+  auto entities = ReadEntityFrames(*mappings, *frames);
+  if (!entities) return 1;
+
+  const std::vector<Bitmap> mip_pages =
+      BuildMipPages(atlas_bitmap, *frames, mip_levels);
+  std::vector<const Bitmap*> pages = {&atlas_bitmap};
+  for (const auto& page : mip_pages) {
+    pages.push_back(&page);
+  }
+
+  if (!WriteFile(header_path, GenerateHeader(*frames, *entities, pages))) {
+    std::cerr << "Failed to write " << header_path << std::endl;
+    return 1;
+  }
+
+  std::filesystem::create_directories(packed_image_path.parent_path());
+  for (size_t level = 0; level < pages.size(); ++level) {
+    const auto page_path = konkr::MipPagePath(packed_image_path, level);
+    if (!konkr::WritePackedImage(page_path, pages[level]->width,
+                                 pages[level]->height,
+                                 pages[level]->pixels.data())) {
+      std::cerr << "Failed to write " << page_path << std::endl;
+      return 1;
+    }
+  }
+
+  std::cout << "Compiled " << frames->size() << " sprites and "
+            << pages.size() << " mip levels into " << header_path
+            << std::endl;
+  return 0;
+}
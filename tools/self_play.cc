@@ -0,0 +1,385 @@
+// Copyright 2025 Lucian Mocan, Antoine Waehren. All rights reserved.
+// Licensed under the MIT License.
+// See LICENSE file in the project root for details.
+//
+// self_play.cc
+//
+// Batch tool playing computer-vs-computer games on every level of a levels
+// directory, to check balance changes and measure the speed of the rules
+// before a release. Every game loads its level from its file and is played
+// through Level::ApplyCommand, with one MctsPlayer per player, so it measures
+// the game's own parser and turn logic.
+//
+// The games are shared between worker threads by index: a worker plays its
+// games one after the other, each with its own Level, players and random
+// seed (the base seed plus the game index), and fills its own results. The
+// levels and the computer players are given no JobSystem, so they run their
+// turn logic and searches on the worker itself and the workers share no
+// thread pool: the times measured are those of each game alone. A game ends
+// when a single player is left, or as a draw after a number of turns.
+//
+// One line per game is written to the output file, as CSV or NDJSON: the
+// winner, the player owning the most tiles at the end, the game length, the
+// turns per second and the time spent in each phase:
+//  - load: parsing the level file and creating the tiles,
+//  - think: the computer players choosing their commands,
+//  - move: applying the moves of the units,
+//  - turn: applying the ends of turns (regions, money, active players).
+// A summary per level (win rates by player, mean length, turns per second of
+// the rules alone) is printed once every game is over.
+//
+// Usage: self_play <levels directory> <games per level> <output file>
+//                  [--format csv|ndjson] [--threads count]
+//                  [--iterations count] [--max-turns count] [--seed value]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ai/mcts_player.h"
+#include "rendering/level.h"
+#include "rendering/level_catalog.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+  std::filesystem::path levels_directory;
+  size_t games_per_level = 0;
+  std::filesystem::path output_path;
+  bool ndjson = false;
+  size_t threads = std::max(1u, std::thread::hardware_concurrency());
+  // Of each search of the computer players, which don't look at the clock so
+  // that a game only depends on its seed
+  size_t iterations = 256;
+  // Ends of turns (of any player) after which the game is a draw
+  uint32_t max_turns = 400;
+  uint64_t seed = 1;
+};
+
+struct GameResult {
+  size_t level = 0;  // Index in the catalog
+  uint64_t seed = 0;
+  bool loaded = false;
+  size_t player_count = 0;
+  int winner = -1;  // Player id, -1 for a draw
+  int leader = -1;  // Player id owning the most tiles at the end
+  uint32_t turns = 0;
+  uint32_t moves = 0;
+  Clock::duration load{0};
+  Clock::duration think{0};
+  Clock::duration move{0};
+  Clock::duration turn{0};
+  Clock::duration total{0};
+};
+
+int64_t Microseconds(Clock::duration duration) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(duration)
+      .count();
+}
+
+double Seconds(Clock::duration duration) {
+  return std::chrono::duration<double>(duration).count();
+}
+
+double PerSecond(uint64_t count, Clock::duration duration) {
+  return duration.count() > 0 ? count / Seconds(duration) : 0;
+}
+
+std::optional<uint64_t> ParseNumber(const std::string& text) {
+  char* end = nullptr;
+  const uint64_t value = std::strtoull(text.c_str(), &end, 10);
+  if (text.empty() || *end != '\0') return std::nullopt;
+  return value;
+}
+
+std::optional<Options> ParseOptions(int argc, char* argv[]) {
+  if (argc < 4 || argc % 2 != 0) return std::nullopt;
+  Options options;
+  options.levels_directory = argv[1];
+  options.output_path = argv[3];
+  const auto games = ParseNumber(argv[2]);
+  if (!games || *games == 0) return std::nullopt;
+  options.games_per_level = *games;
+
+  for (int i = 4; i < argc; i += 2) {
+    const std::string name = argv[i];
+    const std::string value = argv[i + 1];
+    if (name == "--format") {
+      if (value != "csv" && value != "ndjson") return std::nullopt;
+      options.ndjson = value == "ndjson";
+      continue;
+    }
+    const auto number = ParseNumber(value);
+    if (!number) return std::nullopt;
+    if (name == "--threads" && *number > 0) {
+      options.threads = *number;
+    } else if (name == "--iterations" && *number > 0) {
+      options.iterations = *number;
+    } else if (name == "--max-turns" && *number > 0) {
+      options.max_turns = static_cast<uint32_t>(*number);
+    } else if (name == "--seed") {
+      options.seed = *number;
+    } else {
+      return std::nullopt;
+    }
+  }
+  return options;
+}
+
+// Player owning the most tiles, the lowest id on ties
+int FindLeader(const konkr::Level& level) {
+  std::map<int, size_t> tile_counts;
+  for (const auto& row : level.tiles()) {
+    for (const auto& tile : row) {
+      if (!tile) continue;
+      const auto owner = tile->get_owner();
+      if (owner && level.active_players().contains(*owner)) {
+        ++tile_counts[*owner];
+      }
+    }
+  }
+  int leader = -1;
+  size_t most = 0;
+  for (const auto& [id, count] : tile_counts) {
+    if (count > most) {
+      most = count;
+      leader = id;
+    }
+  }
+  return leader;
+}
+
+GameResult PlayGame(const konkr::LevelInfo& info, size_t level_index,
+                    uint64_t seed, const Options& options) {
+  GameResult result;
+  result.level = level_index;
+  result.seed = seed;
+  const auto start = Clock::now();
+
+  std::shared_ptr<konkr::Level> level = konkr::LevelCatalog::CreateLevel(info);
+  level->set_seed(seed);
+  level->set_job_system(nullptr);
+  result.loaded = level->Load();
+  result.load = Clock::now() - start;
+  if (!result.loaded) return result;
+  result.player_count = level->active_players_count();
+
+  // One search tree each, on this thread: the games already use every core
+  std::map<int, konkr::MctsPlayer> players;
+  for (const auto& [id, player] : level->active_players()) {
+    players.try_emplace(id,
+                        konkr::MctsPlayer::Options{
+                            .time_budget = std::chrono::hours(1),
+                            .turn_time_budget = std::chrono::hours(1),
+                            .max_iterations = options.iterations,
+                            .trees = 1,
+                            .seed = seed * 31 + id,
+                        },
+                        nullptr);
+  }
+
+  while (level->active_players_count() > 1 &&
+         result.turns < options.max_turns) {
+    const int id = level->get_current_player()->id();
+    auto phase_start = Clock::now();
+    konkr::GameCommand command = players.at(id).ChooseCommand(*level);
+    auto phase_end = Clock::now();
+    result.think += phase_end - phase_start;
+
+    if (command.type == konkr::GameCommand::Type::MoveUnit &&
+        !level->CanMoveUnit(command.tile, command.target)) {
+      std::cerr << "Invalid move chosen on " << info.name << " with seed "
+                << seed << ", ending the turn" << std::endl;
+      command = {konkr::GameCommand::Type::NextTurn};
+    }
+    phase_start = Clock::now();
+    level->ApplyCommand(command);
+    phase_end = Clock::now();
+    if (command.type == konkr::GameCommand::Type::NextTurn) {
+      result.turn += phase_end - phase_start;
+      ++result.turns;
+    } else {
+      result.move += phase_end - phase_start;
+      ++result.moves;
+    }
+  }
+
+  if (level->active_players_count() == 1) {
+    result.winner = level->active_players().begin()->first;
+  }
+  result.leader = FindLeader(*level);
+  result.total = Clock::now() - start;
+  return result;
+}
+
+void WriteCsvHeader(std::ostream& stream) {
+  stream << "level,game,seed,players,winner,leader,turns,moves,"
+            "turns_per_second,load_us,think_us,move_us,turn_us,total_us\n";
+}
+
+// Level names come from file names, which may hold commas or quotes
+std::string CsvQuote(const std::string& text) {
+  std::string quoted = "\"";
+  for (char c : text) {
+    if (c == '"') quoted += '"';
+    quoted += c;
+  }
+  return quoted + "\"";
+}
+
+void WriteResult(std::ostream& stream, const std::string& level_name,
+                 size_t game, const GameResult& result, bool ndjson) {
+  const double turns_per_second = PerSecond(result.turns, result.total);
+  if (ndjson) {
+    stream << nlohmann::ordered_json{
+                  {"level", level_name},
+                  {"game", game},
+                  {"seed", result.seed},
+                  {"players", result.player_count},
+                  {"winner", result.winner},
+                  {"leader", result.leader},
+                  {"turns", result.turns},
+                  {"moves", result.moves},
+                  {"turns_per_second", turns_per_second},
+                  {"load_us", Microseconds(result.load)},
+                  {"think_us", Microseconds(result.think)},
+                  {"move_us", Microseconds(result.move)},
+                  {"turn_us", Microseconds(result.turn)},
+                  {"total_us", Microseconds(result.total)},
+              }.dump()
+           << '\n';
+    return;
+  }
+  stream << CsvQuote(level_name) << ',' << game << ',' << result.seed << ','
+         << result.player_count << ',' << result.winner << ','
+         << result.leader << ',' << result.turns << ',' << result.moves << ','
+         << turns_per_second << ',' << Microseconds(result.load) << ','
+         << Microseconds(result.think) << ',' << Microseconds(result.move)
+         << ',' << Microseconds(result.turn) << ','
+         << Microseconds(result.total) << '\n';
+}
+
+void PrintSummary(const std::vector<konkr::LevelInfo>& levels,
+                  const std::vector<GameResult>& results,
+                  Clock::duration elapsed) {
+  uint64_t all_turns = 0;
+  for (size_t level = 0; level < levels.size(); ++level) {
+    size_t games = 0, draws = 0;
+    uint64_t turns = 0, moves = 0;
+    Clock::duration rules{0}, think{0};
+    std::map<int, size_t> wins;
+    for (const GameResult& result : results) {
+      if (result.level != level || !result.loaded) continue;
+      ++games;
+      turns += result.turns;
+      moves += result.moves;
+      rules += result.move + result.turn;
+      think += result.think;
+      if (result.winner < 0) {
+        ++draws;
+      } else {
+        ++wins[result.winner];
+      }
+    }
+    all_turns += turns;
+    std::cout << levels[level].name << ": " << games << " games";
+    if (games == 0) {
+      std::cout << std::endl;
+      continue;
+    }
+    for (const auto& [id, count] : wins) {
+      std::cout << ", player " << id << " won " << 100.0 * count / games
+                << "%";
+    }
+    std::cout << ", draws " << 100.0 * draws / games << "%"
+              << ", " << static_cast<double>(turns) / games << " turns and "
+              << static_cast<double>(moves) / games << " moves per game, "
+              << PerSecond(turns, rules) << " turns/s (rules alone), "
+              << Seconds(think) / games << " s of search per game"
+              << std::endl;
+  }
+  std::cout << results.size() << " games in " << Seconds(elapsed) << " s, "
+            << PerSecond(all_turns, elapsed) << " turns/s" << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  const auto options = ParseOptions(argc, argv);
+  if (!options) {
+    std::cerr << "Usage: " << argv[0]
+              << " <levels directory> <games per level> <output file>"
+                 " [--format csv|ndjson] [--threads count]"
+                 " [--iterations count] [--max-turns count] [--seed value]"
+              << std::endl;
+    return 1;
+  }
+
+  // The manifest is only used by this run
+  const std::filesystem::path manifest_path =
+      std::filesystem::temp_directory_path() / "konkr_self_play.manifest";
+  konkr::LevelCatalog catalog(options->levels_directory, manifest_path);
+  if (!catalog.Refresh(true) || catalog.levels().empty()) {
+    std::cerr << "No level found in " << options->levels_directory
+              << std::endl;
+    return 1;
+  }
+  const std::vector<konkr::LevelInfo>& levels = catalog.levels();
+
+  std::ofstream output(options->output_path);
+  if (!output.is_open()) {
+    std::cerr << "Failed to open " << options->output_path << std::endl;
+    return 1;
+  }
+
+  const size_t game_count = levels.size() * options->games_per_level;
+  std::vector<GameResult> results(game_count);
+  const size_t thread_count = std::min(options->threads, game_count);
+  const auto start = Clock::now();
+  {
+    std::vector<std::jthread> workers;
+    for (size_t worker = 0; worker < thread_count; ++worker) {
+      workers.emplace_back([&, worker] {
+        for (size_t game = worker; game < game_count; game += thread_count) {
+          const size_t level = game % levels.size();
+          results[game] =
+              PlayGame(levels[level], level, options->seed + game, *options);
+        }
+      });
+    }
+  }
+  const auto elapsed = Clock::now() - start;
+
+  if (!options->ndjson) WriteCsvHeader(output);
+  bool failed = false;
+  for (size_t game = 0; game < game_count; ++game) {
+    const GameResult& result = results[game];
+    if (!result.loaded) {
+      failed = true;
+      continue;
+    }
+    WriteResult(output, levels[result.level].name, game, result,
+                options->ndjson);
+  }
+  output.close();
+  if (!output) {
+    std::cerr << "Failed to write " << options->output_path << std::endl;
+    return 1;
+  }
+
+  PrintSummary(levels, results, elapsed);
+  return failed ? 1 : 0;
+}